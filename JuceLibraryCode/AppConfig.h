@@ -54,6 +54,10 @@
  //#define JUCE_ALSA
 #endif
 
+#ifndef    JUCE_ALSA_MMAP
+ //#define JUCE_ALSA_MMAP
+#endif
+
 #ifndef    JUCE_JACK
  //#define JUCE_JACK
 #endif
@@ -192,13 +196,13 @@
  #define JucePlugin_PluginCode             'BiDe'
 #endif
 #ifndef  JucePlugin_MaxNumInputChannels
- #define JucePlugin_MaxNumInputChannels    2
+ #define JucePlugin_MaxNumInputChannels    64
 #endif
 #ifndef  JucePlugin_MaxNumOutputChannels
- #define JucePlugin_MaxNumOutputChannels   2
+ #define JucePlugin_MaxNumOutputChannels   64
 #endif
 #ifndef  JucePlugin_PreferredChannelConfigurations
- #define JucePlugin_PreferredChannelConfigurations  {1, 1}, {2, 2}
+ #define JucePlugin_PreferredChannelConfigurations  {1, 1}, {2, 2}, {4, 4}, {6, 6}, {8, 8}, {16, 16}, {32, 32}, {64, 64}
 #endif
 #ifndef  JucePlugin_IsSynth
  #define JucePlugin_IsSynth                0
@@ -472,6 +472,530 @@ void AudioDataConverters::deinterleaveSamples (const float* const source,
 }
 
 
+//==============================================================================
+AudioDataConverters::Dither::Dither (const uint32 seed) noexcept
+{
+    reset (seed);
+}
+
+void AudioDataConverters::Dither::reset (uint32 seed) noexcept
+{
+    for (int i = 0; i < numElementsInArray (state); ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        state[i] = (seed != 0) ? seed : 1; // (a xorshift generator gets stuck on zero)
+    }
+}
+
+namespace BulkConverterHelpers
+{
+    /*  The bulk converters work through the frames in blocks of four, converting each
+        channel's four samples in turn. The dither has one xorshift generator per frame
+        in the block, so the vector and scalar paths produce exactly the same noise.
+    */
+    inline uint32 nextRandom (uint32& state) noexcept
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    inline float getTriangularDither (uint32& state) noexcept
+    {
+        const float a = (float) (int) (nextRandom (state) >> 8);
+        const float b = (float) (int) (nextRandom (state) >> 8);
+        return (a - b) * (1.0f / 16777216.0f);
+    }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    static forcedinline __m128i nextRandom (__m128i state) noexcept
+    {
+        state = _mm_xor_si128 (state, _mm_slli_epi32 (state, 13));
+        state = _mm_xor_si128 (state, _mm_srli_epi32 (state, 17));
+        return  _mm_xor_si128 (state, _mm_slli_epi32 (state, 5));
+    }
+
+    static forcedinline __m128 getTriangularDither (uint32* const state) noexcept
+    {
+        const __m128i a = nextRandom (_mm_loadu_si128 ((const __m128i*) state));
+        const __m128i b = nextRandom (a);
+        _mm_storeu_si128 ((__m128i*) state, b);
+
+        return _mm_mul_ps (_mm_sub_ps (_mm_cvtepi32_ps (_mm_srli_epi32 (a, 8)),
+                                       _mm_cvtepi32_ps (_mm_srli_epi32 (b, 8))),
+                           _mm_set1_ps (1.0f / 16777216.0f));
+    }
+
+    static forcedinline __m128i byteSwap16 (const __m128i v) noexcept
+    {
+        return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+    }
+
+    static forcedinline __m128i byteSwap32 (const __m128i v) noexcept
+    {
+        return _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (byteSwap16 (v), _MM_SHUFFLE (2, 3, 0, 1)), _MM_SHUFFLE (2, 3, 0, 1));
+    }
+
+    static forcedinline void transpose4 (__m128i& a, __m128i& b, __m128i& c, __m128i& d) noexcept
+    {
+        const __m128i ab0 = _mm_unpacklo_epi32 (a, b), ab1 = _mm_unpackhi_epi32 (a, b);
+        const __m128i cd0 = _mm_unpacklo_epi32 (c, d), cd1 = _mm_unpackhi_epi32 (c, d);
+
+        a = _mm_unpacklo_epi64 (ab0, cd0);
+        b = _mm_unpackhi_epi64 (ab0, cd0);
+        c = _mm_unpacklo_epi64 (ab1, cd1);
+        d = _mm_unpackhi_epi64 (ab1, cd1);
+    }
+   #endif
+
+    //==============================================================================
+    // Reads and writes single samples. Float formats are handled as their bit patterns.
+    template <int bits, bool floatingPoint, bool bigEndian>
+    struct Format
+    {
+        enum { bitDepth = bits, bytesPerSample = bits / 8, isFloat = floatingPoint, isBigEndian = bigEndian };
+
+        /*  The scaling matches AudioData::Pointer's. Samples are read as value / 2^(bits-1).
+            They're written the way AudioData converts them, via a 32-bit integer: scaled to
+            +/-(2^31 - 1) and rounded, then shifted down by getWriteShift() bits.
+        */
+        static double getReadScale() noexcept
+        {
+            return bits == 16 ? 32768.0 : (bits == 24 ? 8388608.0 : 2147483648.0);
+        }
+
+        static int getWriteShift() noexcept     { return 32 - bits; }
+
+        static void write (char* const dest, const int32 value) noexcept
+        {
+            if (bits == 16)
+                *(uint16*) dest = bigEndian ? ByteOrder::swapIfLittleEndian ((uint16) value)
+                                            : ByteOrder::swapIfBigEndian ((uint16) value);
+            else if (bits == 24)
+                bigEndian ? ByteOrder::bigEndian24BitToChars (value, dest)
+                          : ByteOrder::littleEndian24BitToChars (value, dest);
+            else
+                *(uint32*) dest = bigEndian ? ByteOrder::swapIfLittleEndian ((uint32) value)
+                                            : ByteOrder::swapIfBigEndian ((uint32) value);
+        }
+
+        static int32 read (const char* const source) noexcept
+        {
+            if (bits == 16)
+                return (int16) (bigEndian ? ByteOrder::bigEndianShort (source) : ByteOrder::littleEndianShort (source));
+
+            if (bits == 24)
+                return bigEndian ? ByteOrder::bigEndian24Bit (source) : ByteOrder::littleEndian24Bit (source);
+
+            return (int32) (bigEndian ? ByteOrder::bigEndianInt (source) : ByteOrder::littleEndianInt (source));
+        }
+
+       #if JUCE_USE_SSE_INTRINSICS
+        // These take a whole number of frames' worth of vectors, holding the samples in interleaved order
+        static forcedinline void store (char* const dest, const __m128i* const v, const int numVectors) noexcept
+        {
+            if (bits == 16)
+            {
+                for (int i = 0; i < numVectors; i += 2)
+                {
+                    const __m128i s = _mm_packs_epi32 (v[i], v[i + 1]);
+                    _mm_storeu_si128 ((__m128i*) (dest + i * 8), bigEndian ? byteSwap16 (s) : s);
+                }
+            }
+            else if (bits == 24)
+            {
+                int32 samples[4];
+
+                for (int i = 0; i < numVectors; ++i)
+                {
+                    _mm_storeu_si128 ((__m128i*) samples, v[i]);
+
+                    for (int j = 0; j < 4; ++j)
+                        write (dest + (i * 4 + j) * 3, samples[j]);
+                }
+            }
+            else
+            {
+                for (int i = 0; i < numVectors; ++i)
+                    _mm_storeu_si128 ((__m128i*) (dest + i * 16), bigEndian ? byteSwap32 (v[i]) : v[i]);
+            }
+        }
+
+        static forcedinline void load (const char* const source, __m128i* const v, const int numVectors) noexcept
+        {
+            if (bits == 16)
+            {
+                for (int i = 0; i < numVectors; i += 2)
+                {
+                    __m128i s = _mm_loadu_si128 ((const __m128i*) (source + i * 8));
+
+                    if (bigEndian)
+                        s = byteSwap16 (s);
+
+                    v[i]     = _mm_srai_epi32 (_mm_unpacklo_epi16 (s, s), 16);
+                    v[i + 1] = _mm_srai_epi32 (_mm_unpackhi_epi16 (s, s), 16);
+                }
+            }
+            else if (bits == 24)
+            {
+                int32 samples[4];
+
+                for (int i = 0; i < numVectors; ++i)
+                {
+                    for (int j = 0; j < 4; ++j)
+                        samples[j] = read (source + (i * 4 + j) * 3);
+
+                    v[i] = _mm_loadu_si128 ((const __m128i*) samples);
+                }
+            }
+            else
+            {
+                for (int i = 0; i < numVectors; ++i)
+                {
+                    const __m128i s = _mm_loadu_si128 ((const __m128i*) (source + i * 16));
+                    v[i] = bigEndian ? byteSwap32 (s) : s;
+                }
+            }
+        }
+       #endif
+    };
+
+    //==============================================================================
+    // The sample conversions, shared by the scalar and vector paths
+    struct FloatToInt
+    {
+        FloatToInt (const int shift_, uint32* const ditherState_) noexcept
+            : shift (shift_), ditherScale ((double) (1 << shift_)), ditherState (ditherState_)
+        {}
+
+        int32 convert (const float sample, const int frameInBlock) const noexcept
+        {
+            double v = fullScale * sample;
+
+            if (ditherState != nullptr)
+                v += ditherScale * getTriangularDither (ditherState [frameInBlock]);
+
+            return roundToInt (jlimit (-fullScale, fullScale, v)) >> shift;
+        }
+
+       #if JUCE_USE_SSE_INTRINSICS
+        forcedinline __m128i convert (const float* const source) const noexcept
+        {
+            const __m128d scale = _mm_set1_pd (fullScale), upper = scale, lower = _mm_set1_pd (-fullScale);
+            const __m128 s = _mm_loadu_ps (source);
+
+            __m128d lo = _mm_mul_pd (scale, _mm_cvtps_pd (s));
+            __m128d hi = _mm_mul_pd (scale, _mm_cvtps_pd (_mm_movehl_ps (s, s)));
+
+            if (ditherState != nullptr)
+            {
+                const __m128d dScale = _mm_set1_pd (ditherScale);
+                const __m128 d = getTriangularDither (ditherState);
+                lo = _mm_add_pd (lo, _mm_mul_pd (dScale, _mm_cvtps_pd (d)));
+                hi = _mm_add_pd (hi, _mm_mul_pd (dScale, _mm_cvtps_pd (_mm_movehl_ps (d, d))));
+            }
+
+            lo = _mm_min_pd (_mm_max_pd (lo, lower), upper);
+            hi = _mm_min_pd (_mm_max_pd (hi, lower), upper);
+
+            return _mm_sra_epi32 (_mm_unpacklo_epi64 (_mm_cvtpd_epi32 (lo), _mm_cvtpd_epi32 (hi)),
+                                  _mm_cvtsi32_si128 (shift));
+        }
+       #endif
+
+        static const double fullScale;
+        const int shift;
+        const double ditherScale;
+        uint32* const ditherState;
+    };
+
+    const double FloatToInt::fullScale = (double) 0x7fffffff;
+
+    struct FloatToFloat
+    {
+        FloatToFloat (const bool clip_) noexcept  : clip (clip_) {}
+
+        int32 convert (float sample, int) const noexcept
+        {
+            if (clip)
+                sample = jlimit (-1.0f, 1.0f, sample);
+
+            union { float asFloat; int32 asInt; } n;
+            n.asFloat = sample;
+            return n.asInt;
+        }
+
+       #if JUCE_USE_SSE_INTRINSICS
+        forcedinline __m128i convert (const float* const source) const noexcept
+        {
+            __m128 s = _mm_loadu_ps (source);
+
+            if (clip)
+                s = _mm_min_ps (_mm_max_ps (s, _mm_set1_ps (-1.0f)), _mm_set1_ps (1.0f));
+
+            return _mm_castps_si128 (s);
+        }
+       #endif
+
+        const bool clip;
+    };
+
+    struct IntToFloat
+    {
+        IntToFloat (const double readScale) noexcept  : scale (1.0f / (float) readScale) {}
+
+        float convert (const int32 sample) const noexcept       { return scale * (float) sample; }
+
+       #if JUCE_USE_SSE_INTRINSICS
+        forcedinline __m128 convert (const __m128i v) const noexcept  { return _mm_mul_ps (_mm_set1_ps (scale), _mm_cvtepi32_ps (v)); }
+       #endif
+
+        const float scale;
+    };
+
+    struct FloatToFloatBits
+    {
+        float convert (const int32 sample) const noexcept
+        {
+            union { int32 asInt; float asFloat; } n;
+            n.asInt = sample;
+            return n.asFloat;
+        }
+
+       #if JUCE_USE_SSE_INTRINSICS
+        forcedinline __m128 convert (const __m128i v) const noexcept  { return _mm_castsi128_ps (v); }
+       #endif
+    };
+
+    //==============================================================================
+    template <class FormatType, class Conversion>
+    void toInterleaved (const Conversion& conversion, const float* const* const source, const int numChannels,
+                                    char* const dest, const int numSamples) noexcept
+    {
+        const int frameSize = numChannels * FormatType::bytesPerSample;
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (FloatVectorOperations::getInstructionSet() != FloatVectorOperations::scalarInstructions)
+        {
+            const int numVectorFrames = numSamples & ~3;
+            __m128i v[8];
+
+            for (; i < numVectorFrames; i += 4)
+            {
+                char* const d = dest + i * frameSize;
+
+                switch (numChannels)
+                {
+                    case 2:
+                    {
+                        const __m128i a = conversion.convert (source[0] + i);
+                        const __m128i b = conversion.convert (source[1] + i);
+                        v[0] = _mm_unpacklo_epi32 (a, b);
+                        v[1] = _mm_unpackhi_epi32 (a, b);
+                        FormatType::store (d, v, 2);
+                        break;
+                    }
+
+                    case 4:
+                    {
+                        for (int chan = 0; chan < 4; ++chan)
+                            v[chan] = conversion.convert (source[chan] + i);
+
+                        transpose4 (v[0], v[1], v[2], v[3]);
+                        FormatType::store (d, v, 4);
+                        break;
+                    }
+
+                    case 8:
+                    {
+                        __m128i a[4], b[4];
+
+                        for (int chan = 0; chan < 4; ++chan)
+                            a[chan] = conversion.convert (source[chan] + i);
+
+                        for (int chan = 0; chan < 4; ++chan)
+                            b[chan] = conversion.convert (source[chan + 4] + i);
+
+                        transpose4 (a[0], a[1], a[2], a[3]);
+                        transpose4 (b[0], b[1], b[2], b[3]);
+
+                        for (int frame = 0; frame < 4; ++frame)
+                        {
+                            v[frame * 2]     = a[frame];
+                            v[frame * 2 + 1] = b[frame];
+                        }
+
+                        FormatType::store (d, v, 8);
+                        break;
+                    }
+
+                    default:
+                    {
+                        int32 samples[4];
+
+                        for (int chan = 0; chan < numChannels; ++chan)
+                        {
+                            _mm_storeu_si128 ((__m128i*) samples, conversion.convert (source[chan] + i));
+
+                            for (int frame = 0; frame < 4; ++frame)
+                                FormatType::write (d + frame * frameSize + chan * FormatType::bytesPerSample, samples[frame]);
+                        }
+
+                        break;
+                    }
+                }
+            }
+        }
+       #endif
+
+        for (; i < numSamples; i += 4)
+        {
+            const int numFrames = jmin (4, numSamples - i);
+
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                char* d = dest + i * frameSize + chan * FormatType::bytesPerSample;
+
+                for (int frame = 0; frame < numFrames; ++frame)
+                {
+                    FormatType::write (d, conversion.convert (source[chan][i + frame], frame));
+                    d += frameSize;
+                }
+            }
+        }
+    }
+
+    template <class FormatType, class Conversion>
+    void fromInterleaved (const Conversion& conversion, const char* const source, const int numChannels,
+                                    float* const* const dest, const int numSamples) noexcept
+    {
+        const int frameSize = numChannels * FormatType::bytesPerSample;
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (FloatVectorOperations::getInstructionSet() != FloatVectorOperations::scalarInstructions
+             && (numChannels == 2 || numChannels == 4 || numChannels == 8))
+        {
+            const int numVectorFrames = numSamples & ~3;
+            __m128i v[8];
+
+            for (; i < numVectorFrames; i += 4)
+            {
+                FormatType::load (source + i * frameSize, v, numChannels);
+
+                if (numChannels == 2)
+                {
+                    const __m128i a = _mm_shuffle_epi32 (v[0], _MM_SHUFFLE (3, 1, 2, 0));
+                    const __m128i b = _mm_shuffle_epi32 (v[1], _MM_SHUFFLE (3, 1, 2, 0));
+                    v[0] = _mm_unpacklo_epi64 (a, b);
+                    v[1] = _mm_unpackhi_epi64 (a, b);
+                }
+                else if (numChannels == 4)
+                {
+                    transpose4 (v[0], v[1], v[2], v[3]);
+                }
+                else
+                {
+                    __m128i a[4] = { v[0], v[2], v[4], v[6] };
+                    __m128i b[4] = { v[1], v[3], v[5], v[7] };
+                    transpose4 (a[0], a[1], a[2], a[3]);
+                    transpose4 (b[0], b[1], b[2], b[3]);
+
+                    for (int chan = 0; chan < 4; ++chan)
+                    {
+                        v[chan]     = a[chan];
+                        v[chan + 4] = b[chan];
+                    }
+                }
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                    _mm_storeu_ps (dest[chan] + i, conversion.convert (v[chan]));
+            }
+        }
+       #endif
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            const char* s = source + i * frameSize + chan * FormatType::bytesPerSample;
+            float* const d = dest[chan];
+
+            for (int j = i; j < numSamples; ++j)
+            {
+                d[j] = conversion.convert (FormatType::read (s));
+                s += frameSize;
+            }
+        }
+    }
+
+    //==============================================================================
+    template <class FormatType>
+    void toInterleaved (const float* const* const source, const int numChannels, char* const dest,
+                                    const int numSamples, uint32* const ditherState, const bool clipFloats) noexcept
+    {
+        if (FormatType::isFloat)
+            toInterleaved<FormatType> (FloatToFloat (clipFloats), source, numChannels, dest, numSamples);
+        else
+            toInterleaved<FormatType> (FloatToInt (FormatType::getWriteShift(), ditherState), source, numChannels, dest, numSamples);
+    }
+
+    template <class FormatType>
+    void fromInterleaved (const char* const source, const int numChannels,
+                                    float* const* const dest, const int numSamples) noexcept
+    {
+        if (FormatType::isFloat)
+            fromInterleaved<FormatType> (FloatToFloatBits(), source, numChannels, dest, numSamples);
+        else
+            fromInterleaved<FormatType> (IntToFloat (FormatType::getReadScale()), source, numChannels, dest, numSamples);
+    }
+}
+
+void AudioDataConverters::convertFloatToInterleaved (const DataFormat destFormat,
+                                                     const float* const* const source, const int numChannels,
+                                                     void* const dest, const int numSamples,
+                                                     Dither* const dither, const bool clipFloats)
+{
+    using namespace BulkConverterHelpers;
+    char* const d = static_cast <char*> (dest);
+    uint32* const ditherState = dither != nullptr ? dither->state : nullptr;
+
+    switch (destFormat)
+    {
+        case int16LE:       toInterleaved <Format <16, false, false> > (source, numChannels, d, numSamples, ditherState, clipFloats); break;
+        case int16BE:       toInterleaved <Format <16, false, true> >  (source, numChannels, d, numSamples, ditherState, clipFloats); break;
+        case int24LE:       toInterleaved <Format <24, false, false> > (source, numChannels, d, numSamples, ditherState, clipFloats); break;
+        case int24BE:       toInterleaved <Format <24, false, true> >  (source, numChannels, d, numSamples, ditherState, clipFloats); break;
+        case int32LE:       toInterleaved <Format <32, false, false> > (source, numChannels, d, numSamples, ditherState, clipFloats); break;
+        case int32BE:       toInterleaved <Format <32, false, true> >  (source, numChannels, d, numSamples, ditherState, clipFloats); break;
+        case float32LE:     toInterleaved <Format <32, true, false> >  (source, numChannels, d, numSamples, ditherState, clipFloats); break;
+        case float32BE:     toInterleaved <Format <32, true, true> >   (source, numChannels, d, numSamples, ditherState, clipFloats); break;
+        default:            jassertfalse; break;
+    }
+}
+
+void AudioDataConverters::convertInterleavedToFloat (const DataFormat sourceFormat,
+                                                     const void* const source, const int numChannels,
+                                                     float* const* const dest, const int numSamples)
+{
+    using namespace BulkConverterHelpers;
+    const char* const s = static_cast <const char*> (source);
+
+    switch (sourceFormat)
+    {
+        case int16LE:       fromInterleaved <Format <16, false, false> > (s, numChannels, dest, numSamples); break;
+        case int16BE:       fromInterleaved <Format <16, false, true> >  (s, numChannels, dest, numSamples); break;
+        case int24LE:       fromInterleaved <Format <24, false, false> > (s, numChannels, dest, numSamples); break;
+        case int24BE:       fromInterleaved <Format <24, false, true> >  (s, numChannels, dest, numSamples); break;
+        case int32LE:       fromInterleaved <Format <32, false, false> > (s, numChannels, dest, numSamples); break;
+        case int32BE:       fromInterleaved <Format <32, false, true> >  (s, numChannels, dest, numSamples); break;
+        case float32LE:     fromInterleaved <Format <32, true, false> >  (s, numChannels, dest, numSamples); break;
+        case float32BE:     fromInterleaved <Format <32, true, true> >   (s, numChannels, dest, numSamples); break;
+        default:            jassertfalse; break;
+    }
+}
+
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
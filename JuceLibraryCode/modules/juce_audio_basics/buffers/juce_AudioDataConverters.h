@@ -683,6 +683,54 @@ public:
     static void deinterleaveSamples (const float* source, float** dest,
                                      int numSamples, int numChannels);
 
+    //==============================================================================
+    /** The state of the triangular (TPDF) dither that convertFloatToInterleaved() can add.
+
+        Keep one of these for each stream that you're converting, so that the noise
+        carries on seamlessly from one block to the next.
+    */
+    class JUCE_API  Dither
+    {
+    public:
+        explicit Dither (uint32 seed = 1) noexcept;
+
+        /** Restarts the noise sequence from a seed. */
+        void reset (uint32 seed) noexcept;
+
+    private:
+        friend class AudioDataConverters;
+        uint32 state[4];
+    };
+
+    /** Converts a set of float channels into interleaved frames of the given format,
+        in a single pass.
+
+        Integer formats are scaled exactly as AudioData::Pointer scales them, rather than
+        like the per-format functions above, and are always clipped to their range. If
+        clipFloats is true, float formats are clipped to -1..1 too; otherwise float samples
+        are copied untouched.
+
+        If dither isn't null, +/-1 LSB of triangular dither is added before the samples
+        are rounded to an integer format. It has no effect on float formats.
+
+        2, 4 and 8 channels have vectorised interleaving, and any other number of channels
+        is converted a channel at a time. The results are the same with or without SSE.
+    */
+    static void convertFloatToInterleaved (DataFormat destFormat,
+                                           const float* const* source, int numChannels,
+                                           void* dest, int numSamples,
+                                           Dither* dither = nullptr, bool clipFloats = false);
+
+    /** Converts interleaved frames of the given format into a set of float channels,
+        in a single pass.
+
+        Integers are scaled as in convertFloatToInterleaved(), and as there, 2, 4 and 8
+        channels have vectorised deinterleaving.
+    */
+    static void convertInterleavedToFloat (DataFormat sourceFormat,
+                                           const void* source, int numChannels,
+                                           float* const* dest, int numSamples);
+
 private:
     AudioDataConverters();
     JUCE_DECLARE_NON_COPYABLE (AudioDataConverters)
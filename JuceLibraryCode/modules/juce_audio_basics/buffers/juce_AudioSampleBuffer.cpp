@@ -23,6 +23,33 @@
   ==============================================================================
 */
 
+namespace AudioSampleBufferHelpers
+{
+    // Channel data starts on a cache line, and each channel's padded out to whole lines.
+    const size_t channelAlignment = 64;
+
+    // The widest aligned loads that FloatVectorOperations uses (AVX).
+    const size_t simdAlignment = 32;
+
+    inline size_t getChannelStride (const int numSamples) noexcept
+    {
+        const size_t floatsPerLine = channelAlignment / sizeof (float);
+        return ((size_t) numSamples + floatsPerLine - 1) & ~(floatsPerLine - 1);
+    }
+
+    inline size_t getTotalBytes (const int numChannels, const size_t channelStride, const size_t channelListSize) noexcept
+    {
+        // (the extra line leaves room to align the first channel)
+        return (size_t) numChannels * channelStride * sizeof (float) + channelListSize + channelAlignment;
+    }
+
+    inline float* getFirstChannel (char* const data, const size_t channelListSize) noexcept
+    {
+        const pointer_sized_int mask = (pointer_sized_int) channelAlignment - 1;
+        return reinterpret_cast <float*> ((((pointer_sized_int) (data + channelListSize)) + mask) & ~mask);
+    }
+}
+
 AudioSampleBuffer::AudioSampleBuffer (const int numChannels_,
                                       const int numSamples) noexcept
   : numChannels (numChannels_),
@@ -46,16 +73,17 @@ AudioSampleBuffer::AudioSampleBuffer (const AudioSampleBuffer& other) noexcept
 
 void AudioSampleBuffer::allocateData()
 {
+    const size_t channelStride = AudioSampleBufferHelpers::getChannelStride (size);
     const size_t channelListSize = sizeof (float*) * (size_t) (numChannels + 1);
-    allocatedBytes = (size_t) numChannels * (size_t) size * sizeof (float) + channelListSize + 32;
+    allocatedBytes = AudioSampleBufferHelpers::getTotalBytes (numChannels, channelStride, channelListSize);
     allocatedData.malloc (allocatedBytes);
     channels = reinterpret_cast <float**> (allocatedData.getData());
 
-    float* chan = (float*) (allocatedData + channelListSize);
+    float* chan = AudioSampleBufferHelpers::getFirstChannel (allocatedData, channelListSize);
     for (int i = 0; i < numChannels; ++i)
     {
         channels[i] = chan;
-        chan += size;
+        chan += channelStride;
     }
 
     channels [numChannels] = nullptr;
@@ -151,10 +179,10 @@ void AudioSampleBuffer::setSize (const int newNumChannels,
 
     if (newNumSamples != size || newNumChannels != numChannels)
     {
-        const size_t allocatedSamplesPerChannel = (newNumSamples + 3) & ~3;
-        const size_t channelListSize = ((sizeof (float*) * (size_t) (newNumChannels + 1)) + 15) & ~15;
-        const size_t newTotalBytes = ((size_t) newNumChannels * (size_t) allocatedSamplesPerChannel * sizeof (float))
-                                        + channelListSize + 32;
+        const size_t allocatedSamplesPerChannel = AudioSampleBufferHelpers::getChannelStride (newNumSamples);
+        const size_t channelListSize = sizeof (float*) * (size_t) (newNumChannels + 1);
+        const size_t newTotalBytes = AudioSampleBufferHelpers::getTotalBytes (newNumChannels, allocatedSamplesPerChannel,
+                                                                              channelListSize);
 
         if (keepExistingContent)
         {
@@ -164,7 +192,7 @@ void AudioSampleBuffer::setSize (const int newNumChannels,
             const size_t numSamplesToCopy = jmin (newNumSamples, size);
 
             float** const newChannels = reinterpret_cast <float**> (newData.getData());
-            float* newChan = reinterpret_cast <float*> (newData + channelListSize);
+            float* newChan = AudioSampleBufferHelpers::getFirstChannel (newData, channelListSize);
 
             for (int j = 0; j < newNumChannels; ++j)
             {
@@ -194,7 +222,7 @@ void AudioSampleBuffer::setSize (const int newNumChannels,
                 channels = reinterpret_cast <float**> (allocatedData.getData());
             }
 
-            float* chan = reinterpret_cast <float*> (allocatedData + channelListSize);
+            float* chan = AudioSampleBufferHelpers::getFirstChannel (allocatedData, channelListSize);
             for (int i = 0; i < newNumChannels; ++i)
             {
                 channels[i] = chan;
@@ -208,6 +236,15 @@ void AudioSampleBuffer::setSize (const int newNumChannels,
     }
 }
 
+bool AudioSampleBuffer::isSimdAligned() const noexcept
+{
+    for (int i = 0; i < numChannels; ++i)
+        if ((((pointer_sized_int) channels[i]) & (AudioSampleBufferHelpers::simdAlignment - 1)) != 0)
+            return false;
+
+    return true;
+}
+
 void AudioSampleBuffer::clear() noexcept
 {
     for (int i = 0; i < numChannels; ++i)
@@ -267,14 +304,7 @@ void AudioSampleBuffer::applyGainRamp (const int channel,
         jassert (isPositiveAndBelow (channel, numChannels));
         jassert (startSample >= 0 && startSample + numSamples <= size);
 
-        const float increment = (endGain - startGain) / numSamples;
-        float* d = channels [channel] + startSample;
-
-        while (--numSamples >= 0)
-        {
-            *d++ *= startGain;
-            startGain += increment;
-        }
+        FloatVectorOperations::multiplyWithRamp (channels [channel] + startSample, startGain, endGain, numSamples);
     }
 }
 
@@ -296,8 +326,27 @@ void AudioSampleBuffer::applyGainRamp (const int startSample,
                                        const float startGain,
                                        const float endGain) noexcept
 {
-    for (int i = 0; i < numChannels; ++i)
-        applyGainRamp (i, startSample, numSamples, startGain, endGain);
+    if (startGain == endGain)
+    {
+        applyGain (startSample, numSamples, startGain);
+    }
+    else
+    {
+        jassert (startSample >= 0 && startSample + numSamples <= size);
+
+        // (the channels are done in groups, so that their pointers can live on the stack)
+        float* dests [32];
+
+        for (int i = 0; i < numChannels; i += numElementsInArray (dests))
+        {
+            const int numInGroup = jmin (numChannels - i, (int) numElementsInArray (dests));
+
+            for (int j = 0; j < numInGroup; ++j)
+                dests[j] = channels [i + j] + startSample;
+
+            FloatVectorOperations::multiplyWithRamp (dests, numInGroup, startGain, endGain, numSamples);
+        }
+    }
 }
 
 void AudioSampleBuffer::addFrom (const int destChannel,
@@ -365,16 +414,8 @@ void AudioSampleBuffer::addFromWithRamp (const int destChannel,
     else
     {
         if (numSamples > 0 && (startGain != 0.0f || endGain != 0.0f))
-        {
-            const float increment = (endGain - startGain) / numSamples;
-            float* d = channels [destChannel] + destStartSample;
-
-            while (--numSamples >= 0)
-            {
-                *d++ += startGain * *source++;
-                startGain += increment;
-            }
-        }
+            FloatVectorOperations::addWithRamp (channels [destChannel] + destStartSample,
+                                                source, startGain, endGain, numSamples);
     }
 }
 
@@ -462,16 +503,69 @@ void AudioSampleBuffer::copyFromWithRamp (const int destChannel,
     else
     {
         if (numSamples > 0 && (startGain != 0.0f || endGain != 0.0f))
+            FloatVectorOperations::copyWithRamp (channels [destChannel] + destStartSample,
+                                                 source, startGain, endGain, numSamples);
+    }
+}
+
+void AudioSampleBuffer::addFromWithRamp (const int destStartSample,
+                                         const AudioSampleBuffer& source,
+                                         const int sourceStartSample,
+                                         const int numSamples,
+                                         const float startGain,
+                                         const float endGain) noexcept
+{
+    jassert (&source != this);
+    jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
+    jassert (sourceStartSample >= 0 && sourceStartSample + numSamples <= source.size);
+
+    if (numSamples > 0 && (startGain != 0.0f || endGain != 0.0f))
+    {
+        float* dests [32];
+        const float* srcs [32];
+        const int numChans = jmin (numChannels, source.numChannels);
+
+        for (int i = 0; i < numChans; i += numElementsInArray (dests))
         {
-            const float increment = (endGain - startGain) / numSamples;
-            float* d = channels [destChannel] + destStartSample;
+            const int numInGroup = jmin (numChans - i, (int) numElementsInArray (dests));
 
-            while (--numSamples >= 0)
+            for (int j = 0; j < numInGroup; ++j)
             {
-                *d++ = startGain * *source++;
-                startGain += increment;
+                dests[j] = channels [i + j] + destStartSample;
+                srcs[j] = source.channels [i + j] + sourceStartSample;
             }
+
+            FloatVectorOperations::addWithRamp (dests, srcs, numInGroup, startGain, endGain, numSamples);
+        }
+    }
+}
+
+void AudioSampleBuffer::copyFromWithRamp (const int destStartSample,
+                                          const AudioSampleBuffer& source,
+                                          const int sourceStartSample,
+                                          const int numSamples,
+                                          const float startGain,
+                                          const float endGain) noexcept
+{
+    jassert (&source != this);
+    jassert (destStartSample >= 0 && destStartSample + numSamples <= size);
+    jassert (sourceStartSample >= 0 && sourceStartSample + numSamples <= source.size);
+
+    float* dests [32];
+    const float* srcs [32];
+    const int numChans = jmin (numChannels, source.numChannels);
+
+    for (int i = 0; i < numChans; i += numElementsInArray (dests))
+    {
+        const int numInGroup = jmin (numChans - i, (int) numElementsInArray (dests));
+
+        for (int j = 0; j < numInGroup; ++j)
+        {
+            dests[j] = channels [i + j] + destStartSample;
+            srcs[j] = source.channels [i + j] + sourceStartSample;
         }
+
+        FloatVectorOperations::copyWithRamp (dests, srcs, numInGroup, startGain, endGain, numSamples);
     }
 }
 
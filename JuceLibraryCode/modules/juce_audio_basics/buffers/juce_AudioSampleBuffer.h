@@ -152,6 +152,15 @@ public:
     */
     float** getArrayOfChannels() const noexcept         { return channels; }
 
+    /** Returns true if every channel starts on a boundary that suits the widest
+        aligned SIMD loads that FloatVectorOperations uses.
+
+        A buffer that allocates its own data always is: each channel starts on a
+        cache line, and is padded out to a whole number of cache lines, so no two
+        channels share one. A buffer that refers to someone else's data may not be.
+    */
+    bool isSimdAligned() const noexcept;
+
     //==============================================================================
     /** Changes the buffer's size or number of channels.
 
@@ -263,7 +272,8 @@ public:
 
         The gain that is applied to each sample will vary from
         startGain on the first sample to endGain on the last Sample,
-        so it can be used to do basic fades.
+        so it can be used to do basic fades. All the channels are
+        ramped together, rather than one after another.
 
         For speed, this doesn't check whether the sample numbers
         are in-range, so be careful!
@@ -329,6 +339,26 @@ public:
                           float startGain,
                           float endGain) noexcept;
 
+    /** Adds samples from all the channels of another buffer, applying a gain ramp to them.
+
+        Each of this buffer's channels gets the matching channel of the source added to it,
+        up to however many channels the smaller of the two buffers has.
+
+        @param destStartSample      the start sample within this buffer's channels
+        @param source               the source buffer to add from
+        @param sourceStartSample    the offset within the source buffer's channels to start reading samples from
+        @param numSamples           the number of samples to process
+        @param startGain            the gain to apply to the first sample
+        @param endGain              the gain to apply to the final sample. The gain is linearly
+                                    interpolated between the first and last samples.
+    */
+    void addFromWithRamp (int destStartSample,
+                          const AudioSampleBuffer& source,
+                          int sourceStartSample,
+                          int numSamples,
+                          float startGain,
+                          float endGain) noexcept;
+
     /** Copies samples from another buffer to this one.
 
         @param destChannel          the channel within this buffer to copy the samples to
@@ -397,6 +427,26 @@ public:
                            float startGain,
                            float endGain) noexcept;
 
+    /** Copies samples from all the channels of another buffer, applying a gain ramp to them.
+
+        Each of this buffer's channels gets the matching channel of the source copied into it,
+        up to however many channels the smaller of the two buffers has.
+
+        @param destStartSample      the start sample within this buffer's channels
+        @param source               the source buffer to copy from
+        @param sourceStartSample    the offset within the source buffer's channels to start reading samples from
+        @param numSamples           the number of samples to process
+        @param startGain            the gain to apply to the first sample
+        @param endGain              the gain to apply to the final sample. The gain is linearly
+                                    interpolated between the first and last samples.
+    */
+    void copyFromWithRamp (int destStartSample,
+                           const AudioSampleBuffer& source,
+                           int sourceStartSample,
+                           int numSamples,
+                           float startGain,
+                           float endGain) noexcept;
+
 
     /** Finds the highest and lowest sample values in a given range.
 
@@ -23,19 +23,41 @@
   ==============================================================================
 */
 
+namespace FloatVectorHelpers
+{
+    static int currentInstructionSet = -1;
+
+    static int getBestInstructionSet() noexcept
+    {
+       #if JUCE_USE_AVX2_INTRINSICS
+        if (SystemStats::hasAVX2() && SystemStats::hasFMA3())
+            return FloatVectorOperations::avx2Instructions;
+       #endif
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (SystemStats::hasSSE2())
+            return FloatVectorOperations::sseInstructions;
+       #endif
+
+        return FloatVectorOperations::scalarInstructions;
+    }
+
+    static inline int getInstructionSet() noexcept
+    {
+        if (currentInstructionSet < 0)
+            currentInstructionSet = getBestInstructionSet();
+
+        return currentInstructionSet;
+    }
+}
+
 #if JUCE_USE_SSE_INTRINSICS
 
 namespace FloatVectorHelpers
 {
-    static bool sse2Present = false;
-
     static bool isSSE2Available() noexcept
     {
-        if (sse2Present)
-            return true;
-
-        sse2Present = SystemStats::hasSSE2();
-        return sse2Present;
+        return getInstructionSet() >= FloatVectorOperations::sseInstructions;
     }
 
     inline static bool isAligned (const void* p) noexcept
@@ -160,6 +182,370 @@ namespace FloatVectorHelpers
  #define JUCE_PERFORM_SSE_OP_SRC_DEST(normalOp, sseOp, locals, increment)  for (int i = 0; i < num; ++i) normalOp;
 #endif
 
+//==============================================================================
+#if JUCE_USE_AVX2_INTRINSICS
+
+#if JUCE_MSVC
+ #define JUCE_AVX2_FUNCTION static
+#else
+ #define JUCE_AVX2_FUNCTION static __attribute__ ((target ("avx2,fma")))
+#endif
+
+#define JUCE_AVX_LOOP(avxOp, srcLoad, dstLoad, dstStore, locals, increment) \
+    for (int i = 0; i < numLongOps; ++i) \
+    { \
+        locals (srcLoad, dstLoad); \
+        dstStore (dest, avxOp); \
+        increment; \
+    }
+
+#define JUCE_INCREMENT_AVX_SRC_DEST    dest += 8; src += 8;
+#define JUCE_INCREMENT_AVX_DEST        dest += 8;
+
+#define JUCE_LOAD_AVX_NONE(srcLoad, dstLoad)
+#define JUCE_LOAD_AVX_DEST(srcLoad, dstLoad)     const __m256 d = dstLoad (dest);
+#define JUCE_LOAD_AVX_SRC(srcLoad, dstLoad)      const __m256 s = srcLoad (src);
+#define JUCE_LOAD_AVX_SRC_DEST(srcLoad, dstLoad) const __m256 d = dstLoad (dest); const __m256 s = srcLoad (src);
+
+#define JUCE_PERFORM_AVX_OP_DEST(normalOp, avxOp, locals) \
+    const int numLongOps = num / 8; \
+    if (isAligned32 (dest))   JUCE_AVX_LOOP (avxOp, dummy, _mm256_load_ps,  _mm256_store_ps,  locals, JUCE_INCREMENT_AVX_DEST) \
+    else                      JUCE_AVX_LOOP (avxOp, dummy, _mm256_loadu_ps, _mm256_storeu_ps, locals, JUCE_INCREMENT_AVX_DEST) \
+    num &= 7; \
+    for (int i = 0; i < num; ++i) normalOp;
+
+#define JUCE_PERFORM_AVX_OP_SRC_DEST(normalOp, avxOp, locals) \
+    const int numLongOps = num / 8; \
+    if (isAligned32 (dest)) \
+    { \
+        if (isAligned32 (src)) JUCE_AVX_LOOP (avxOp, _mm256_load_ps,  _mm256_load_ps, _mm256_store_ps, locals, JUCE_INCREMENT_AVX_SRC_DEST) \
+        else                   JUCE_AVX_LOOP (avxOp, _mm256_loadu_ps, _mm256_load_ps, _mm256_store_ps, locals, JUCE_INCREMENT_AVX_SRC_DEST) \
+    } \
+    else \
+    { \
+        if (isAligned32 (src)) JUCE_AVX_LOOP (avxOp, _mm256_load_ps,  _mm256_loadu_ps, _mm256_storeu_ps, locals, JUCE_INCREMENT_AVX_SRC_DEST) \
+        else                   JUCE_AVX_LOOP (avxOp, _mm256_loadu_ps, _mm256_loadu_ps, _mm256_storeu_ps, locals, JUCE_INCREMENT_AVX_SRC_DEST) \
+    } \
+    num &= 7; \
+    for (int i = 0; i < num; ++i) normalOp;
+
+namespace FloatVectorHelpers
+{
+    static bool isAVX2Available() noexcept
+    {
+        return getInstructionSet() >= FloatVectorOperations::avx2Instructions;
+    }
+
+    inline static bool isAligned32 (const void* p) noexcept
+    {
+        return (((pointer_sized_int) p) & 31) == 0;
+    }
+
+    // These are only ever called once the CPU is known to support AVX2 and FMA3.
+    namespace AVX2
+    {
+        JUCE_AVX2_FUNCTION void fill (float* dest, float valueToFill, int num) noexcept
+        {
+            const __m256 val = _mm256_set1_ps (valueToFill);
+            JUCE_PERFORM_AVX_OP_DEST (dest[i] = valueToFill, val, JUCE_LOAD_AVX_NONE)
+        }
+
+        JUCE_AVX2_FUNCTION void copyWithMultiply (float* dest, const float* src, float multiplier, int num) noexcept
+        {
+            const __m256 mult = _mm256_set1_ps (multiplier);
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = src[i] * multiplier, _mm256_mul_ps (mult, s), JUCE_LOAD_AVX_SRC)
+        }
+
+        JUCE_AVX2_FUNCTION void add (float* dest, const float* src, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] += src[i], _mm256_add_ps (d, s), JUCE_LOAD_AVX_SRC_DEST)
+        }
+
+        JUCE_AVX2_FUNCTION void add (float* dest, float amount, int num) noexcept
+        {
+            const __m256 amountToAdd = _mm256_set1_ps (amount);
+            JUCE_PERFORM_AVX_OP_DEST (dest[i] += amount, _mm256_add_ps (d, amountToAdd), JUCE_LOAD_AVX_DEST)
+        }
+
+        JUCE_AVX2_FUNCTION void addWithMultiply (float* dest, const float* src, float multiplier, int num) noexcept
+        {
+            const __m256 mult = _mm256_set1_ps (multiplier);
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] += src[i] * multiplier, _mm256_fmadd_ps (mult, s, d), JUCE_LOAD_AVX_SRC_DEST)
+        }
+
+        JUCE_AVX2_FUNCTION void addWithMultiply (float* dest, const float* src1, const float* src2, int num) noexcept
+        {
+            const int numLongOps = num / 8;
+
+            #define JUCE_MULTIPLY_ADD_AVX_LOOP(loadOp, storeOp) \
+                for (int i = 0; i < numLongOps; ++i) \
+                { \
+                    storeOp (dest, _mm256_fmadd_ps (loadOp (src1), loadOp (src2), loadOp (dest))); \
+                    dest += 8; src1 += 8; src2 += 8; \
+                }
+
+            if (isAligned32 (dest) && isAligned32 (src1) && isAligned32 (src2))  { JUCE_MULTIPLY_ADD_AVX_LOOP (_mm256_load_ps,  _mm256_store_ps) }
+            else                                                                 { JUCE_MULTIPLY_ADD_AVX_LOOP (_mm256_loadu_ps, _mm256_storeu_ps) }
+
+            num &= 7;
+
+            for (int i = 0; i < num; ++i)
+                dest[i] += src1[i] * src2[i];
+        }
+
+        JUCE_AVX2_FUNCTION void multiply (float* dest, const float* src, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] *= src[i], _mm256_mul_ps (d, s), JUCE_LOAD_AVX_SRC_DEST)
+        }
+
+        JUCE_AVX2_FUNCTION void multiply (float* dest, float multiplier, int num) noexcept
+        {
+            const __m256 mult = _mm256_set1_ps (multiplier);
+            JUCE_PERFORM_AVX_OP_DEST (dest[i] *= multiplier, _mm256_mul_ps (d, mult), JUCE_LOAD_AVX_DEST)
+        }
+
+        //==============================================================================
+        // Ramps keep a vector of gains, one increment apart across the lanes, and step
+        // them all on together.
+        JUCE_AVX2_FUNCTION __m256 getRampGains (const float gain, const float increment) noexcept
+        {
+            return _mm256_add_ps (_mm256_set1_ps (gain),
+                                  _mm256_mul_ps (_mm256_set1_ps (increment),
+                                                 _mm256_setr_ps (0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)));
+        }
+
+        JUCE_AVX2_FUNCTION bool areAligned32 (const float* const* chans, const int numChannels) noexcept
+        {
+            for (int i = 0; i < numChannels; ++i)
+                if (! isAligned32 (chans[i]))
+                    return false;
+
+            return true;
+        }
+
+        #define JUCE_AVX_RAMP_LOOP(avxOp, srcLoad, dstLoad, dstStore, locals) \
+            for (int i = 0; i < numLongOps; ++i) \
+            { \
+                locals (srcLoad, dstLoad); \
+                dstStore (dest, avxOp); \
+                gains = _mm256_add_ps (gains, step); \
+                dest += 8; src += 8; \
+            }
+
+        #define JUCE_PERFORM_AVX_RAMP_OP(normalOp, avxOp, locals) \
+            const int numLongOps = num / 8; \
+            __m256 gains = getRampGains (gain, increment); \
+            const __m256 step = _mm256_set1_ps (increment * 8.0f); \
+            if (isAligned32 (dest) && isAligned32 (src)) JUCE_AVX_RAMP_LOOP (avxOp, _mm256_load_ps,  _mm256_load_ps,  _mm256_store_ps,  locals) \
+            else                                         JUCE_AVX_RAMP_LOOP (avxOp, _mm256_loadu_ps, _mm256_loadu_ps, _mm256_storeu_ps, locals) \
+            gain = _mm256_cvtss_f32 (gains); \
+            num &= 7; \
+            for (int i = 0; i < num; ++i) \
+            { \
+                normalOp; \
+                gain += increment; \
+            }
+
+        // Each block of samples is done for every channel before the gains move on.
+        #define JUCE_AVX_MULTICHANNEL_RAMP_LOOP(avxOp, load, store, locals) \
+            for (int i = 0; i < numLongOps; ++i) \
+            { \
+                for (int chan = 0; chan < numChannels; ++chan) \
+                { \
+                    float* const dest = dests[chan] + i * 8; \
+                    const float* const src = srcs[chan] + i * 8; \
+                    locals (load, load); \
+                    store (dest, avxOp); \
+                } \
+                gains = _mm256_add_ps (gains, step); \
+            }
+
+        #define JUCE_PERFORM_AVX_MULTICHANNEL_RAMP_OP(normalOp, avxOp, locals) \
+            const int numLongOps = num / 8; \
+            __m256 gains = getRampGains (gain, increment); \
+            const __m256 step = _mm256_set1_ps (increment * 8.0f); \
+            if (areAligned32 (dests, numChannels) && areAligned32 (srcs, numChannels)) \
+                JUCE_AVX_MULTICHANNEL_RAMP_LOOP (avxOp, _mm256_load_ps, _mm256_store_ps, locals) \
+            else \
+                JUCE_AVX_MULTICHANNEL_RAMP_LOOP (avxOp, _mm256_loadu_ps, _mm256_storeu_ps, locals) \
+            gain = _mm256_cvtss_f32 (gains); \
+            for (int i = numLongOps * 8; i < num; ++i) \
+            { \
+                for (int chan = 0; chan < numChannels; ++chan) \
+                { \
+                    float* const dest = dests[chan]; \
+                    const float* const src = srcs[chan]; \
+                    normalOp; \
+                } \
+                gain += increment; \
+            }
+
+        JUCE_AVX2_FUNCTION void copyWithRamp (float* dest, const float* src, float gain, const float increment, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_RAMP_OP (dest[i] = src[i] * gain, _mm256_mul_ps (s, gains), JUCE_LOAD_AVX_SRC)
+        }
+
+        JUCE_AVX2_FUNCTION void addWithRamp (float* dest, const float* src, float gain, const float increment, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_RAMP_OP (dest[i] += src[i] * gain, _mm256_fmadd_ps (s, gains, d), JUCE_LOAD_AVX_SRC_DEST)
+        }
+
+        JUCE_AVX2_FUNCTION void copyWithRamp (float* const* dests, const float* const* srcs, const int numChannels,
+                                              float gain, const float increment, const int num) noexcept
+        {
+            JUCE_PERFORM_AVX_MULTICHANNEL_RAMP_OP (dest[i] = src[i] * gain, _mm256_mul_ps (s, gains), JUCE_LOAD_AVX_SRC)
+        }
+
+        JUCE_AVX2_FUNCTION void addWithRamp (float* const* dests, const float* const* srcs, const int numChannels,
+                                             float gain, const float increment, const int num) noexcept
+        {
+            JUCE_PERFORM_AVX_MULTICHANNEL_RAMP_OP (dest[i] += src[i] * gain, _mm256_fmadd_ps (s, gains, d), JUCE_LOAD_AVX_SRC_DEST)
+        }
+
+        //==============================================================================
+        JUCE_AVX2_FUNCTION void convertFixedToFloat (float* dest, const int* src, float multiplier, int num) noexcept
+        {
+            const __m256 mult = _mm256_set1_ps (multiplier);
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = src[i] * multiplier,
+                                          _mm256_mul_ps (mult, _mm256_cvtepi32_ps (_mm256_loadu_si256 ((const __m256i*) src))),
+                                          JUCE_LOAD_AVX_NONE)
+        }
+
+        JUCE_AVX2_FUNCTION void abs (float* dest, const float* src, int num) noexcept
+        {
+            const __m256 signMask = _mm256_set1_ps (-0.0f);
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = std::abs (src[i]), _mm256_andnot_ps (signMask, s), JUCE_LOAD_AVX_SRC)
+        }
+
+        JUCE_AVX2_FUNCTION void negate (float* dest, const float* src, int num) noexcept
+        {
+            const __m256 signMask = _mm256_set1_ps (-0.0f);
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = -src[i], _mm256_xor_ps (s, signMask), JUCE_LOAD_AVX_SRC)
+        }
+
+        JUCE_AVX2_FUNCTION void min (float* dest, const float* src, float comp, int num) noexcept
+        {
+            const __m256 compVal = _mm256_set1_ps (comp);
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = jmin (src[i], comp), _mm256_min_ps (s, compVal), JUCE_LOAD_AVX_SRC)
+        }
+
+        JUCE_AVX2_FUNCTION void max (float* dest, const float* src, float comp, int num) noexcept
+        {
+            const __m256 compVal = _mm256_set1_ps (comp);
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = jmax (src[i], comp), _mm256_max_ps (s, compVal), JUCE_LOAD_AVX_SRC)
+        }
+
+        JUCE_AVX2_FUNCTION void clip (float* dest, const float* src, float low, float high, int num) noexcept
+        {
+            const __m256 lowVal = _mm256_set1_ps (low), highVal = _mm256_set1_ps (high);
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = jlimit (low, high, src[i]),
+                                          _mm256_max_ps (_mm256_min_ps (s, highVal), lowVal), JUCE_LOAD_AVX_SRC)
+        }
+
+        JUCE_AVX2_FUNCTION void interleave (float* dest, const float* left, const float* right, int num) noexcept
+        {
+            const int numLongOps = num / 8;
+
+            for (int i = 0; i < numLongOps; ++i)
+            {
+                const __m256 l = _mm256_loadu_ps (left), r = _mm256_loadu_ps (right);
+                const __m256 lo = _mm256_unpacklo_ps (l, r), hi = _mm256_unpackhi_ps (l, r);
+                _mm256_storeu_ps (dest,     _mm256_permute2f128_ps (lo, hi, 0x20));
+                _mm256_storeu_ps (dest + 8, _mm256_permute2f128_ps (lo, hi, 0x31));
+                dest += 16; left += 8; right += 8;
+            }
+
+            num &= 7;
+
+            for (int i = 0; i < num; ++i)
+            {
+                dest[i * 2]     = left[i];
+                dest[i * 2 + 1] = right[i];
+            }
+        }
+
+        JUCE_AVX2_FUNCTION void deinterleave (float* left, float* right, const float* src, int num) noexcept
+        {
+            const int numLongOps = num / 8;
+
+            for (int i = 0; i < numLongOps; ++i)
+            {
+                const __m256 a = _mm256_loadu_ps (src), b = _mm256_loadu_ps (src + 8);
+                const __m256 lo = _mm256_permute2f128_ps (a, b, 0x20), hi = _mm256_permute2f128_ps (a, b, 0x31);
+                _mm256_storeu_ps (left,  _mm256_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0)));
+                _mm256_storeu_ps (right, _mm256_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1)));
+                src += 16; left += 8; right += 8;
+            }
+
+            num &= 7;
+
+            for (int i = 0; i < num; ++i)
+            {
+                left[i]  = src[i * 2];
+                right[i] = src[i * 2 + 1];
+            }
+        }
+
+        JUCE_AVX2_FUNCTION void findMinAndMax (const float* src, int num, float& minResult, float& maxResult) noexcept
+        {
+            const int numLongOps = num / 8;
+            jassert (numLongOps > 0);
+
+            __m256 mn, mx;
+
+            #define JUCE_MINMAX_AVX_LOOP(loadOp) \
+                mn = loadOp (src); \
+                mx = mn; \
+                src += 8; \
+                for (int i = 1; i < numLongOps; ++i) \
+                { \
+                    const __m256 s = loadOp (src); \
+                    mn = _mm256_min_ps (mn, s); \
+                    mx = _mm256_max_ps (mx, s); \
+                    src += 8; \
+                }
+
+            if (isAligned32 (src)) { JUCE_MINMAX_AVX_LOOP (_mm256_load_ps) }
+            else                   { JUCE_MINMAX_AVX_LOOP (_mm256_loadu_ps) }
+
+            float mns[8], mxs[8];
+            _mm256_storeu_ps (mns, mn);
+            _mm256_storeu_ps (mxs, mx);
+
+            float localMin = mns[0], localMax = mxs[0];
+
+            for (int i = 1; i < 8; ++i)
+            {
+                localMin = jmin (localMin, mns[i]);
+                localMax = jmax (localMax, mxs[i]);
+            }
+
+            num &= 7;
+
+            for (int i = 0; i < num; ++i)
+            {
+                localMin = jmin (localMin, src[i]);
+                localMax = jmax (localMax, src[i]);
+            }
+
+            minResult = localMin;
+            maxResult = localMax;
+        }
+    }
+}
+
+#define JUCE_PERFORM_AVX2_OP(functionCall) \
+    if (FloatVectorHelpers::isAVX2Available()) \
+    { \
+        FloatVectorHelpers::AVX2::functionCall; \
+        return; \
+    }
+
+#else
+ #define JUCE_PERFORM_AVX2_OP(functionCall)
+#endif
+
+//==============================================================================
 void JUCE_CALLTYPE FloatVectorOperations::clear (float* dest, int num) noexcept
 {
    #if JUCE_USE_VDSP_FRAMEWORK
@@ -174,6 +560,8 @@ void JUCE_CALLTYPE FloatVectorOperations::fill (float* dest, float valueToFill,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vfill (&valueToFill, dest, 1, num);
    #else
+    JUCE_PERFORM_AVX2_OP (fill (dest, valueToFill, num))
+
     #if JUCE_USE_SSE_INTRINSICS
      const __m128 val = _mm_load1_ps (&valueToFill);
     #endif
@@ -192,6 +580,8 @@ void JUCE_CALLTYPE FloatVectorOperations::copyWithMultiply (float* dest, const f
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul (src, 1, &multiplier, dest, 1, num);
    #else
+    JUCE_PERFORM_AVX2_OP (copyWithMultiply (dest, src, multiplier, num))
+
     #if JUCE_USE_SSE_INTRINSICS
      const __m128 mult = _mm_load1_ps (&multiplier);
     #endif
@@ -207,6 +597,8 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, const float* src, in
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vadd (src, 1, dest, 1, dest, 1, num);
    #else
+    JUCE_PERFORM_AVX2_OP (add (dest, src, num))
+
     JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] += src[i],
                                   _mm_add_ps (d, s),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
@@ -215,6 +607,8 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, const float* src, in
 
 void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, float amount, int num) noexcept
 {
+    JUCE_PERFORM_AVX2_OP (add (dest, amount, num))
+
    #if JUCE_USE_SSE_INTRINSICS
     const __m128 amountToAdd = _mm_load1_ps (&amount);
    #endif
@@ -226,6 +620,8 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, float amount, int nu
 
 void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const float* src, float multiplier, int num) noexcept
 {
+    JUCE_PERFORM_AVX2_OP (addWithMultiply (dest, src, multiplier, num))
+
    #if JUCE_USE_SSE_INTRINSICS
     const __m128 mult = _mm_load1_ps (&multiplier);
    #endif
@@ -240,6 +636,8 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, const float* sr
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmul (src, 1, dest, 1, dest, 1, num);
    #else
+    JUCE_PERFORM_AVX2_OP (multiply (dest, src, num))
+
     JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] *= src[i],
                                   _mm_mul_ps (d, s),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST)
@@ -251,6 +649,8 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, float multiplie
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul (dest, 1, &multiplier, dest, 1, num);
    #else
+    JUCE_PERFORM_AVX2_OP (multiply (dest, multiplier, num))
+
     #if JUCE_USE_SSE_INTRINSICS
      const __m128 mult = _mm_load1_ps (&multiplier);
     #endif
@@ -263,6 +663,8 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, float multiplie
 
 void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, const int* src, float multiplier, int num) noexcept
 {
+    JUCE_PERFORM_AVX2_OP (convertFixedToFloat (dest, src, multiplier, num))
+
    #if JUCE_USE_SSE_INTRINSICS
     const __m128 mult = _mm_load1_ps (&multiplier);
    #endif
@@ -274,6 +676,11 @@ void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, cons
 
 void JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* src, int num, float& minResult, float& maxResult) noexcept
 {
+   #if JUCE_USE_AVX2_INTRINSICS
+    if (num >= 16)
+        JUCE_PERFORM_AVX2_OP (findMinAndMax (src, num, minResult, maxResult))
+   #endif
+
    #if JUCE_USE_SSE_INTRINSICS
     const int numLongOps = num / 4;
 
@@ -328,6 +735,15 @@ void JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* src, int n
 
 float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int num) noexcept
 {
+   #if JUCE_USE_AVX2_INTRINSICS
+    if (num >= 16 && FloatVectorHelpers::isAVX2Available())
+    {
+        float mn, mx;
+        FloatVectorHelpers::AVX2::findMinAndMax (src, num, mn, mx);
+        return mn;
+    }
+   #endif
+
    #if JUCE_USE_SSE_INTRINSICS
     return FloatVectorHelpers::findMinimumOrMaximum (src, num, true);
    #else
@@ -337,9 +753,390 @@ float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int nu
 
 float JUCE_CALLTYPE FloatVectorOperations::findMaximum (const float* src, int num) noexcept
 {
+   #if JUCE_USE_AVX2_INTRINSICS
+    if (num >= 16 && FloatVectorHelpers::isAVX2Available())
+    {
+        float mn, mx;
+        FloatVectorHelpers::AVX2::findMinAndMax (src, num, mn, mx);
+        return mx;
+    }
+   #endif
+
    #if JUCE_USE_SSE_INTRINSICS
     return FloatVectorHelpers::findMinimumOrMaximum (src, num, false);
    #else
     return juce::findMaximum (src, num);
    #endif
 }
+
+//==============================================================================
+#if JUCE_USE_SSE_INTRINSICS
+
+namespace FloatVectorHelpers
+{
+    static inline __m128 getRampGains (const float gain, const float increment) noexcept
+    {
+        return _mm_add_ps (_mm_set1_ps (gain),
+                           _mm_mul_ps (_mm_set1_ps (increment), _mm_setr_ps (0.0f, 1.0f, 2.0f, 3.0f)));
+    }
+
+    static bool areAligned (const float* const* chans, const int numChannels) noexcept
+    {
+        for (int i = 0; i < numChannels; ++i)
+            if (! isAligned (chans[i]))
+                return false;
+
+        return true;
+    }
+}
+
+#define JUCE_SSE_RAMP_LOOP(sseOp, srcLoad, dstLoad, dstStore, locals) \
+    for (int i = 0; i < numLongOps; ++i) \
+    { \
+        locals (srcLoad, dstLoad); \
+        dstStore (dest, sseOp); \
+        gains = _mm_add_ps (gains, step); \
+        dest += 4; src += 4; \
+    }
+
+#define JUCE_PERFORM_SSE_RAMP_OP(sseOp, locals) \
+    if (FloatVectorHelpers::isSSE2Available()) \
+    { \
+        const int numLongOps = num / 4; \
+        __m128 gains = FloatVectorHelpers::getRampGains (gain, increment); \
+        const __m128 step = _mm_set1_ps (increment * 4.0f); \
+        if (FloatVectorHelpers::isAligned (dest) && FloatVectorHelpers::isAligned (src)) \
+            JUCE_SSE_RAMP_LOOP (sseOp, _mm_load_ps,  _mm_load_ps,  _mm_store_ps,  locals) \
+        else \
+            JUCE_SSE_RAMP_LOOP (sseOp, _mm_loadu_ps, _mm_loadu_ps, _mm_storeu_ps, locals) \
+        gain = _mm_cvtss_f32 (gains); \
+        FloatVectorHelpers::mmEmpty(); \
+        num &= 3; \
+    }
+
+#define JUCE_SSE_MULTICHANNEL_RAMP_LOOP(sseOp, load, store, locals) \
+    for (int i = 0; i < numLongOps; ++i) \
+    { \
+        for (int chan = 0; chan < numChannels; ++chan) \
+        { \
+            float* const dest = dests[chan] + i * 4; \
+            const float* const src = srcs[chan] + i * 4; \
+            locals (load, load); \
+            store (dest, sseOp); \
+        } \
+        gains = _mm_add_ps (gains, step); \
+    }
+
+#define JUCE_PERFORM_SSE_MULTICHANNEL_RAMP_OP(sseOp, locals) \
+    if (FloatVectorHelpers::isSSE2Available()) \
+    { \
+        const int numLongOps = num / 4; \
+        __m128 gains = FloatVectorHelpers::getRampGains (gain, increment); \
+        const __m128 step = _mm_set1_ps (increment * 4.0f); \
+        if (FloatVectorHelpers::areAligned (dests, numChannels) && FloatVectorHelpers::areAligned (srcs, numChannels)) \
+            JUCE_SSE_MULTICHANNEL_RAMP_LOOP (sseOp, _mm_load_ps,  _mm_store_ps,  locals) \
+        else \
+            JUCE_SSE_MULTICHANNEL_RAMP_LOOP (sseOp, _mm_loadu_ps, _mm_storeu_ps, locals) \
+        gain = _mm_cvtss_f32 (gains); \
+        FloatVectorHelpers::mmEmpty(); \
+        start = numLongOps * 4; \
+    }
+
+#else
+ #define JUCE_PERFORM_SSE_RAMP_OP(sseOp, locals)
+ #define JUCE_PERFORM_SSE_MULTICHANNEL_RAMP_OP(sseOp, locals)
+#endif
+
+// The gain moves on by (endGain - startGain) / num for each sample, so it never
+// quite reaches endGain, just as with AudioSampleBuffer::applyGainRamp().
+#define JUCE_PERFORM_RAMP_OP(normalOp, sseOp, locals, avxCall) \
+    if (num <= 0) \
+        return; \
+    float gain = startGain; \
+    const float increment = (endGain - startGain) / num; \
+    JUCE_PERFORM_AVX2_OP (avxCall) \
+    JUCE_PERFORM_SSE_RAMP_OP (sseOp, locals) \
+    for (int i = 0; i < num; ++i) \
+    { \
+        normalOp; \
+        gain += increment; \
+    }
+
+#define JUCE_PERFORM_MULTICHANNEL_RAMP_OP(normalOp, sseOp, locals, avxCall) \
+    if (num <= 0 || numChannels <= 0) \
+        return; \
+    float gain = startGain; \
+    const float increment = (endGain - startGain) / num; \
+    JUCE_PERFORM_AVX2_OP (avxCall) \
+    int start = 0; \
+    JUCE_PERFORM_SSE_MULTICHANNEL_RAMP_OP (sseOp, locals) \
+    for (int i = start; i < num; ++i) \
+    { \
+        for (int chan = 0; chan < numChannels; ++chan) \
+        { \
+            float* const dest = dests[chan]; \
+            const float* const src = srcs[chan]; \
+            normalOp; \
+        } \
+        gain += increment; \
+    }
+
+void JUCE_CALLTYPE FloatVectorOperations::copyWithRamp (float* dest, const float* src, float startGain, float endGain, int num) noexcept
+{
+    JUCE_PERFORM_RAMP_OP (dest[i] = src[i] * gain,
+                          _mm_mul_ps (s, gains), JUCE_LOAD_SRC,
+                          copyWithRamp (dest, src, gain, increment, num))
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithRamp (float* dest, const float* src, float startGain, float endGain, int num) noexcept
+{
+    JUCE_PERFORM_RAMP_OP (dest[i] += src[i] * gain,
+                          _mm_add_ps (d, _mm_mul_ps (s, gains)), JUCE_LOAD_SRC_DEST,
+                          addWithRamp (dest, src, gain, increment, num))
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::multiplyWithRamp (float* dest, float startGain, float endGain, int num) noexcept
+{
+    copyWithRamp (dest, dest, startGain, endGain, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::copyWithRamp (float* const* dests, const float* const* srcs, int numChannels,
+                                                       float startGain, float endGain, int num) noexcept
+{
+    JUCE_PERFORM_MULTICHANNEL_RAMP_OP (dest[i] = src[i] * gain,
+                                       _mm_mul_ps (s, gains), JUCE_LOAD_SRC,
+                                       copyWithRamp (dests, srcs, numChannels, gain, increment, num))
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithRamp (float* const* dests, const float* const* srcs, int numChannels,
+                                                      float startGain, float endGain, int num) noexcept
+{
+    JUCE_PERFORM_MULTICHANNEL_RAMP_OP (dest[i] += src[i] * gain,
+                                       _mm_add_ps (d, _mm_mul_ps (s, gains)), JUCE_LOAD_SRC_DEST,
+                                       addWithRamp (dests, srcs, numChannels, gain, increment, num))
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::multiplyWithRamp (float* const* dests, int numChannels,
+                                                           float startGain, float endGain, int num) noexcept
+{
+    copyWithRamp (dests, dests, numChannels, startGain, endGain, num);
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const float* src1, const float* src2, int num) noexcept
+{
+    JUCE_PERFORM_AVX2_OP (addWithMultiply (dest, src1, src2, num))
+
+   #if JUCE_USE_SSE_INTRINSICS
+    if (FloatVectorHelpers::isSSE2Available())
+    {
+        const int numLongOps = num / 4;
+
+        #define JUCE_MULTIPLY_ADD_SSE_LOOP(loadOp, storeOp) \
+            for (int i = 0; i < numLongOps; ++i) \
+            { \
+                storeOp (dest, _mm_add_ps (loadOp (dest), _mm_mul_ps (loadOp (src1), loadOp (src2)))); \
+                dest += 4; src1 += 4; src2 += 4; \
+            }
+
+        if (FloatVectorHelpers::isAligned (dest) && FloatVectorHelpers::isAligned (src1)
+             && FloatVectorHelpers::isAligned (src2))   { JUCE_MULTIPLY_ADD_SSE_LOOP (_mm_load_ps,  _mm_store_ps) }
+        else                                            { JUCE_MULTIPLY_ADD_SSE_LOOP (_mm_loadu_ps, _mm_storeu_ps) }
+
+        FloatVectorHelpers::mmEmpty();
+        num &= 3;
+    }
+   #endif
+
+    for (int i = 0; i < num; ++i)
+        dest[i] += src1[i] * src2[i];
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::abs (float* dest, const float* src, int num) noexcept
+{
+    JUCE_PERFORM_AVX2_OP (abs (dest, src, num))
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 signMask = _mm_set1_ps (-0.0f);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = std::abs (src[i]),
+                                  _mm_andnot_ps (signMask, s),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::negate (float* dest, const float* src, int num) noexcept
+{
+    JUCE_PERFORM_AVX2_OP (negate (dest, src, num))
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 signMask = _mm_set1_ps (-0.0f);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = -src[i],
+                                  _mm_xor_ps (s, signMask),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::min (float* dest, const float* src, float comp, int num) noexcept
+{
+    JUCE_PERFORM_AVX2_OP (min (dest, src, comp, num))
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 compVal = _mm_load1_ps (&comp);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = jmin (src[i], comp),
+                                  _mm_min_ps (s, compVal),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::max (float* dest, const float* src, float comp, int num) noexcept
+{
+    JUCE_PERFORM_AVX2_OP (max (dest, src, comp, num))
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 compVal = _mm_load1_ps (&comp);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = jmax (src[i], comp),
+                                  _mm_max_ps (s, compVal),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::clip (float* dest, const float* src, float low, float high, int num) noexcept
+{
+    jassert (high >= low);
+
+    JUCE_PERFORM_AVX2_OP (clip (dest, src, low, high, num))
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const __m128 lowVal = _mm_load1_ps (&low);
+    const __m128 highVal = _mm_load1_ps (&high);
+   #endif
+
+    JUCE_PERFORM_SSE_OP_SRC_DEST (dest[i] = jlimit (low, high, src[i]),
+                                  _mm_max_ps (_mm_min_ps (s, highVal), lowVal),
+                                  JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST)
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::interleave (float* dest, const float* const* src, int numChannels, int num) noexcept
+{
+    if (numChannels == 1)
+    {
+        copy (dest, src[0], num);
+        return;
+    }
+
+    if (numChannels == 2)
+    {
+        const float* left = src[0];
+        const float* right = src[1];
+
+        JUCE_PERFORM_AVX2_OP (interleave (dest, left, right, num))
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (FloatVectorHelpers::isSSE2Available())
+        {
+            const int numLongOps = num / 4;
+
+            for (int i = 0; i < numLongOps; ++i)
+            {
+                const __m128 l = _mm_loadu_ps (left), r = _mm_loadu_ps (right);
+                _mm_storeu_ps (dest,     _mm_unpacklo_ps (l, r));
+                _mm_storeu_ps (dest + 4, _mm_unpackhi_ps (l, r));
+                dest += 8; left += 4; right += 4;
+            }
+
+            FloatVectorHelpers::mmEmpty();
+            num &= 3;
+        }
+       #endif
+
+        for (int i = 0; i < num; ++i)
+        {
+            dest[i * 2]     = left[i];
+            dest[i * 2 + 1] = right[i];
+        }
+
+        return;
+    }
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        const float* s = src[chan];
+        float* d = dest + chan;
+
+        for (int i = 0; i < num; ++i)
+        {
+            *d = s[i];
+            d += numChannels;
+        }
+    }
+}
+
+void JUCE_CALLTYPE FloatVectorOperations::deinterleave (float* const* dest, const float* src, int numChannels, int num) noexcept
+{
+    if (numChannels == 1)
+    {
+        copy (dest[0], src, num);
+        return;
+    }
+
+    if (numChannels == 2)
+    {
+        float* left = dest[0];
+        float* right = dest[1];
+
+        JUCE_PERFORM_AVX2_OP (deinterleave (left, right, src, num))
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (FloatVectorHelpers::isSSE2Available())
+        {
+            const int numLongOps = num / 4;
+
+            for (int i = 0; i < numLongOps; ++i)
+            {
+                const __m128 a = _mm_loadu_ps (src), b = _mm_loadu_ps (src + 4);
+                _mm_storeu_ps (left,  _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+                _mm_storeu_ps (right, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+                src += 8; left += 4; right += 4;
+            }
+
+            FloatVectorHelpers::mmEmpty();
+            num &= 3;
+        }
+       #endif
+
+        for (int i = 0; i < num; ++i)
+        {
+            left[i]  = src[i * 2];
+            right[i] = src[i * 2 + 1];
+        }
+
+        return;
+    }
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        const float* s = src + chan;
+        float* d = dest[chan];
+
+        for (int i = 0; i < num; ++i)
+        {
+            d[i] = *s;
+            s += numChannels;
+        }
+    }
+}
+
+//==============================================================================
+FloatVectorOperations::InstructionSet JUCE_CALLTYPE FloatVectorOperations::getInstructionSet() noexcept
+{
+    return (InstructionSet) FloatVectorHelpers::getInstructionSet();
+}
+
+FloatVectorOperations::InstructionSet JUCE_CALLTYPE FloatVectorOperations::setInstructionSet (InstructionSet maximum) noexcept
+{
+    FloatVectorHelpers::currentInstructionSet = jmin ((int) maximum, FloatVectorHelpers::getBestInstructionSet());
+    return getInstructionSet();
+}
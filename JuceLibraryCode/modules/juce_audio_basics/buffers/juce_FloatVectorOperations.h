@@ -74,6 +74,89 @@ public:
 
     /** Finds the maximum value in the given array. */
     static float JUCE_CALLTYPE findMaximum (const float* src, int numValues) noexcept;
+
+    //==============================================================================
+    /** Multiplies the destination values by a gain that moves linearly from startGain
+        towards endGain.
+
+        As with AudioSampleBuffer::applyGainRamp(), the first value is multiplied by
+        startGain, and each one after it by (endGain - startGain) / numValues more.
+    */
+    static void JUCE_CALLTYPE multiplyWithRamp (float* dest, float startGain, float endGain, int numValues) noexcept;
+
+    /** Copies a vector of floats, multiplying each value by a gain that moves linearly
+        from startGain towards endGain, as with multiplyWithRamp().
+    */
+    static void JUCE_CALLTYPE copyWithRamp (float* dest, const float* src, float startGain, float endGain, int numValues) noexcept;
+
+    /** Adds the source values, multiplied by a gain that moves linearly from startGain
+        towards endGain, to the destination values, as with multiplyWithRamp().
+    */
+    static void JUCE_CALLTYPE addWithRamp (float* dest, const float* src, float startGain, float endGain, int numValues) noexcept;
+
+    /** Applies the same gain ramp as multiplyWithRamp() to several channels in one go.
+
+        Each channel gets exactly the gains it would from its own call to multiplyWithRamp(),
+        but the ramp is only worked out once for them all.
+    */
+    static void JUCE_CALLTYPE multiplyWithRamp (float* const* dests, int numChannels,
+                                                float startGain, float endGain, int numValues) noexcept;
+
+    /** Does copyWithRamp() for several channels in one go, with the same ramp for each. */
+    static void JUCE_CALLTYPE copyWithRamp (float* const* dests, const float* const* srcs, int numChannels,
+                                            float startGain, float endGain, int numValues) noexcept;
+
+    /** Does addWithRamp() for several channels in one go, with the same ramp for each. */
+    static void JUCE_CALLTYPE addWithRamp (float* const* dests, const float* const* srcs, int numChannels,
+                                           float startGain, float endGain, int numValues) noexcept;
+
+    /** Multiplies each pair of source values, and adds the result to the destination value. */
+    static void JUCE_CALLTYPE addWithMultiply (float* dest, const float* src1, const float* src2, int numValues) noexcept;
+
+    /** Copies the absolute values of the source values. */
+    static void JUCE_CALLTYPE abs (float* dest, const float* src, int numValues) noexcept;
+
+    /** Copies the source values, negated. */
+    static void JUCE_CALLTYPE negate (float* dest, const float* src, int numValues) noexcept;
+
+    /** Copies each source value, or the given value if it's smaller. */
+    static void JUCE_CALLTYPE min (float* dest, const float* src, float comp, int numValues) noexcept;
+
+    /** Copies each source value, or the given value if it's larger. */
+    static void JUCE_CALLTYPE max (float* dest, const float* src, float comp, int numValues) noexcept;
+
+    /** Copies the source values, limited to the range low to high. */
+    static void JUCE_CALLTYPE clip (float* dest, const float* src, float low, float high, int numValues) noexcept;
+
+    /** Interleaves separate channels into frames, i.e. dest[i * numChannels + c] = src[c][i]. */
+    static void JUCE_CALLTYPE interleave (float* dest, const float* const* src, int numChannels, int numSamples) noexcept;
+
+    /** Splits interleaved frames into separate channels, i.e. dest[c][i] = src[i * numChannels + c]. */
+    static void JUCE_CALLTYPE deinterleave (float* const* dest, const float* src, int numChannels, int numSamples) noexcept;
+
+    //==============================================================================
+    /** The instruction sets that the operations can be run with. */
+    enum InstructionSet
+    {
+        scalarInstructions = 0,     /**< Plain C++ loops. */
+        sseInstructions,            /**< SSE2, four floats at a time. */
+        avx2Instructions            /**< AVX2 and FMA3, eight floats at a time. */
+    };
+
+    /** Returns the instruction set that the operations are using.
+
+        By default this is the best one that both the CPU and the build support. The
+        AVX2 versions of addWithMultiply() and addWithRamp() use fused multiply-adds,
+        so their results can differ from the others' in the last bit. (On the Mac,
+        some operations always use the Accelerate framework instead.)
+    */
+    static InstructionSet JUCE_CALLTYPE getInstructionSet() noexcept;
+
+    /** Stops the operations using anything better than the given instruction set,
+        e.g. to compare their speed. Returns the instruction set that they'll actually
+        use, which is lower if the CPU or the build doesn't support the one asked for.
+    */
+    static InstructionSet JUCE_CALLTYPE setInstructionSet (InstructionSet maximum) noexcept;
 };
 
 
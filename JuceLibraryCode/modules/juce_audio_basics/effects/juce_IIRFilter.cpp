@@ -29,6 +29,129 @@
  #define JUCE_SNAP_TO_ZERO(n)
 #endif
 
+//==============================================================================
+IIRCoefficients::IIRCoefficients() noexcept
+{
+    coefficients[0] = 1.0;
+    coefficients[1] = coefficients[2] = coefficients[3] = coefficients[4] = 0;
+}
+
+IIRCoefficients::IIRCoefficients (double c1, double c2, double c3,
+                                  double c4, double c5, double c6) noexcept
+{
+    const double a = 1.0 / c4;
+
+    coefficients[0] = c1 * a;
+    coefficients[1] = c2 * a;
+    coefficients[2] = c3 * a;
+    coefficients[3] = c5 * a;
+    coefficients[4] = c6 * a;
+}
+
+//==============================================================================
+IIRCoefficients IIRCoefficients::makeLowPass (const double sampleRate,
+                                              const double frequency) noexcept
+{
+    jassert (sampleRate > 0);
+
+    const double n = 1.0 / tan (double_Pi * frequency / sampleRate);
+    const double nSquared = n * n;
+    const double c1 = 1.0 / (1.0 + std::sqrt (2.0) * n + nSquared);
+
+    return IIRCoefficients (c1,
+                            c1 * 2.0f,
+                            c1,
+                            1.0,
+                            c1 * 2.0 * (1.0 - nSquared),
+                            c1 * (1.0 - std::sqrt (2.0) * n + nSquared));
+}
+
+IIRCoefficients IIRCoefficients::makeHighPass (const double sampleRate,
+                                               const double frequency) noexcept
+{
+    const double n = tan (double_Pi * frequency / sampleRate);
+    const double nSquared = n * n;
+    const double c1 = 1.0 / (1.0 + std::sqrt (2.0) * n + nSquared);
+
+    return IIRCoefficients (c1,
+                            c1 * -2.0f,
+                            c1,
+                            1.0,
+                            c1 * 2.0 * (nSquared - 1.0),
+                            c1 * (1.0 - std::sqrt (2.0) * n + nSquared));
+}
+
+IIRCoefficients IIRCoefficients::makeLowShelf (const double sampleRate,
+                                               const double cutOffFrequency,
+                                               const double Q,
+                                               const float gainFactor) noexcept
+{
+    jassert (sampleRate > 0);
+    jassert (Q > 0);
+
+    const double A = jmax (0.0f, gainFactor);
+    const double aminus1 = A - 1.0;
+    const double aplus1 = A + 1.0;
+    const double omega = (double_Pi * 2.0 * jmax (cutOffFrequency, 2.0)) / sampleRate;
+    const double coso = std::cos (omega);
+    const double beta = std::sin (omega) * std::sqrt (A) / Q;
+    const double aminus1TimesCoso = aminus1 * coso;
+
+    return IIRCoefficients (A * (aplus1 - aminus1TimesCoso + beta),
+                            A * 2.0 * (aminus1 - aplus1 * coso),
+                            A * (aplus1 - aminus1TimesCoso - beta),
+                            aplus1 + aminus1TimesCoso + beta,
+                            -2.0 * (aminus1 + aplus1 * coso),
+                            aplus1 + aminus1TimesCoso - beta);
+}
+
+IIRCoefficients IIRCoefficients::makeHighShelf (const double sampleRate,
+                                                const double cutOffFrequency,
+                                                const double Q,
+                                                const float gainFactor) noexcept
+{
+    jassert (sampleRate > 0);
+    jassert (Q > 0);
+
+    const double A = jmax (0.0f, gainFactor);
+    const double aminus1 = A - 1.0;
+    const double aplus1 = A + 1.0;
+    const double omega = (double_Pi * 2.0 * jmax (cutOffFrequency, 2.0)) / sampleRate;
+    const double coso = std::cos (omega);
+    const double beta = std::sin (omega) * std::sqrt (A) / Q;
+    const double aminus1TimesCoso = aminus1 * coso;
+
+    return IIRCoefficients (A * (aplus1 + aminus1TimesCoso + beta),
+                            A * -2.0 * (aminus1 + aplus1 * coso),
+                            A * (aplus1 + aminus1TimesCoso - beta),
+                            aplus1 - aminus1TimesCoso + beta,
+                            2.0 * (aminus1 - aplus1 * coso),
+                            aplus1 - aminus1TimesCoso - beta);
+}
+
+IIRCoefficients IIRCoefficients::makeBandPass (const double sampleRate,
+                                               const double centreFrequency,
+                                               const double Q,
+                                               const float gainFactor) noexcept
+{
+    jassert (sampleRate > 0);
+    jassert (Q > 0);
+
+    const double A = jmax (0.0f, gainFactor);
+    const double omega = (double_Pi * 2.0 * jmax (centreFrequency, 2.0)) / sampleRate;
+    const double alpha = 0.5 * std::sin (omega) / Q;
+    const double c2 = -2.0 * std::cos (omega);
+    const double alphaTimesA = alpha * A;
+    const double alphaOverA = alpha / A;
+
+    return IIRCoefficients (1.0 + alphaTimesA,
+                            c2,
+                            1.0 - alphaTimesA,
+                            1.0 + alphaOverA,
+                            c2,
+                            1.0 - alphaOverA);
+}
+
 //==============================================================================
 IIRFilter::IIRFilter()
     : active (false), v1 (0), v2 (0)
@@ -98,33 +221,13 @@ void IIRFilter::processSamples (float* const samples,
 void IIRFilter::makeLowPass (const double sampleRate,
                              const double frequency) noexcept
 {
-    jassert (sampleRate > 0);
-
-    const double n = 1.0 / tan (double_Pi * frequency / sampleRate);
-    const double nSquared = n * n;
-    const double c1 = 1.0 / (1.0 + std::sqrt (2.0) * n + nSquared);
-
-    setCoefficients (c1,
-                     c1 * 2.0f,
-                     c1,
-                     1.0,
-                     c1 * 2.0 * (1.0 - nSquared),
-                     c1 * (1.0 - std::sqrt (2.0) * n + nSquared));
+    setCoefficients (IIRCoefficients::makeLowPass (sampleRate, frequency));
 }
 
 void IIRFilter::makeHighPass (const double sampleRate,
                               const double frequency) noexcept
 {
-    const double n = tan (double_Pi * frequency / sampleRate);
-    const double nSquared = n * n;
-    const double c1 = 1.0 / (1.0 + std::sqrt (2.0) * n + nSquared);
-
-    setCoefficients (c1,
-                     c1 * -2.0f,
-                     c1,
-                     1.0,
-                     c1 * 2.0 * (nSquared - 1.0),
-                     c1 * (1.0 - std::sqrt (2.0) * n + nSquared));
+    setCoefficients (IIRCoefficients::makeHighPass (sampleRate, frequency));
 }
 
 void IIRFilter::makeLowShelf (const double sampleRate,
@@ -132,23 +235,7 @@ void IIRFilter::makeLowShelf (const double sampleRate,
                               const double Q,
                               const float gainFactor) noexcept
 {
-    jassert (sampleRate > 0);
-    jassert (Q > 0);
-
-    const double A = jmax (0.0f, gainFactor);
-    const double aminus1 = A - 1.0;
-    const double aplus1 = A + 1.0;
-    const double omega = (double_Pi * 2.0 * jmax (cutOffFrequency, 2.0)) / sampleRate;
-    const double coso = std::cos (omega);
-    const double beta = std::sin (omega) * std::sqrt (A) / Q;
-    const double aminus1TimesCoso = aminus1 * coso;
-
-    setCoefficients (A * (aplus1 - aminus1TimesCoso + beta),
-                     A * 2.0 * (aminus1 - aplus1 * coso),
-                     A * (aplus1 - aminus1TimesCoso - beta),
-                     aplus1 + aminus1TimesCoso + beta,
-                     -2.0 * (aminus1 + aplus1 * coso),
-                     aplus1 + aminus1TimesCoso - beta);
+    setCoefficients (IIRCoefficients::makeLowShelf (sampleRate, cutOffFrequency, Q, gainFactor));
 }
 
 void IIRFilter::makeHighShelf (const double sampleRate,
@@ -156,23 +243,7 @@ void IIRFilter::makeHighShelf (const double sampleRate,
                                const double Q,
                                const float gainFactor) noexcept
 {
-    jassert (sampleRate > 0);
-    jassert (Q > 0);
-
-    const double A = jmax (0.0f, gainFactor);
-    const double aminus1 = A - 1.0;
-    const double aplus1 = A + 1.0;
-    const double omega = (double_Pi * 2.0 * jmax (cutOffFrequency, 2.0)) / sampleRate;
-    const double coso = std::cos (omega);
-    const double beta = std::sin (omega) * std::sqrt (A) / Q;
-    const double aminus1TimesCoso = aminus1 * coso;
-
-    setCoefficients (A * (aplus1 + aminus1TimesCoso + beta),
-                     A * -2.0 * (aminus1 + aplus1 * coso),
-                     A * (aplus1 + aminus1TimesCoso - beta),
-                     aplus1 - aminus1TimesCoso + beta,
-                     2.0 * (aminus1 - aplus1 * coso),
-                     aplus1 - aminus1TimesCoso - beta);
+    setCoefficients (IIRCoefficients::makeHighShelf (sampleRate, cutOffFrequency, Q, gainFactor));
 }
 
 void IIRFilter::makeBandPass (const double sampleRate,
@@ -180,22 +251,7 @@ void IIRFilter::makeBandPass (const double sampleRate,
                               const double Q,
                               const float gainFactor) noexcept
 {
-    jassert (sampleRate > 0);
-    jassert (Q > 0);
-
-    const double A = jmax (0.0f, gainFactor);
-    const double omega = (double_Pi * 2.0 * jmax (centreFrequency, 2.0)) / sampleRate;
-    const double alpha = 0.5 * std::sin (omega) / Q;
-    const double c2 = -2.0 * std::cos (omega);
-    const double alphaTimesA = alpha * A;
-    const double alphaOverA = alpha / A;
-
-    setCoefficients (1.0 + alphaTimesA,
-                     c2,
-                     1.0 - alphaTimesA,
-                     1.0 + alphaOverA,
-                     c2,
-                     1.0 - alphaOverA);
+    setCoefficients (IIRCoefficients::makeBandPass (sampleRate, centreFrequency, Q, gainFactor));
 }
 
 void IIRFilter::makeInactive() noexcept
@@ -217,23 +273,29 @@ void IIRFilter::copyCoefficientsFrom (const IIRFilter& other) noexcept
 void IIRFilter::setCoefficients (double c1, double c2, double c3,
                                  double c4, double c5, double c6) noexcept
 {
-    const double a = 1.0 / c4;
-
-    c1 *= a;
-    c2 *= a;
-    c3 *= a;
-    c5 *= a;
-    c6 *= a;
+    setCoefficients (IIRCoefficients (c1, c2, c3, c4, c5, c6));
+}
 
+void IIRFilter::setCoefficients (const IIRCoefficients& newCoefficients) noexcept
+{
     const SpinLock::ScopedLockType sl (processLock);
 
-    coefficients[0] = (float) c1;
-    coefficients[1] = (float) c2;
-    coefficients[2] = (float) c3;
-    coefficients[3] = (float) c5;
-    coefficients[4] = (float) c6;
+    for (int i = 0; i < numElementsInArray (coefficients); ++i)
+        coefficients[i] = (float) newCoefficients.coefficients[i];
 
     active = true;
 }
 
+IIRCoefficients IIRFilter::getCoefficients() const noexcept
+{
+    const SpinLock::ScopedLockType sl (processLock);
+    IIRCoefficients result;
+
+    if (active)
+        for (int i = 0; i < numElementsInArray (coefficients); ++i)
+            result.coefficients[i] = coefficients[i];
+
+    return result;
+}
+
 #undef JUCE_SNAP_TO_ZERO
@@ -27,11 +27,67 @@
 #define __JUCE_IIRFILTER_JUCEHEADER__
 
 
+//==============================================================================
+/**
+    A set of coefficients for a second-order (biquad) IIR filter.
+
+    These are normalised so that the first feedback coefficient is 1, and kept in
+    double precision - an IIRFilter rounds them to floats when it uses them.
+
+    @see IIRFilter, MultiChannelIIRFilter
+*/
+class JUCE_API  IIRCoefficients
+{
+public:
+    //==============================================================================
+    /** Creates a set of coefficients that passes the signal through unchanged. */
+    IIRCoefficients() noexcept;
+
+    /** Creates a set of coefficients from the feed-forward (b0, b1, b2) and
+        feedback (a0, a1, a2) terms of the filter's transfer function.
+    */
+    IIRCoefficients (double b0, double b1, double b2,
+                     double a0, double a1, double a2) noexcept;
+
+    //==============================================================================
+    /** Returns the coefficients for a low-pass filter. */
+    static IIRCoefficients makeLowPass (double sampleRate, double frequency) noexcept;
+
+    /** Returns the coefficients for a high-pass filter. */
+    static IIRCoefficients makeHighPass (double sampleRate, double frequency) noexcept;
+
+    /** Returns the coefficients for a low-pass shelf filter with variable Q and gain.
+        @see IIRFilter::makeLowShelf
+    */
+    static IIRCoefficients makeLowShelf (double sampleRate, double cutOffFrequency,
+                                         double Q, float gainFactor) noexcept;
+
+    /** Returns the coefficients for a high-pass shelf filter with variable Q and gain.
+        @see IIRFilter::makeHighShelf
+    */
+    static IIRCoefficients makeHighShelf (double sampleRate, double cutOffFrequency,
+                                          double Q, float gainFactor) noexcept;
+
+    /** Returns the coefficients for a band pass filter with variable Q and gain.
+        @see IIRFilter::makeBandPass
+    */
+    static IIRCoefficients makeBandPass (double sampleRate, double centreFrequency,
+                                         double Q, float gainFactor) noexcept;
+
+    //==============================================================================
+    /** The normalised coefficients, in the order b0, b1, b2, a1, a2. */
+    double coefficients[5];
+};
+
+
 //==============================================================================
 /**
     An IIR filter that can perform low, high, or band-pass filtering on an
     audio signal.
 
+    To filter several channels with the same settings, a MultiChannelIIRFilter
+    will be much faster than one of these for each channel.
+
     @see IIRFilterAudioSource
 */
 class JUCE_API  IIRFilter
@@ -123,6 +179,15 @@ public:
     */
     void makeInactive() noexcept;
 
+    /** Sets the filter's coefficients directly. */
+    void setCoefficients (const IIRCoefficients& newCoefficients) noexcept;
+
+    /** Returns the filter's current coefficients.
+
+        If the filter is inactive, these will pass the signal through unchanged.
+    */
+    IIRCoefficients getCoefficients() const noexcept;
+
     //==============================================================================
     /** Makes this filter duplicate the set-up of another one.
     */
@@ -0,0 +1,454 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace MultiChannelIIRHelpers
+{
+    /*  Each group of channels is filtered in chunks: the chunk's samples are copied
+        into a scratch buffer with the channels side by side, every section is run over
+        the whole chunk with its state held in registers, and the results are copied
+        back. Each section does exactly the same arithmetic as IIRFilter::processSamples(),
+        in the same order, so the SIMD and scalar versions give identical results.
+
+        The recurrence is limited by the latency of its multiply-adds rather than their
+        throughput, so wider vectors wouldn't help much - what matters is having several
+        independent lanes in flight, which the SSE version already gets from two vectors
+        of four floats (or four vectors of two doubles) per group of eight channels.
+    */
+    enum { chunkSize = 64, maxChannels = MultiChannelIIRFilter::maxChannelsPerGroup };
+
+    template <typename Type>
+    static void snapStateToZero (Type* const state, const int numValues) noexcept
+    {
+       #if JUCE_INTEL
+        for (int i = 0; i < numValues; ++i)
+            if (! (state[i] < -1.0e-8 || state[i] > 1.0e-8))
+                state[i] = 0;
+       #else
+        (void) state; (void) numValues;
+       #endif
+    }
+
+    //==============================================================================
+    template <typename Type>
+    static void processScalar (float* const* const channels, const int numChannels, Type* const state,
+                               const Type* const coefficients, const int numSections, const int numSamples) noexcept
+    {
+        Type scratch [chunkSize];
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            float* samples = channels[chan];
+
+            for (int done = 0; done < numSamples;)
+            {
+                const int num = jmin ((int) chunkSize, numSamples - done);
+
+                for (int i = 0; i < num; ++i)
+                    scratch[i] = (Type) samples[i];
+
+                for (int section = 0; section < numSections; ++section)
+                {
+                    const Type* const c = coefficients + 5 * section;
+                    Type* const s1 = state + section * 2 * maxChannels + chan;
+                    Type* const s2 = s1 + maxChannels;
+                    Type lv1 = *s1, lv2 = *s2;
+
+                    for (int i = 0; i < num; ++i)
+                    {
+                        const Type in = scratch[i];
+                        const Type out = c[0] * in + lv1;
+                        scratch[i] = out;
+
+                        lv1 = c[1] * in - c[3] * out + lv2;
+                        lv2 = c[2] * in - c[4] * out;
+                    }
+
+                    *s1 = lv1;
+                    *s2 = lv2;
+                }
+
+                for (int i = 0; i < num; ++i)
+                    samples[i] = (float) scratch[i];
+
+                samples += num;
+                done += num;
+            }
+        }
+    }
+
+    //==============================================================================
+   #if JUCE_USE_SSE_INTRINSICS
+    struct SSEFloatLanes
+    {
+        typedef float Type;
+        typedef __m128 Vec;
+        enum { vecsPerQuad = 1, lanesPerVec = 4 };
+
+        static forcedinline Vec load (const float* p) noexcept              { return _mm_loadu_ps (p); }
+        static forcedinline void store (float* p, Vec v) noexcept           { _mm_storeu_ps (p, v); }
+        static forcedinline Vec set1 (float v) noexcept                     { return _mm_set1_ps (v); }
+        static forcedinline Vec add (Vec a, Vec b) noexcept                 { return _mm_add_ps (a, b); }
+        static forcedinline Vec sub (Vec a, Vec b) noexcept                 { return _mm_sub_ps (a, b); }
+        static forcedinline Vec mul (Vec a, Vec b) noexcept                 { return _mm_mul_ps (a, b); }
+        static forcedinline void fromFloats (Vec* dest, __m128 x) noexcept  { dest[0] = x; }
+        static forcedinline __m128 toFloats (const Vec* src) noexcept       { return src[0]; }
+    };
+
+    struct SSEDoubleLanes
+    {
+        typedef double Type;
+        typedef __m128d Vec;
+        enum { vecsPerQuad = 2, lanesPerVec = 2 };
+
+        static forcedinline Vec load (const double* p) noexcept             { return _mm_loadu_pd (p); }
+        static forcedinline void store (double* p, Vec v) noexcept          { _mm_storeu_pd (p, v); }
+        static forcedinline Vec set1 (double v) noexcept                    { return _mm_set1_pd (v); }
+        static forcedinline Vec add (Vec a, Vec b) noexcept                 { return _mm_add_pd (a, b); }
+        static forcedinline Vec sub (Vec a, Vec b) noexcept                 { return _mm_sub_pd (a, b); }
+        static forcedinline Vec mul (Vec a, Vec b) noexcept                 { return _mm_mul_pd (a, b); }
+
+        static forcedinline void fromFloats (Vec* dest, __m128 x) noexcept
+        {
+            dest[0] = _mm_cvtps_pd (x);
+            dest[1] = _mm_cvtps_pd (_mm_movehl_ps (x, x));
+        }
+
+        static forcedinline __m128 toFloats (const Vec* src) noexcept
+        {
+            return _mm_movelh_ps (_mm_cvtpd_ps (src[0]), _mm_cvtpd_ps (src[1]));
+        }
+    };
+
+    // Copies a chunk of up to four channels into the scratch buffer, one vector per frame.
+    template <class Lanes, int numVecs>
+    static void gatherQuad (typename Lanes::Vec* const scratch, float* const* const channels,
+                            const int numChannels, const int offset, const int num) noexcept
+    {
+        const __m128 zero = _mm_setzero_ps();
+        int i = 0;
+
+        for (; i <= num - 4; i += 4)
+        {
+            __m128 r0 = numChannels > 0 ? _mm_loadu_ps (channels[0] + offset + i) : zero;
+            __m128 r1 = numChannels > 1 ? _mm_loadu_ps (channels[1] + offset + i) : zero;
+            __m128 r2 = numChannels > 2 ? _mm_loadu_ps (channels[2] + offset + i) : zero;
+            __m128 r3 = numChannels > 3 ? _mm_loadu_ps (channels[3] + offset + i) : zero;
+            _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+
+            Lanes::fromFloats (scratch + (i + 0) * numVecs, r0);
+            Lanes::fromFloats (scratch + (i + 1) * numVecs, r1);
+            Lanes::fromFloats (scratch + (i + 2) * numVecs, r2);
+            Lanes::fromFloats (scratch + (i + 3) * numVecs, r3);
+        }
+
+        for (; i < num; ++i)
+        {
+            float frame[4] = { 0 };
+
+            for (int chan = 0; chan < numChannels; ++chan)
+                frame[chan] = channels[chan][offset + i];
+
+            Lanes::fromFloats (scratch + i * numVecs, _mm_loadu_ps (frame));
+        }
+    }
+
+    template <class Lanes, int numVecs>
+    static void scatterQuad (const typename Lanes::Vec* const scratch, float* const* const channels,
+                             const int numChannels, const int offset, const int num) noexcept
+    {
+        int i = 0;
+
+        for (; i <= num - 4; i += 4)
+        {
+            __m128 r0 = Lanes::toFloats (scratch + (i + 0) * numVecs);
+            __m128 r1 = Lanes::toFloats (scratch + (i + 1) * numVecs);
+            __m128 r2 = Lanes::toFloats (scratch + (i + 2) * numVecs);
+            __m128 r3 = Lanes::toFloats (scratch + (i + 3) * numVecs);
+            _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+
+            if (numChannels > 0)  _mm_storeu_ps (channels[0] + offset + i, r0);
+            if (numChannels > 1)  _mm_storeu_ps (channels[1] + offset + i, r1);
+            if (numChannels > 2)  _mm_storeu_ps (channels[2] + offset + i, r2);
+            if (numChannels > 3)  _mm_storeu_ps (channels[3] + offset + i, r3);
+        }
+
+        for (; i < num; ++i)
+        {
+            float frame[4];
+            _mm_storeu_ps (frame, Lanes::toFloats (scratch + i * numVecs));
+
+            for (int chan = 0; chan < numChannels; ++chan)
+                channels[chan][offset + i] = frame[chan];
+        }
+    }
+
+    template <class Lanes, int numVecs>
+    static void processSectionSSE (typename Lanes::Vec* const scratch, const int num,
+                                   typename Lanes::Type* const s1State, typename Lanes::Type* const s2State,
+                                   const typename Lanes::Type* const c) noexcept
+    {
+        typedef typename Lanes::Vec Vec;
+
+        const Vec c0 (Lanes::set1 (c[0])), c1 (Lanes::set1 (c[1])), c2 (Lanes::set1 (c[2]));
+        const Vec c3 (Lanes::set1 (c[3])), c4 (Lanes::set1 (c[4]));
+        Vec lv1 [numVecs], lv2 [numVecs];
+
+        for (int v = 0; v < numVecs; ++v)
+        {
+            lv1[v] = Lanes::load (s1State + v * Lanes::lanesPerVec);
+            lv2[v] = Lanes::load (s2State + v * Lanes::lanesPerVec);
+        }
+
+        for (int i = 0; i < num; ++i)
+        {
+            Vec* const frame = scratch + i * numVecs;
+
+            for (int v = 0; v < numVecs; ++v)
+            {
+                const Vec in (frame[v]);
+                const Vec out (Lanes::add (Lanes::mul (c0, in), lv1[v]));
+                frame[v] = out;
+
+                lv1[v] = Lanes::add (Lanes::sub (Lanes::mul (c1, in), Lanes::mul (c3, out)), lv2[v]);
+                lv2[v] = Lanes::sub (Lanes::mul (c2, in), Lanes::mul (c4, out));
+            }
+        }
+
+        for (int v = 0; v < numVecs; ++v)
+        {
+            Lanes::store (s1State + v * Lanes::lanesPerVec, lv1[v]);
+            Lanes::store (s2State + v * Lanes::lanesPerVec, lv2[v]);
+        }
+    }
+
+    template <class Lanes, int numVecs>
+    static void processSSE (float* const* const channels, const int numChannels, typename Lanes::Type* const state,
+                            const typename Lanes::Type* const coefficients, const int numSections, const int numSamples) noexcept
+    {
+        typename Lanes::Vec scratch [chunkSize * numVecs];
+        const int numQuads = numVecs / Lanes::vecsPerQuad;
+
+        for (int done = 0; done < numSamples; done += chunkSize)
+        {
+            const int num = jmin ((int) chunkSize, numSamples - done);
+
+            for (int quad = 0; quad < numQuads; ++quad)
+                gatherQuad<Lanes, numVecs> (scratch + quad * Lanes::vecsPerQuad, channels + quad * 4,
+                                            jmin (4, numChannels - quad * 4), done, num);
+
+            for (int section = 0; section < numSections; ++section)
+            {
+                typename Lanes::Type* const s1 = state + section * 2 * maxChannels;
+                processSectionSSE<Lanes, numVecs> (scratch, num, s1, s1 + maxChannels, coefficients + 5 * section);
+            }
+
+            for (int quad = 0; quad < numQuads; ++quad)
+                scatterQuad<Lanes, numVecs> (scratch + quad * Lanes::vecsPerQuad, channels + quad * 4,
+                                             jmin (4, numChannels - quad * 4), done, num);
+        }
+    }
+   #endif
+}
+
+//==============================================================================
+MultiChannelIIRFilter::MultiChannelIIRFilter (const int numChannels_, const int numSections_,
+                                              const bool useDoublePrecisionState)
+    : numChannels (0), numSections (0), useDoublePrecision (false)
+{
+    setSize (numChannels_, numSections_, useDoublePrecisionState);
+}
+
+MultiChannelIIRFilter::~MultiChannelIIRFilter()
+{
+}
+
+//==============================================================================
+int MultiChannelIIRFilter::getStateBytesPerGroup() const noexcept
+{
+    return numSections * 2 * maxChannelsPerGroup * (int) (useDoublePrecision ? sizeof (double) : sizeof (float));
+}
+
+void MultiChannelIIRFilter::setSize (const int newNumChannels, const int newNumSections, const bool useDoublePrecisionState)
+{
+    jassert (newNumChannels >= 0 && newNumSections > 0);
+
+    const SpinLock::ScopedLockType sl (processLock);
+
+    const int oldNumGroups = (numChannels + maxChannelsPerGroup - 1) / maxChannelsPerGroup;
+    const int newNumGroups = (newNumChannels + maxChannelsPerGroup - 1) / maxChannelsPerGroup;
+
+    if (newNumSections != numSections || useDoublePrecisionState != useDoublePrecision)
+    {
+        coefficients.realloc ((size_t) (5 * newNumSections));
+        floatCoefficients.realloc ((size_t) (5 * newNumSections));
+
+        const IIRCoefficients passThrough;
+
+        for (int i = numSections; i < newNumSections; ++i)
+            for (int j = 0; j < 5; ++j)
+                coefficients [5 * i + j] = passThrough.coefficients[j];
+
+        for (int i = 0; i < 5 * newNumSections; ++i)
+            floatCoefficients[i] = (float) coefficients[i];
+
+        numSections = newNumSections;
+        useDoublePrecision = useDoublePrecisionState;
+        state.calloc ((size_t) (jmax (1, newNumGroups) * getStateBytesPerGroup()));
+    }
+    else if (newNumGroups != oldNumGroups)
+    {
+        const int bytesPerGroup = getStateBytesPerGroup();
+        state.realloc ((size_t) (jmax (1, newNumGroups) * bytesPerGroup));
+
+        if (newNumGroups > oldNumGroups)
+            zeromem (state + oldNumGroups * bytesPerGroup, (size_t) ((newNumGroups - oldNumGroups) * bytesPerGroup));
+    }
+
+    numChannels = newNumChannels;
+}
+
+//==============================================================================
+void MultiChannelIIRFilter::setCoefficients (const int sectionIndex, const IIRCoefficients& newCoefficients) noexcept
+{
+    jassert (isPositiveAndBelow (sectionIndex, numSections));
+
+    const SpinLock::ScopedLockType sl (processLock);
+
+    if (isPositiveAndBelow (sectionIndex, numSections))
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            coefficients [5 * sectionIndex + i] = newCoefficients.coefficients[i];
+            floatCoefficients [5 * sectionIndex + i] = (float) newCoefficients.coefficients[i];
+        }
+    }
+}
+
+IIRCoefficients MultiChannelIIRFilter::getCoefficients (const int sectionIndex) const noexcept
+{
+    const SpinLock::ScopedLockType sl (processLock);
+    IIRCoefficients result;
+
+    if (isPositiveAndBelow (sectionIndex, numSections))
+        for (int i = 0; i < 5; ++i)
+            result.coefficients[i] = coefficients [5 * sectionIndex + i];
+
+    return result;
+}
+
+void MultiChannelIIRFilter::reset() noexcept
+{
+    const SpinLock::ScopedLockType sl (processLock);
+
+    const int numGroups = (numChannels + maxChannelsPerGroup - 1) / maxChannelsPerGroup;
+    zeromem (state, (size_t) (numGroups * getStateBytesPerGroup()));
+}
+
+//==============================================================================
+void MultiChannelIIRFilter::processSamples (float* const* const channels, const int numChannelsToProcess,
+                                            const int numSamples) noexcept
+{
+    const SpinLock::ScopedLockType sl (processLock);
+    const int num = jmin (numChannelsToProcess, numChannels);
+
+    for (int group = 0; group * maxChannelsPerGroup < num; ++group)
+        processGroup (channels + group * maxChannelsPerGroup,
+                      jmin ((int) maxChannelsPerGroup, num - group * maxChannelsPerGroup),
+                      group, numSamples);
+}
+
+void MultiChannelIIRFilter::processSamples (AudioSampleBuffer& buffer, const int startSample,
+                                            const int numSamples) noexcept
+{
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    const SpinLock::ScopedLockType sl (processLock);
+    const int num = jmin (buffer.getNumChannels(), numChannels);
+    float* channels [maxChannelsPerGroup];
+
+    for (int group = 0; group * maxChannelsPerGroup < num; ++group)
+    {
+        const int numInGroup = jmin ((int) maxChannelsPerGroup, num - group * maxChannelsPerGroup);
+
+        for (int i = 0; i < numInGroup; ++i)
+            channels[i] = buffer.getSampleData (group * maxChannelsPerGroup + i, startSample);
+
+        processGroup (channels, numInGroup, group, numSamples);
+    }
+}
+
+void MultiChannelIIRFilter::processGroup (float* const* const channels, const int numChannelsInGroup,
+                                          const int group, const int numSamples) noexcept
+{
+    using namespace MultiChannelIIRHelpers;
+
+    char* const groupState = state + group * getStateBytesPerGroup();
+    const int numStateValues = numSections * 2 * maxChannelsPerGroup;
+
+    if (useDoublePrecision)
+    {
+        double* const s = reinterpret_cast <double*> (groupState);
+        const double* const c = coefficients;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (FloatVectorOperations::getInstructionSet() != FloatVectorOperations::scalarInstructions)
+        {
+            switch ((numChannelsInGroup + 3) / 4)
+            {
+                case 1:   processSSE<SSEDoubleLanes, 2> (channels, numChannelsInGroup, s, c, numSections, numSamples); break;
+                default:  processSSE<SSEDoubleLanes, 4> (channels, numChannelsInGroup, s, c, numSections, numSamples); break;
+            }
+        }
+        else
+       #endif
+        {
+            processScalar (channels, numChannelsInGroup, s, c, numSections, numSamples);
+        }
+
+        snapStateToZero (s, numStateValues);
+    }
+    else
+    {
+        float* const s = reinterpret_cast <float*> (groupState);
+        const float* const c = floatCoefficients;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (FloatVectorOperations::getInstructionSet() != FloatVectorOperations::scalarInstructions)
+        {
+            switch ((numChannelsInGroup + 3) / 4)
+            {
+                case 1:   processSSE<SSEFloatLanes, 1> (channels, numChannelsInGroup, s, c, numSections, numSamples); break;
+                default:  processSSE<SSEFloatLanes, 2> (channels, numChannelsInGroup, s, c, numSections, numSamples); break;
+            }
+        }
+        else
+       #endif
+        {
+            processScalar (channels, numChannelsInGroup, s, c, numSections, numSamples);
+        }
+
+        snapStateToZero (s, numStateValues);
+    }
+}
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_MULTICHANNELIIRFILTER_JUCEHEADER__
+#define __JUCE_MULTICHANNELIIRFILTER_JUCEHEADER__
+
+#include "juce_IIRFilter.h"
+
+
+//==============================================================================
+/**
+    A cascade of biquad IIR filters that runs several channels at once.
+
+    Every channel uses the same coefficients, but has its own state. The channels
+    are filtered in groups of up to maxChannelsPerGroup, with each channel in a
+    lane of a SIMD register, so filtering eight channels costs little more than
+    filtering one. Higher-order filters can be built by cascading several
+    sections, each with its own coefficients.
+
+    With single-precision state, each section gives exactly the same results as an
+    IIRFilter with the same coefficients. Double-precision state is slower, but
+    avoids the noise and instability that float state can suffer from with very
+    low cut-off frequencies or long cascades.
+
+    @see IIRFilter, IIRCoefficients, FloatVectorOperations::setInstructionSet
+*/
+class JUCE_API  MultiChannelIIRFilter
+{
+public:
+    //==============================================================================
+    /** Creates a filter for a number of channels and cascaded sections.
+
+        All the sections initially pass their input through unchanged.
+    */
+    MultiChannelIIRFilter (int numChannels = 2,
+                           int numSections = 1,
+                           bool useDoublePrecisionState = false);
+
+    /** Destructor. */
+    ~MultiChannelIIRFilter();
+
+    //==============================================================================
+    /** Changes the number of channels and sections, and the precision of the state.
+
+        If only the number of channels changes, the existing channels keep their
+        state; otherwise the state is cleared, and any new sections pass their input
+        through unchanged. This allocates memory, so don't call it on the audio thread
+        unless you have to.
+    */
+    void setSize (int numChannels, int numSections, bool useDoublePrecisionState);
+
+    /** Returns the number of channels that the filter has state for. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the number of cascaded sections. */
+    int getNumSections() const noexcept                 { return numSections; }
+
+    /** Returns true if the filter's state is kept in double precision. */
+    bool isUsingDoublePrecisionState() const noexcept   { return useDoublePrecision; }
+
+    //==============================================================================
+    /** Sets the coefficients of one of the sections. */
+    void setCoefficients (int sectionIndex, const IIRCoefficients& newCoefficients) noexcept;
+
+    /** Returns the coefficients of one of the sections. */
+    IIRCoefficients getCoefficients (int sectionIndex) const noexcept;
+
+    /** Clears all the channels' state, without changing the coefficients. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Filters a set of channels in-place.
+
+        The channels are matched to the filter's state by their index. Any channels
+        beyond getNumChannels() are left alone.
+    */
+    void processSamples (float* const* channels, int numChannelsToProcess, int numSamples) noexcept;
+
+    /** Filters a section of an AudioSampleBuffer in-place. */
+    void processSamples (AudioSampleBuffer& buffer, int startSample, int numSamples) noexcept;
+
+    //==============================================================================
+    enum
+    {
+        maxChannelsPerGroup = 8     /**< The number of channels that are filtered together. */
+    };
+
+private:
+    //==============================================================================
+    SpinLock processLock;
+    int numChannels, numSections;
+    bool useDoublePrecision;
+    HeapBlock<double> coefficients;
+    HeapBlock<float> floatCoefficients;
+    HeapBlock<char> state;
+
+    int getStateBytesPerGroup() const noexcept;
+    void processGroup (float* const* channels, int numChannelsInGroup, int group, int numSamples) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultiChannelIIRFilter)
+};
+
+
+#endif   // __JUCE_MULTICHANNELIIRFILTER_JUCEHEADER__
@@ -0,0 +1,316 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+namespace SincResamplerHelpers
+{
+    enum
+    {
+        maxExactPhases = 1024,          // the most phases that an exact ratio can use
+        interpolatedPhaseBits = 9,      // other ratios use 512 phases, plus one for interpolating
+        chunkSize = 2048,               // input samples buffered per channel at a time
+        fractionBits = 32
+    };
+
+    const double stopBandAttenuation = 90.0;
+
+    // The zeroth-order modified Bessel function, for the Kaiser window.
+    static double besselI0 (const double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 50; ++k)
+        {
+            const double t = x / (2.0 * k);
+            term *= t * t;
+            sum += term;
+
+            if (term < sum * 1.0e-12)
+                break;
+        }
+
+        return sum;
+    }
+
+    static int64 greatestCommonDivisor (int64 a, int64 b) noexcept
+    {
+        while (b != 0)
+        {
+            const int64 t = a % b;
+            a = b;
+            b = t;
+        }
+
+        return a;
+    }
+
+    static bool isWholeNumber (const double n) noexcept
+    {
+        return n == std::floor (n) && n > 0 && n < 2147483648.0;
+    }
+
+    /*  The taps are summed into eight running totals, which are then added together
+        in a fixed order, so the scalar and SSE versions give identical results.
+    */
+    static forcedinline float dotProduct (const float* const x, const float* const h, const int num) noexcept
+    {
+        float s[8] = { 0 };
+
+        for (int i = 0; i < num; i += 8)
+            for (int j = 0; j < 8; ++j)
+                s[j] += x[i + j] * h[i + j];
+
+        return ((s[0] + s[4]) + (s[2] + s[6])) + ((s[1] + s[5]) + (s[3] + s[7]));
+    }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    static forcedinline float dotProductSSE (const float* const x, const float* const h, const int num) noexcept
+    {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+
+        for (int i = 0; i < num; i += 8)
+        {
+            acc0 = _mm_add_ps (acc0, _mm_mul_ps (_mm_loadu_ps (x + i),     _mm_loadu_ps (h + i)));
+            acc1 = _mm_add_ps (acc1, _mm_mul_ps (_mm_loadu_ps (x + i + 4), _mm_loadu_ps (h + i + 4)));
+        }
+
+        __m128 a = _mm_add_ps (acc0, acc1);
+        a = _mm_add_ps (a, _mm_movehl_ps (a, a));
+        return _mm_cvtss_f32 (_mm_add_ss (a, _mm_shuffle_ps (a, a, 1)));
+    }
+   #endif
+}
+
+//==============================================================================
+SincResampler::SincResampler (const int numChannels_, const double inputSampleRate,
+                              const double outputSampleRate, const int numZeroCrossings)
+    : numChannels (numChannels_), exactRatio (false),
+      phase (0), readPos (0), numBuffered (0)
+{
+    using namespace SincResamplerHelpers;
+
+    jassert (numChannels > 0 && numZeroCrossings > 0);
+    jassert (inputSampleRate > 0 && outputSampleRate > 0);
+
+    // When downsampling, the sinc is stretched to cut off below the output's Nyquist
+    // frequency, so it needs proportionally more taps for the same number of zero-crossings.
+    const double scale = jmin (1.0, outputSampleRate / inputSampleRate);
+    numTaps = ((int) std::ceil (2 * numZeroCrossings / scale) + 7) & ~7;
+
+    if (isWholeNumber (inputSampleRate) && isWholeNumber (outputSampleRate))
+    {
+        const int64 in  = (int64) inputSampleRate;
+        const int64 out = (int64) outputSampleRate;
+        const int64 gcd = greatestCommonDivisor (in, out);
+
+        if (out / gcd <= maxExactPhases)
+        {
+            exactRatio = true;
+            numPhases = (int) (out / gcd);
+            inputStep = in / gcd;
+            outputStep = out / gcd;
+        }
+    }
+
+    if (! exactRatio)
+    {
+        numPhases = 1 << interpolatedPhaseBits;
+        outputStep = ((int64) 1) << fractionBits;
+        inputStep = (int64) (outputStep * (inputSampleRate / outputSampleRate) + 0.5);
+    }
+
+    // Centre the transition band (as wide as a Kaiser window of this length allows for
+    // the stop-band attenuation) just below the lower of the two Nyquist frequencies.
+    const double transitionWidth = (stopBandAttenuation - 7.95) / (14.36 * 2 * numZeroCrossings);
+    createFilterTable (scale * 0.5 * (1.0 - transitionWidth));
+
+    historyLength = numTaps;
+    bufferSize = historyLength + chunkSize;
+    buffers.malloc ((size_t) (numChannels * bufferSize));
+    reset();
+}
+
+SincResampler::~SincResampler()
+{
+}
+
+void SincResampler::createFilterTable (const double cutoff)
+{
+    using namespace SincResamplerHelpers;
+
+    const int numRows = exactRatio ? numPhases : numPhases + 1;
+    const double halfLength = numTaps / 2;
+    const double beta = 0.1102 * (stopBandAttenuation - 8.7);
+    const double windowScale = 1.0 / besselI0 (beta);
+
+    filterTable.malloc ((size_t) (numRows * numTaps));
+    HeapBlock<double> row ((size_t) numTaps);
+
+    for (int p = 0; p < numRows; ++p)
+    {
+        // Tap k is applied to the input sample that's (fraction + halfLength - 1 - k)
+        // samples before the output's position.
+        const double fraction = p / (double) numPhases;
+        double sum = 0;
+
+        for (int k = 0; k < numTaps; ++k)
+        {
+            const double d = fraction + halfLength - 1 - k;
+            const double x = 2.0 * cutoff * d;
+            const double sinc = std::abs (x) < 1.0e-9 ? 1.0 : std::sin (double_Pi * x) / (double_Pi * x);
+            const double w = d / halfLength;
+            const double window = std::abs (w) < 1.0 ? besselI0 (beta * std::sqrt (1.0 - w * w)) * windowScale : 0.0;
+
+            row[k] = sinc * window;
+            sum += row[k];
+        }
+
+        // (normalising each phase separately keeps the DC gain at exactly 1)
+        for (int k = 0; k < numTaps; ++k)
+            filterTable [p * numTaps + k] = (float) (row[k] / sum);
+    }
+}
+
+//==============================================================================
+void SincResampler::reset() noexcept
+{
+    FloatVectorOperations::clear (buffers, numChannels * bufferSize);
+
+    // Start with enough silence before the first sample for it to be at the centre of the filter.
+    numBuffered = numTaps / 2 - 1;
+    readPos = 0;
+    phase = 0;
+}
+
+int SincResampler::getMaxNumOutputSamples (const int numInputSamples) const noexcept
+{
+    return (int) ((numInputSamples + 1) * (double) outputStep / (double) inputStep) + 2;
+}
+
+int SincResampler::process (const float* const* const inputChannels, int numInputSamples,
+                            float* const* const outputChannels) noexcept
+{
+    int numOut = 0;
+    int inputPos = 0;
+
+    while (numInputSamples > 0)
+    {
+        // drop the samples that no output needs any more
+        const int numToDiscard = jmin (readPos, numBuffered);
+
+        if (numToDiscard > 0)
+        {
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                float* const buffer = buffers + chan * bufferSize;
+                memmove (buffer, buffer + numToDiscard, sizeof (float) * (size_t) (numBuffered - numToDiscard));
+            }
+
+            readPos -= numToDiscard;
+            numBuffered -= numToDiscard;
+        }
+
+        const int numToCopy = jmin (numInputSamples, bufferSize - numBuffered);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+            FloatVectorOperations::copy (buffers + chan * bufferSize + numBuffered,
+                                         inputChannels[chan] + inputPos, numToCopy);
+
+        numBuffered += numToCopy;
+        inputPos += numToCopy;
+        numInputSamples -= numToCopy;
+
+        numOut += produceOutput (outputChannels, numOut);
+    }
+
+    return numOut;
+}
+
+int SincResampler::produceOutput (float* const* const outputChannels, const int outputOffset) noexcept
+{
+    using namespace SincResamplerHelpers;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const bool useSSE = FloatVectorOperations::getInstructionSet() != FloatVectorOperations::scalarInstructions;
+    #define JUCE_SINC_DOT_PRODUCT(x, h)  (useSSE ? dotProductSSE (x, h, numTaps) : dotProduct (x, h, numTaps))
+   #else
+    #define JUCE_SINC_DOT_PRODUCT(x, h)  dotProduct (x, h, numTaps)
+   #endif
+
+    int num = 0;
+
+    if (exactRatio)
+    {
+        // (splitting the step up front avoids a 64-bit division per output sample)
+        const int wholeStep = (int) (inputStep / outputStep);
+        const int64 fractionStep = inputStep % outputStep;
+
+        while (readPos + numTaps <= numBuffered)
+        {
+            const float* const h = filterTable + (int) phase * numTaps;
+
+            for (int chan = 0; chan < numChannels; ++chan)
+                outputChannels[chan][outputOffset + num] = JUCE_SINC_DOT_PRODUCT (buffers + chan * bufferSize + readPos, h);
+
+            ++num;
+            readPos += wholeStep;
+            phase += fractionStep;
+
+            if (phase >= outputStep)
+            {
+                phase -= outputStep;
+                ++readPos;
+            }
+        }
+    }
+    else
+    {
+        const int rowShift = fractionBits - interpolatedPhaseBits;
+        const float alphaScale = 1.0f / (float) (1 << rowShift);
+
+        while (readPos + numTaps <= numBuffered)
+        {
+            const float* const h0 = filterTable + (int) (phase >> rowShift) * numTaps;
+            const float* const h1 = h0 + numTaps;
+            const float alpha = (float) (phase & ((1 << rowShift) - 1)) * alphaScale;
+
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                const float* const x = buffers + chan * bufferSize + readPos;
+                const float y0 = JUCE_SINC_DOT_PRODUCT (x, h0);
+                const float y1 = JUCE_SINC_DOT_PRODUCT (x, h1);
+                outputChannels[chan][outputOffset + num] = y0 + alpha * (y1 - y0);
+            }
+
+            ++num;
+            phase += inputStep;
+            readPos += (int) (phase >> fractionBits);
+            phase &= (((int64) 1) << fractionBits) - 1;
+        }
+    }
+
+    #undef JUCE_SINC_DOT_PRODUCT
+    return num;
+}
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_SINCRESAMPLER_JUCEHEADER__
+#define __JUCE_SINCRESAMPLER_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A high-quality sample-rate converter, using a polyphase windowed-sinc filter.
+
+    This is much slower than a LagrangeInterpolator or a ResamplingAudioSource,
+    but keeps aliasing and imaging far below the noise floor of a 16-bit signal,
+    so it's meant for offline conversions where quality matters more than speed.
+
+    When the two sample rates are whole numbers whose ratio reduces to a fraction
+    with a small enough numerator (e.g. 44100 -> 48000 is 160/147, and 44100 ->
+    96000 is 320/147), every output sample lands exactly on one of the filter's
+    precomputed phases, and its position is tracked with integer arithmetic, so
+    there's no drift however long the stream. Other ratios interpolate between
+    the two nearest of a fixed set of phases.
+
+    It's a streaming converter: you push blocks of input of any size through
+    process(), and it returns however many output samples those blocks complete.
+    Output sample n is aligned with the input at time n * inputRate / outputRate,
+    but can't be produced until getLookahead() input samples beyond that point
+    have arrived - so to flush the end of a stream, push that many zeros.
+
+    @see LagrangeInterpolator, ResamplingAudioSource
+*/
+class JUCE_API  SincResampler
+{
+public:
+    //==============================================================================
+    /** Creates a resampler.
+
+        @param numChannels          the number of channels that will be processed together
+        @param inputSampleRate      the rate of the samples that will be pushed in
+        @param outputSampleRate     the rate of the samples that will come out
+        @param numZeroCrossings     the number of zero-crossings of the sinc on each side
+                                    of its centre. The stop-band is always about 90dB
+                                    down; more zero-crossings make the transition band
+                                    narrower, and take longer. With 32, the pass-band
+                                    is flat up to about 82% of the lower of the two
+                                    Nyquist frequencies.
+    */
+    SincResampler (int numChannels,
+                   double inputSampleRate,
+                   double outputSampleRate,
+                   int numZeroCrossings = 32);
+
+    /** Destructor. */
+    ~SincResampler();
+
+    //==============================================================================
+    /** Clears the input history, ready for a new stream. */
+    void reset() noexcept;
+
+    /** Pushes a block of input samples through the resampler.
+
+        All the input is used, so the output buffers must have space for at least
+        getMaxNumOutputSamples (numInputSamples) samples.
+
+        @returns the number of output samples that were written
+    */
+    int process (const float* const* inputChannels, int numInputSamples,
+                 float* const* outputChannels) noexcept;
+
+    /** Returns the largest number of output samples that process() could produce
+        from a given number of input samples.
+    */
+    int getMaxNumOutputSamples (int numInputSamples) const noexcept;
+
+    //==============================================================================
+    /** Returns the number of input samples that have to arrive after an output
+        sample's position before it can be produced.
+    */
+    int getLookahead() const noexcept                   { return numTaps / 2; }
+
+    /** Returns the length of the filter, in input samples. */
+    int getNumTaps() const noexcept                     { return numTaps; }
+
+    /** Returns true if the ratio of the sample rates is an exact fraction whose phases
+        are all in the table, so no interpolation between phases is needed.
+    */
+    bool isUsingExactRatio() const noexcept             { return exactRatio; }
+
+    /** Returns the number of channels that this resampler was created for. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+private:
+    //==============================================================================
+    const int numChannels;
+    int numTaps, numPhases, historyLength, bufferSize;
+    bool exactRatio;
+    HeapBlock<float> filterTable, buffers;
+
+    // For exact ratios, the position advances by inputStep / outputStep input samples
+    // per output; otherwise it's a 32.32 fixed-point fraction.
+    int64 inputStep, outputStep;
+    int64 phase;
+    int readPos, numBuffered;
+
+    void createFilterTable (double cutoff);
+    int produceOutput (float* const* outputChannels, int outputOffset) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SincResampler)
+};
+
+
+#endif   // __JUCE_SINCRESAMPLER_JUCEHEADER__
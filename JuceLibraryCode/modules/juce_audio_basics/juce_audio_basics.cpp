@@ -49,6 +49,25 @@
  #include <emmintrin.h>
 #endif
 
+// AVX2 code is compiled into functions of its own, and only called if the CPU has it,
+// so the rest of the module doesn't need building for AVX2.
+#ifndef JUCE_USE_AVX2_INTRINSICS
+ #if JUCE_USE_SSE_INTRINSICS && ((JUCE_MSVC && _MSC_VER >= 1700) \
+                                   || (JUCE_CLANG && defined (__apple_build_version__) && __apple_build_version__ >= 8000000) \
+                                   || (JUCE_CLANG && ! defined (__apple_build_version__) && (__clang_major__ * 100 + __clang_minor__) >= 308) \
+                                   || (JUCE_GCC && ! JUCE_CLANG && (__GNUC__ * 100 + __GNUC_MINOR__) >= 409))
+  #define JUCE_USE_AVX2_INTRINSICS 1
+ #endif
+#endif
+
+#if ! JUCE_USE_SSE_INTRINSICS
+ #undef JUCE_USE_AVX2_INTRINSICS
+#endif
+
+#if JUCE_USE_AVX2_INTRINSICS
+ #include <immintrin.h>
+#endif
+
 #if JUCE_MAC || JUCE_IOS
  #define JUCE_USE_VDSP_FRAMEWORK 1
  #include <Accelerate/Accelerate.h>
@@ -63,6 +82,8 @@ namespace juce
 #include "buffers/juce_FloatVectorOperations.cpp"
 #include "effects/juce_IIRFilter.cpp"
 #include "effects/juce_LagrangeInterpolator.cpp"
+#include "effects/juce_MultiChannelIIRFilter.cpp"
+#include "effects/juce_SincResampler.cpp"
 #include "midi/juce_MidiBuffer.cpp"
 #include "midi/juce_MidiFile.cpp"
 #include "midi/juce_MidiKeyboardState.cpp"
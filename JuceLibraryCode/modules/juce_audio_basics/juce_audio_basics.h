@@ -51,9 +51,15 @@ namespace juce
 #ifndef __JUCE_LAGRANGEINTERPOLATOR_JUCEHEADER__
  #include "effects/juce_LagrangeInterpolator.h"
 #endif
+#ifndef __JUCE_MULTICHANNELIIRFILTER_JUCEHEADER__
+ #include "effects/juce_MultiChannelIIRFilter.h"
+#endif
 #ifndef __JUCE_REVERB_JUCEHEADER__
  #include "effects/juce_Reverb.h"
 #endif
+#ifndef __JUCE_SINCRESAMPLER_JUCEHEADER__
+ #include "effects/juce_SincResampler.h"
+#endif
 #ifndef __JUCE_MIDIBUFFER_JUCEHEADER__
  #include "midi/juce_MidiBuffer.h"
 #endif
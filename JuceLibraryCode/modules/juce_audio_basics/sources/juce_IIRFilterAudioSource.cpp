@@ -25,12 +25,10 @@
 
 IIRFilterAudioSource::IIRFilterAudioSource (AudioSource* const inputSource,
                                             const bool deleteInputWhenDeleted)
-    : input (inputSource, deleteInputWhenDeleted)
+    : input (inputSource, deleteInputWhenDeleted),
+      filter (2)
 {
     jassert (inputSource != nullptr);
-
-    for (int i = 2; --i >= 0;)
-        iirFilters.add (new IIRFilter());
 }
 
 IIRFilterAudioSource::~IIRFilterAudioSource()  {}
@@ -38,8 +36,7 @@ IIRFilterAudioSource::~IIRFilterAudioSource()  {}
 //==============================================================================
 void IIRFilterAudioSource::setFilterParameters (const IIRFilter& newSettings)
 {
-    for (int i = iirFilters.size(); --i >= 0;)
-        iirFilters.getUnchecked(i)->copyCoefficientsFrom (newSettings);
+    filter.setCoefficients (0, newSettings.getCoefficients());
 }
 
 //==============================================================================
@@ -47,8 +44,7 @@ void IIRFilterAudioSource::prepareToPlay (int samplesPerBlockExpected, double sa
 {
     input->prepareToPlay (samplesPerBlockExpected, sampleRate);
 
-    for (int i = iirFilters.size(); --i >= 0;)
-        iirFilters.getUnchecked(i)->reset();
+    filter.reset();
 }
 
 void IIRFilterAudioSource::releaseResources()
@@ -62,11 +58,8 @@ void IIRFilterAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& buff
 
     const int numChannels = bufferToFill.buffer->getNumChannels();
 
-    while (numChannels > iirFilters.size())
-        iirFilters.add (new IIRFilter (*iirFilters.getUnchecked (0)));
+    if (numChannels > filter.getNumChannels())
+        filter.setSize (numChannels, 1, false);
 
-    for (int i = 0; i < numChannels; ++i)
-        iirFilters.getUnchecked(i)
-            ->processSamples (bufferToFill.buffer->getSampleData (i, bufferToFill.startSample),
-                              bufferToFill.numSamples);
+    filter.processSamples (*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
 }
@@ -27,7 +27,7 @@
 #define __JUCE_IIRFILTERAUDIOSOURCE_JUCEHEADER__
 
 #include "juce_AudioSource.h"
-#include "../effects/juce_IIRFilter.h"
+#include "../effects/juce_MultiChannelIIRFilter.h"
 
 
 //==============================================================================
@@ -62,7 +62,7 @@ public:
 private:
     //==============================================================================
     OptionalScopedPointer<AudioSource> input;
-    OwnedArray <IIRFilter> iirFilters;
+    MultiChannelIIRFilter filter;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IIRFilterAudioSource)
 };
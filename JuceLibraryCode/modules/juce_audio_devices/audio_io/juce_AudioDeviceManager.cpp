@@ -97,7 +97,10 @@ AudioDeviceManager::AudioDeviceManager()
       inputLevel (0),
       tempBuffer (2, 2),
       cpuUsageMs (0),
-      timeToCpuScale (0)
+      timeToCpuScale (0),
+      lastXRunCount (0),
+      realtimePriority (0),
+      useRoundRobinScheduling (false)
 {
     callbackHandler = new CallbackHandler (*this);
 }
@@ -452,6 +455,9 @@ String AudioDeviceManager::setAudioDeviceSetup (const AudioDeviceSetup& newSetup
 
         currentAudioDevice = type->createDevice (newOutputDeviceName, newInputDeviceName);
 
+        if (currentAudioDevice != nullptr)
+            currentAudioDevice->setRealtimePriority (realtimePriority, useRoundRobinScheduling);
+
         if (currentAudioDevice == nullptr)
             error = "Can't open the audio device!\n\n"
                     "This may be because another application is currently using the same device - "
@@ -673,6 +679,7 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
                                                    int numSamples)
 {
     const ScopedLock sl (audioCallbackLock);
+    const int64 callbackStartTicks = Time::getHighResolutionTicks();
 
     if (inputLevelMeasurementEnabledCount.get() > 0 && numInputChannels > 0)
     {
@@ -748,14 +755,28 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
         if (testSoundPosition >= testSound->getNumSamples())
             testSound = nullptr;
     }
+
+    if (currentAudioDevice != nullptr)
+    {
+        const int xrunCount = currentAudioDevice->getXRunCount();
+
+        if (xrunCount > lastXRunCount)
+            telemetry.addXRuns (callbackStartTicks, xrunCount - lastXRunCount);
+
+        lastXRunCount = xrunCount;
+    }
+
+    telemetry.addCallback (callbackStartTicks, Time::getHighResolutionTicks(), numSamples);
 }
 
 void AudioDeviceManager::audioDeviceAboutToStartInt (AudioIODevice* const device)
 {
     cpuUsageMs = 0;
+    lastXRunCount = jmax (0, device->getXRunCount());
 
     const double sampleRate = device->getCurrentSampleRate();
     const int blockSize = device->getCurrentBufferSizeSamples();
+    telemetry.prepare (sampleRate);
 
     if (sampleRate > 0.0 && blockSize > 0)
     {
@@ -795,6 +816,19 @@ double AudioDeviceManager::getCpuUsage() const
     return jlimit (0.0, 1.0, timeToCpuScale * cpuUsageMs);
 }
 
+int AudioDeviceManager::getXRunCount() const
+{
+    return currentAudioDevice != nullptr ? currentAudioDevice->getXRunCount() : -1;
+}
+
+bool AudioDeviceManager::setRealtimeScheduling (const int priority, const bool useRoundRobin, const bool lockMemory)
+{
+    realtimePriority = jlimit (0, 99, priority);
+    useRoundRobinScheduling = useRoundRobin;
+
+    return ! lockMemory || Process::lockMemory();
+}
+
 //==============================================================================
 void AudioDeviceManager::setMidiInputEnabled (const String& name, const bool enabled)
 {
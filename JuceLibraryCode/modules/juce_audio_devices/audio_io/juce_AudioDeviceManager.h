@@ -27,6 +27,7 @@
 #define __JUCE_AUDIODEVICEMANAGER_JUCEHEADER__
 
 #include "juce_AudioIODeviceType.h"
+#include "juce_AudioDeviceTelemetry.h"
 #include "../midi_io/juce_MidiInput.h"
 #include "../midi_io/juce_MidiOutput.h"
 
@@ -304,10 +305,37 @@ public:
     //==============================================================================
     /** Returns the average proportion of available CPU being spent inside the audio callbacks.
 
-        Returns a value between 0 and 1.0
+        Returns a value between 0 and 1.0. Because this is a smoothed average, it
+        won't show the occasional slow callback - use getTelemetry() for that.
     */
     double getCpuUsage() const;
 
+    //==============================================================================
+    /** Returns the record of the audio callbacks' timings, and of the current
+        device's xruns.
+
+        Events are added on the audio thread; one thread at a time can read them
+        back out with AudioDeviceTelemetry::readEvents(). Its statistics (the load
+        histogram, deadline misses, jitter, etc) can be read from any thread, and
+        are reset whenever a device starts.
+    */
+    AudioDeviceTelemetry& getTelemetry() noexcept           { return telemetry; }
+
+    /** Returns the number of xruns that the current device has had since it was
+        opened, or -1 if it can't detect them.
+    */
+    int getXRunCount() const;
+
+    /** Asks the audio devices to run their audio threads with realtime scheduling.
+
+        The priority is from 1 to 99, or 0 to leave the scheduling alone, and is
+        passed to each device that gets opened from now on (see
+        AudioIODevice::setRealtimePriority()). If lockMemory is true, the whole
+        process's memory is locked into RAM straight away (see Process::lockMemory()),
+        and this returns false if that fails.
+    */
+    bool setRealtimeScheduling (int priority, bool useRoundRobin, bool lockMemory);
+
     //==============================================================================
     /** Enables or disables a midi input device.
 
@@ -475,6 +503,9 @@ private:
     CriticalSection audioCallbackLock, midiCallbackLock;
 
     double cpuUsageMs, timeToCpuScale;
+    AudioDeviceTelemetry telemetry;
+    int lastXRunCount, realtimePriority;
+    bool useRoundRobinScheduling;
 
     //==============================================================================
     class CallbackHandler;
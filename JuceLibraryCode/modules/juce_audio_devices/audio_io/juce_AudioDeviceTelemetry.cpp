@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+AudioDeviceTelemetry::AudioDeviceTelemetry (const int capacity)
+    : fifo (capacity),
+      events ((size_t) capacity),
+      ticksPerSample (0),
+      ticksPerWindowBucket (jmax ((int64) 1, Time::getHighResolutionTicksPerSecond() / windowBucketsPerSecond)),
+      lastCallbackStartTicks (0),
+      lastCallbackDeadlineTicks (0)
+{
+    clearStatistics();
+}
+
+AudioDeviceTelemetry::~AudioDeviceTelemetry()
+{
+}
+
+void AudioDeviceTelemetry::prepare (const double sampleRate) noexcept
+{
+    ticksPerSample = sampleRate > 0 ? Time::getHighResolutionTicksPerSecond() / sampleRate : 0.0;
+    resetStatistics();
+}
+
+void AudioDeviceTelemetry::resetStatistics() noexcept
+{
+    resetPending = 1;
+}
+
+void AudioDeviceTelemetry::addCallback (const int64 startTicks, const int64 endTicks, const int numSamples) noexcept
+{
+    const Event e = { Event::callback, startTicks, endTicks - startTicks, numSamples };
+
+    if (resetPending.compareAndSetBool (0, 1))
+        clearStatistics();
+
+    ++numCallbacks;
+    updateStatistics (e);
+    addEvent (e);
+}
+
+void AudioDeviceTelemetry::addXRuns (const int64 timeTicks, const int numNewXRuns) noexcept
+{
+    const Event e = { Event::xrun, timeTicks, 0, numNewXRuns };
+
+    if (resetPending.compareAndSetBool (0, 1))
+        clearStatistics();
+
+    numXRuns += numNewXRuns;
+    addEvent (e);
+}
+
+//==============================================================================
+// (only the audio thread writes any of the statistics, so they can't change under it)
+void AudioDeviceTelemetry::updateStatistics (const Event& e) noexcept
+{
+    if (e.durationTicks > maxCallbackTicks.get())
+        maxCallbackTicks = e.durationTicks;
+
+    const int64 bucket = e.timeTicks / ticksPerWindowBucket;
+    const int slot = (int) (bucket % numWindowBuckets);
+
+    if (windowBucketIndex [slot].get() != bucket)
+    {
+        windowBucketMax [slot] = e.durationTicks;
+        windowBucketIndex [slot] = bucket;
+    }
+    else if (e.durationTicks > windowBucketMax [slot].get())
+    {
+        windowBucketMax [slot] = e.durationTicks;
+    }
+
+    if (ticksPerSample > 0)
+    {
+        const int64 deadlineTicks = (int64) (e.numSamples * ticksPerSample);
+
+        if (deadlineTicks > 0)
+        {
+            if (e.durationTicks > deadlineTicks)
+                ++numDeadlineMisses;
+
+            const int bin = (int) ((100 / histogramBinPercent) * e.durationTicks / deadlineTicks);
+            ++histogram [jmin (bin, (int) numHistogramBins - 1)];
+        }
+
+        if (lastCallbackDeadlineTicks > 0)
+        {
+            const int64 jitter = std::abs ((e.timeTicks - lastCallbackStartTicks) - lastCallbackDeadlineTicks);
+
+            totalJitterTicks += jitter;
+            ++numJitterMeasurements;
+
+            if (jitter > maxJitterTicks.get())
+                maxJitterTicks = jitter;
+        }
+
+        lastCallbackStartTicks = e.timeTicks;
+        lastCallbackDeadlineTicks = deadlineTicks;
+    }
+}
+
+void AudioDeviceTelemetry::clearStatistics() noexcept
+{
+    numCallbacks = 0;
+    numXRuns = 0;
+    numDeadlineMisses = 0;
+    maxCallbackTicks = 0;
+    maxJitterTicks = 0;
+    totalJitterTicks = 0;
+    numJitterMeasurements = 0;
+    lastCallbackStartTicks = 0;
+    lastCallbackDeadlineTicks = 0;
+
+    for (int i = 0; i < numHistogramBins; ++i)
+        histogram[i] = 0;
+
+    for (int i = 0; i < numWindowBuckets; ++i)
+    {
+        windowBucketMax[i] = 0;
+        windowBucketIndex[i] = -1;
+    }
+}
+
+int64 AudioDeviceTelemetry::getMaxCallbackTicksInWindow (const double windowSeconds) const noexcept
+{
+    const int numBuckets = jlimit (1, (int) numWindowBuckets, (int) std::ceil (windowSeconds * windowBucketsPerSecond));
+    const int64 oldestBucket = Time::getHighResolutionTicks() / ticksPerWindowBucket - numBuckets;
+    int64 maxTicks = 0;
+
+    for (int i = 0; i < numWindowBuckets; ++i)
+        if (windowBucketIndex[i].get() > oldestBucket)
+            maxTicks = jmax (maxTicks, windowBucketMax[i].get());
+
+    return maxTicks;
+}
+
+double AudioDeviceTelemetry::getMaxJitterSeconds() const noexcept
+{
+    return Time::highResolutionTicksToSeconds (maxJitterTicks.get());
+}
+
+double AudioDeviceTelemetry::getMeanJitterSeconds() const noexcept
+{
+    const int num = numJitterMeasurements.get();
+    return num > 0 ? Time::highResolutionTicksToSeconds (totalJitterTicks.get()) / num : 0.0;
+}
+
+int AudioDeviceTelemetry::getHistogramCount (const int bin) const noexcept
+{
+    return isPositiveAndBelow (bin, (int) numHistogramBins) ? histogram[bin].get() : 0;
+}
+
+//==============================================================================
+String AudioDeviceTelemetry::createStatisticsReport() const
+{
+    DynamicObject* const report = new DynamicObject();
+    var result (report);
+
+    report->setProperty ("callbacks", getNumCallbacks());
+    report->setProperty ("xruns", getNumXRuns());
+    report->setProperty ("droppedEvents", getNumDroppedEvents());
+    report->setProperty ("deadlineMisses", getNumDeadlineMisses());
+    report->setProperty ("maxCallbackSeconds", Time::highResolutionTicksToSeconds (getMaxCallbackTicks()));
+    report->setProperty ("maxCallbackSecondsInLastSecond", Time::highResolutionTicksToSeconds (getMaxCallbackTicksInWindow (1.0)));
+    report->setProperty ("maxJitterSeconds", getMaxJitterSeconds());
+    report->setProperty ("meanJitterSeconds", getMeanJitterSeconds());
+    report->setProperty ("histogramBinPercent", (int) histogramBinPercent);
+
+    var bins;
+    for (int i = 0; i < numHistogramBins; ++i)
+        bins.append (getHistogramCount (i));
+
+    report->setProperty ("loadHistogram", bins);
+    return JSON::toString (result);
+}
+
+bool AudioDeviceTelemetry::writeStatisticsToFile (const File& file) const
+{
+    return file.replaceWithText (createStatisticsReport());
+}
+
+void AudioDeviceTelemetry::addEvent (const Event& e) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+    {
+        events [start1] = e;
+        fifo.finishedWrite (1);
+    }
+    else
+    {
+        ++numDroppedEvents;
+    }
+}
+
+int AudioDeviceTelemetry::readEvents (Event* const dest, const int maxEvents) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (maxEvents, start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        dest [i] = events [start1 + i];
+
+    for (int i = 0; i < size2; ++i)
+        dest [size1 + i] = events [start2 + i];
+
+    fifo.finishedRead (size1 + size2);
+    return size1 + size2;
+}
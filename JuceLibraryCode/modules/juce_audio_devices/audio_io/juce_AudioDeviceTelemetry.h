@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-11 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_AUDIODEVICETELEMETRY_JUCEHEADER__
+#define __JUCE_AUDIODEVICETELEMETRY_JUCEHEADER__
+
+
+//==============================================================================
+/**
+    A lock-free record of an audio device's callbacks and xruns.
+
+    The audio thread adds events as they happen, and one other thread at a time
+    can take them out again with readEvents(). Nothing here allocates or locks, so
+    the audio thread never waits for the reader - if the reader falls behind and the
+    ring fills up, new events are dropped and counted instead.
+
+    Alongside the ring it keeps running statistics that any thread can query at any
+    time: a histogram of each callback's load (its duration as a proportion of the
+    time the block's samples last), the longest callback over a recent window, the
+    number of callbacks that missed their deadline, and the jitter between the
+    callbacks' start times. These need to know the sample rate, so call prepare()
+    before the device starts.
+
+    The AudioDeviceManager keeps one of these for its current device.
+
+    @see AudioDeviceManager::getTelemetry
+*/
+class JUCE_API  AudioDeviceTelemetry
+{
+public:
+    //==============================================================================
+    /** Creates a telemetry ring with space for the given number of unread events. */
+    explicit AudioDeviceTelemetry (int capacity = 4096);
+
+    /** Destructor. */
+    ~AudioDeviceTelemetry();
+
+    //==============================================================================
+    /** Something that happened on the audio thread. */
+    struct Event
+    {
+        enum Type
+        {
+            callback,   /**< An audio callback, and how long it took. */
+            xrun        /**< The device reported one or more under- or over-runs. */
+        };
+
+        Type type;
+        int64 timeTicks;        /**< When it happened, from Time::getHighResolutionTicks(). */
+        int64 durationTicks;    /**< How long a callback took, or 0 for an xrun. */
+        int numSamples;         /**< The callback's block size, or the number of xruns. */
+    };
+
+    //==============================================================================
+    /** Records a callback. Realtime-safe; only call this from the audio thread. */
+    void addCallback (int64 startTicks, int64 endTicks, int numSamples) noexcept;
+
+    /** Records xruns that the device has reported. Realtime-safe; only call this
+        from the audio thread.
+    */
+    void addXRuns (int64 timeTicks, int numXRuns) noexcept;
+
+    /** Moves up to maxEvents of the oldest events into dest, returning the number
+        that were read. Only call this from one thread at a time.
+    */
+    int readEvents (Event* dest, int maxEvents) noexcept;
+
+    //==============================================================================
+    /** Sets the sample rate that the callbacks' deadlines are worked out from, and
+        resets the statistics.
+
+        Call this before the callbacks start. If the sample rate is 0, only the
+        durations of the callbacks are tracked.
+    */
+    void prepare (double sampleRate) noexcept;
+
+    /** Clears the statistics and the callback and xrun counts (but not the unread
+        events, or the count of dropped ones).
+
+        This can be called from any thread: the audio thread does the actual
+        clearing at the start of its next callback.
+    */
+    void resetStatistics() noexcept;
+
+    //==============================================================================
+    /** Returns the number of callbacks recorded, including any that were dropped. */
+    int getNumCallbacks() const noexcept            { return numCallbacks.get(); }
+
+    /** Returns the number of xruns recorded, including any that were dropped. */
+    int getNumXRuns() const noexcept                { return numXRuns.get(); }
+
+    /** Returns the number of events that didn't fit in the ring. */
+    int getNumDroppedEvents() const noexcept        { return numDroppedEvents.get(); }
+
+    /** Returns the longest callback recorded, in high-resolution ticks. */
+    int64 getMaxCallbackTicks() const noexcept      { return maxCallbackTicks.get(); }
+
+    /** Returns the longest callback that started within the last few seconds, in
+        high-resolution ticks.
+
+        The window is rounded up to a multiple of 1/16 of a second, and can't be
+        longer than maxWindowSeconds.
+    */
+    int64 getMaxCallbackTicksInWindow (double windowSeconds) const noexcept;
+
+    /** Returns the number of callbacks that took longer than their block of samples lasts. */
+    int getNumDeadlineMisses() const noexcept       { return numDeadlineMisses.get(); }
+
+    /** Returns the largest difference, in seconds, between the time from one callback
+        to the next and the time that the first callback's block lasts.
+    */
+    double getMaxJitterSeconds() const noexcept;
+
+    /** Returns the average difference, in seconds, between the time from one callback
+        to the next and the time that the first callback's block lasts.
+    */
+    double getMeanJitterSeconds() const noexcept;
+
+    //==============================================================================
+    enum
+    {
+        numHistogramBins = 41,      /**< The number of bins in the load histogram. */
+        histogramBinPercent = 5,    /**< The width of each bin, as a percentage of the deadline. */
+        maxWindowSeconds = 4        /**< The longest window that getMaxCallbackTicksInWindow() can cover. */
+    };
+
+    /** Returns the number of callbacks whose load fell into one of the histogram's bins.
+
+        Bin n counts the callbacks that used from n * histogramBinPercent up to
+        (n + 1) * histogramBinPercent percent of their deadline, except for the last
+        bin, which counts everything from 200% upwards.
+    */
+    int getHistogramCount (int bin) const noexcept;
+
+    //==============================================================================
+    /** Returns the statistics as a JSON object, for logging or alerting. */
+    String createStatisticsReport() const;
+
+    /** Writes createStatisticsReport() to a file, replacing its contents. */
+    bool writeStatisticsToFile (const File& file) const;
+
+private:
+    //==============================================================================
+    enum { windowBucketsPerSecond = 16, numWindowBuckets = maxWindowSeconds * windowBucketsPerSecond };
+
+    AbstractFifo fifo;
+    HeapBlock<Event> events;
+    Atomic<int> numCallbacks, numXRuns, numDroppedEvents, numDeadlineMisses;
+    Atomic<int64> maxCallbackTicks;
+
+    double ticksPerSample;
+    const int64 ticksPerWindowBucket;
+    Atomic<int> resetPending, histogram [numHistogramBins], numJitterMeasurements;
+    Atomic<int64> windowBucketMax [numWindowBuckets], windowBucketIndex [numWindowBuckets];
+    Atomic<int64> maxJitterTicks, totalJitterTicks;
+    int64 lastCallbackStartTicks, lastCallbackDeadlineTicks;
+
+    void addEvent (const Event&) noexcept;
+    void updateStatistics (const Event&) noexcept;
+    void clearStatistics() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioDeviceTelemetry)
+};
+
+
+#endif   // __JUCE_AUDIODEVICETELEMETRY_JUCEHEADER__
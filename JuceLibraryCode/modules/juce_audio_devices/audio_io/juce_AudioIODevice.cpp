@@ -33,6 +33,27 @@ AudioIODevice::~AudioIODevice()
 {
 }
 
+Range<int> AudioIODevice::getOutputLatencyRange()
+{
+    const int latency = getOutputLatencyInSamples();
+    return Range<int> (latency, latency);
+}
+
+Range<int> AudioIODevice::getInputLatencyRange()
+{
+    const int latency = getInputLatencyInSamples();
+    return Range<int> (latency, latency);
+}
+
+int AudioIODevice::getXRunCount() const noexcept
+{
+    return -1;
+}
+
+void AudioIODevice::setRealtimePriority (int, bool)
+{
+}
+
 bool AudioIODevice::hasControlPanel() const
 {
     return false;
@@ -303,6 +303,37 @@ public:
     */
     virtual int getInputLatencyInSamples() = 0;
 
+    /** Returns the shortest and longest output latency that the device reports, in samples.
+
+        Some back-ends (e.g. JACK) know that the path to the hardware can take a range of
+        times depending on how the ports are routed. Devices that only know a single figure
+        return an empty range starting at getOutputLatencyInSamples().
+    */
+    virtual Range<int> getOutputLatencyRange();
+
+    /** Returns the shortest and longest input latency that the device reports, in samples.
+        @see getOutputLatencyRange
+    */
+    virtual Range<int> getInputLatencyRange();
+
+    /** Returns the number of buffer under- or over-runs that the device has had
+        since it was opened, or -1 if it can't detect them.
+
+        This may be called from the audio thread.
+    */
+    virtual int getXRunCount() const noexcept;
+
+    //==============================================================================
+    /** Asks the device to run its audio thread with realtime scheduling.
+
+        The priority is from 1 to 99, or 0 to leave the thread's scheduling alone.
+        Only devices that run their own audio thread take any notice of this, and
+        it takes effect the next time the device is opened.
+
+        @see Thread::setCurrentThreadRealtimePriority
+    */
+    virtual void setRealtimePriority (int priority, bool useRoundRobin);
+
 
     //==============================================================================
     /** True if this device can show a pop-up control panel for editing its settings.
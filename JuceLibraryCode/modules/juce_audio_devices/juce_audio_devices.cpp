@@ -135,6 +135,7 @@ namespace juce
 
 // START_AUTOINCLUDE audio_io/*.cpp, midi_io/*.cpp, audio_cd/*.cpp, sources/*.cpp
 #include "audio_io/juce_AudioDeviceManager.cpp"
+#include "audio_io/juce_AudioDeviceTelemetry.cpp"
 #include "audio_io/juce_AudioIODevice.cpp"
 #include "audio_io/juce_AudioIODeviceType.cpp"
 #include "midi_io/juce_MidiMessageCollector.cpp"
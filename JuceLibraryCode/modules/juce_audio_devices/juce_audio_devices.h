@@ -64,6 +64,16 @@
  #define JUCE_ALSA 1
 #endif
 
+/** Config: JUCE_ALSA_MMAP
+    Makes ALSA devices use mmap access where the hardware supports it, converting
+    straight into and out of the device's ring buffer. Devices that can't be mapped
+    fall back to read/write access.
+    This is off by default, as the mmap path hasn't been tried on enough hardware yet.
+*/
+#ifndef JUCE_ALSA_MMAP
+ #define JUCE_ALSA_MMAP 0
+#endif
+
 /** Config: JUCE_JACK
     Enables JACK audio devices (Linux only).
 */
@@ -105,6 +115,9 @@ namespace juce
 #ifndef __JUCE_AUDIODEVICEMANAGER_JUCEHEADER__
  #include "audio_io/juce_AudioDeviceManager.h"
 #endif
+#ifndef __JUCE_AUDIODEVICETELEMETRY_JUCEHEADER__
+ #include "audio_io/juce_AudioDeviceTelemetry.h"
+#endif
 #ifndef __JUCE_AUDIOIODEVICE_JUCEHEADER__
  #include "audio_io/juce_AudioIODevice.h"
 #endif
@@ -117,8 +117,13 @@ public:
           bitDepth (16),
           numChannelsRunning (0),
           latency (0),
+          periodSize (0),
           isInput (forInput),
-          isInterleaved (true)
+          ringSize (0),
+          inXRun (false),
+          isInterleaved (true),
+          isMapped (false),
+          sampleFormat (AudioDataConverters::int16LE)
     {
         failed (snd_pcm_open (&handle, deviceID.toUTF8(),
                               forInput ? SND_PCM_STREAM_CAPTURE : SND_PCM_STREAM_PLAYBACK,
@@ -142,6 +147,21 @@ public:
         if (failed (snd_pcm_hw_params_any (handle, hwParams)))
             return false;
 
+        isMapped = false;
+
+       #if JUCE_ALSA_MMAP
+        if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_MMAP_INTERLEAVED) >= 0)
+        {
+            isMapped = true;
+            isInterleaved = true;
+        }
+        else if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_MMAP_NONINTERLEAVED) >= 0)
+        {
+            isMapped = true;
+            isInterleaved = false;
+        }
+        else
+       #endif
         if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_NONINTERLEAVED) >= 0)
             isInterleaved = false;
         else if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED) >= 0)
@@ -172,6 +192,7 @@ public:
                 const bool isFloat = (formatsToTry [i + 1] & isFloatBit) != 0;
                 const bool isLittleEndian = (formatsToTry [i + 1] & isLittleEndianBit) != 0;
                 converter = createConverter (isInput, bitDepth, isFloat, isLittleEndian, numChannels);
+                sampleFormat = getDataFormat (bitDepth, isFloat, isLittleEndian);
                 break;
             }
         }
@@ -200,9 +221,20 @@ public:
 
         if (failed (snd_pcm_hw_params_get_period_size (hwParams, &frames, &dir))
              || failed (snd_pcm_hw_params_get_periods (hwParams, &periods, &dir)))
+        {
             latency = 0;
+            periodSize = bufferSize;
+        }
         else
+        {
             latency = frames * (periods - 1); // (this is the method JACK uses to guess the latency..)
+            periodSize = (int) frames;
+        }
+
+        if (failed (snd_pcm_hw_params_get_buffer_size (hwParams, &ringSize)))
+            ringSize = 0; // (can't detect xruns, then)
+
+        inXRun = false;
 
         snd_pcm_sw_params_t* swParams;
         snd_pcm_sw_params_alloca (&swParams);
@@ -228,6 +260,11 @@ public:
       #endif
 
         numChannelsRunning = numChannels;
+        channelPointers.malloc ((size_t) numChannels);
+
+        DBG ("ALSA: " << (isInput ? "input" : "output") << (isMapped ? " mmap" : " read/write")
+               << (isInterleaved ? " interleaved" : " non-interleaved") << ", period " << periodSize
+               << " x " << (int) periods << ", latency " << latency);
 
         return true;
     }
@@ -239,12 +276,17 @@ public:
         float** const data = outputChannelBuffer.getArrayOfChannels();
         snd_pcm_sframes_t numDone = 0;
 
+        checkForXRun();
+
+        if (isMapped)
+            return transferMappedFrames (data, numSamples);
+
         if (isInterleaved)
         {
             scratch.ensureSize (sizeof (float) * numSamples * numChannelsRunning, false);
 
-            for (int i = 0; i < numChannelsRunning; ++i)
-                converter->convertSamples (scratch.getData(), i, data[i], 0, numSamples);
+            AudioDataConverters::convertFloatToInterleaved (sampleFormat, data, numChannelsRunning,
+                                                            scratch.getData(), numSamples);
 
             numDone = snd_pcm_writei (handle, scratch.getData(), numSamples);
         }
@@ -260,6 +302,8 @@ public:
         {
             if (numDone == -EPIPE)
             {
+                ++numXRuns;
+
                 if (failed (snd_pcm_prepare (handle)))
                     return false;
             }
@@ -275,6 +319,11 @@ public:
         jassert (numChannelsRunning <= inputChannelBuffer.getNumChannels());
         float** const data = inputChannelBuffer.getArrayOfChannels();
 
+        checkForXRun();
+
+        if (isMapped)
+            return transferMappedFrames (data, numSamples);
+
         if (isInterleaved)
         {
             scratch.ensureSize (sizeof (float) * numSamples * numChannelsRunning, false);
@@ -286,6 +335,8 @@ public:
             {
                 if (num == -EPIPE)
                 {
+                    ++numXRuns;
+
                     if (failed (snd_pcm_prepare (handle)))
                         return false;
                 }
@@ -293,13 +344,16 @@ public:
                     return false;
             }
 
-            for (int i = 0; i < numChannelsRunning; ++i)
-                converter->convertSamples (data[i], 0, scratch.getData(), i, numSamples);
+            AudioDataConverters::convertInterleavedToFloat (sampleFormat, scratch.getData(), numChannelsRunning,
+                                                            data, numSamples);
         }
         else
         {
             snd_pcm_sframes_t num = snd_pcm_readn (handle, (void**) data, numSamples);
 
+            if (num == -EPIPE)
+                ++numXRuns;
+
             if (failed (num) && num != -EPIPE && num != -ESTRPIPE)
                 return false;
 
@@ -313,14 +367,19 @@ public:
     //==============================================================================
     snd_pcm_t* handle;
     String error;
-    int bitDepth, numChannelsRunning, latency;
+    int bitDepth, numChannelsRunning, latency, periodSize;
+    Atomic<int> numXRuns;
 
     //==============================================================================
 private:
     const bool isInput;
-    bool isInterleaved;
+    bool isInterleaved, isMapped;
+    snd_pcm_uframes_t ringSize;
+    bool inXRun;
     MemoryBlock scratch;
+    HeapBlock<float*> channelPointers;
     ScopedPointer<AudioData::Converter> converter;
+    AudioDataConverters::DataFormat sampleFormat; // used by the interleaved paths
 
     //==============================================================================
     template <class SampleType>
@@ -363,6 +422,137 @@ private:
         return nullptr;
     }
 
+    // With mmap access, the samples are converted straight into or out of the ring buffer
+    bool transferMappedFrames (float* const* const data, const int numSamples)
+    {
+        int numDone = 0;
+
+        while (numDone < numSamples)
+        {
+            const snd_pcm_sframes_t numAvailable = snd_pcm_avail_update (handle);
+
+            if (numAvailable < 0)
+                return recoverFromError ((int) numAvailable);
+
+            if (numAvailable == 0)
+            {
+                // mmap transfers never start the stream, so start it here: capture as soon as
+                // it's waiting for data, and playback once the ring buffer has been filled (as
+                // alsa-lib's direct mmap example does). This also restarts it after an xrun.
+                if (snd_pcm_state (handle) == SND_PCM_STATE_PREPARED)
+                {
+                    const int startResult = snd_pcm_start (handle);
+
+                    if (startResult < 0)
+                        return recoverFromError (startResult);
+                }
+
+                const int result = snd_pcm_wait (handle, 2000);
+
+                if (result < 0)
+                    return recoverFromError (result);
+
+                if (result == 0)
+                {
+                    error = "device timed out";
+                    return false;
+                }
+
+                continue;
+            }
+
+            const snd_pcm_channel_area_t* areas = nullptr;
+            snd_pcm_uframes_t offset = 0;
+            snd_pcm_uframes_t numFrames = (snd_pcm_uframes_t) (numSamples - numDone);
+
+            const int result = snd_pcm_mmap_begin (handle, &areas, &offset, &numFrames);
+
+            if (result < 0)
+                return recoverFromError (result);
+
+            convertMappedFrames (areas, offset, data, numDone, (int) numFrames);
+
+            const snd_pcm_sframes_t numCommitted = snd_pcm_mmap_commit (handle, offset, numFrames);
+
+            if (numCommitted < 0 || (snd_pcm_uframes_t) numCommitted != numFrames)
+                return recoverFromError (numCommitted < 0 ? (int) numCommitted : -EPIPE);
+
+            numDone += (int) numFrames;
+        }
+
+        return true;
+    }
+
+    void convertMappedFrames (const snd_pcm_channel_area_t* const areas, const snd_pcm_uframes_t offset,
+                              float* const* const data, const int startSample, const int numFrames)
+    {
+        for (int i = 0; i < numChannelsRunning; ++i)
+            channelPointers[i] = data[i] + startSample;
+
+        if (isInterleaved)
+        {
+            // (with interleaved access, every channel's area points into the same block of frames)
+            jassert (areas[0].step == (unsigned int) (bitDepth * numChannelsRunning));
+            char* const frames = static_cast <char*> (areas[0].addr) + (areas[0].first + offset * areas[0].step) / 8;
+
+            if (isInput)
+                AudioDataConverters::convertInterleavedToFloat (sampleFormat, frames, numChannelsRunning, channelPointers, numFrames);
+            else
+                AudioDataConverters::convertFloatToInterleaved (sampleFormat, channelPointers, numChannelsRunning, frames, numFrames);
+        }
+        else
+        {
+            for (int i = 0; i < numChannelsRunning; ++i)
+            {
+                jassert (areas[i].step == (unsigned int) bitDepth);
+                char* const samples = static_cast <char*> (areas[i].addr) + (areas[i].first + offset * areas[i].step) / 8;
+
+                if (isInput)
+                    AudioDataConverters::convertInterleavedToFloat (sampleFormat, samples, 1, channelPointers + i, numFrames);
+                else
+                    AudioDataConverters::convertFloatToInterleaved (sampleFormat, channelPointers + i, 1, samples, numFrames);
+            }
+        }
+    }
+
+    // The stop threshold is the boundary, so the stream keeps running through an xrun
+    // and never reports -EPIPE. The xrun shows up instead as more frames available
+    // than the ring holds, until we've caught up again; count each one once.
+    void checkForXRun() noexcept
+    {
+        const snd_pcm_sframes_t numAvailable = snd_pcm_avail_update (handle);
+        const bool xrun = ringSize > 0 && numAvailable > (snd_pcm_sframes_t) ringSize;
+
+        if (xrun && ! inXRun)
+            ++numXRuns;
+
+        inXRun = xrun;
+    }
+
+    // Recovers from xruns and suspends. The rest of the current block is dropped.
+    bool recoverFromError (const int errorNum)
+    {
+        if (errorNum == -EPIPE)
+            ++numXRuns;
+
+        return ! failed (snd_pcm_recover (handle, errorNum, 1));
+    }
+
+    static AudioDataConverters::DataFormat getDataFormat (const int bitDepth, const bool isFloat, const bool isLittleEndian)
+    {
+        switch (bitDepth)
+        {
+            case 16:    return isLittleEndian ? AudioDataConverters::int16LE : AudioDataConverters::int16BE;
+            case 24:    return isLittleEndian ? AudioDataConverters::int24LE : AudioDataConverters::int24BE;
+            default:    break;
+        }
+
+        if (isFloat)
+            return isLittleEndian ? AudioDataConverters::float32LE : AudioDataConverters::float32BE;
+
+        return isLittleEndian ? AudioDataConverters::int32LE : AudioDataConverters::int32BE;
+    }
+
     //==============================================================================
     bool failed (const int errorNum)
     {
@@ -388,6 +578,8 @@ public:
           bufferSize (0),
           outputLatency (0),
           inputLatency (0),
+          realtimePriority (0),
+          useRoundRobin (false),
           callback (0),
           inputId (inputId_),
           outputId (outputId_),
@@ -471,6 +663,7 @@ public:
             }
 
             outputLatency = outputDevice->latency;
+            bufferSize = outputDevice->periodSize;
         }
 
         if (inputChannelDataForCallback.size() > 0 && inputId.isNotEmpty())
@@ -496,6 +689,9 @@ public:
             }
 
             inputLatency = inputDevice->latency;
+
+            if (outputDevice == nullptr)
+                bufferSize = inputDevice->periodSize;
         }
 
         if (outputDevice == nullptr && inputDevice == nullptr)
@@ -504,6 +700,14 @@ public:
             return;
         }
 
+        // The hardware may not have given us the period size that we asked for,
+        // in which case the callbacks run at the one it chose
+        if (bufferSize != bufferSize_)
+        {
+            resizeChannelBuffer (inputChannelBuffer, inputChannels, inputChannelDataForCallback, bufferSize);
+            resizeChannelBuffer (outputChannelBuffer, outputChannels, outputChannelDataForCallback, bufferSize);
+        }
+
         if (outputDevice != nullptr && inputDevice != nullptr)
         {
             snd_pcm_link (outputDevice->handle, inputDevice->handle);
@@ -552,6 +756,9 @@ public:
 
     void run()
     {
+        if (realtimePriority > 0 && ! Thread::setCurrentThreadRealtimePriority (realtimePriority, useRoundRobin))
+            DBG ("ALSA: couldn't get realtime scheduling");
+
         while (! threadShouldExit())
         {
             if (inputDevice != nullptr)
@@ -614,10 +821,25 @@ public:
         return 16;
     }
 
+    int getXRunCount() const noexcept
+    {
+        int numXRuns = 0;
+
+        if (outputDevice != nullptr)
+            numXRuns += outputDevice->numXRuns.get();
+
+        if (inputDevice != nullptr)
+            numXRuns += inputDevice->numXRuns.get();
+
+        return numXRuns;
+    }
+
     //==============================================================================
     String error;
     double sampleRate;
     int bufferSize, outputLatency, inputLatency;
+    int realtimePriority; // applied when the thread starts
+    bool useRoundRobin;
     BigInteger currentInputChans, currentOutputChans;
 
     Array <int> sampleRates;
@@ -648,6 +870,18 @@ private:
         return true;
     }
 
+    static void resizeChannelBuffer (AudioSampleBuffer& buffer, const BigInteger& activeChannels,
+                                     Array<float*>& channelData, const int numSamples)
+    {
+        buffer.setSize (buffer.getNumChannels(), numSamples);
+        buffer.clear();
+        channelData.clearQuick();
+
+        for (int i = 0; i < buffer.getNumChannels(); ++i)
+            if (activeChannels[i])
+                channelData.add (buffer.getSampleData (i));
+    }
+
     void initialiseRatesAndChannels()
     {
         sampleRates.clear();
@@ -764,6 +998,13 @@ public:
 
     int getOutputLatencyInSamples()         { return internal.outputLatency; }
     int getInputLatencyInSamples()          { return internal.inputLatency; }
+    int getXRunCount() const noexcept       { return internal.getXRunCount(); }
+
+    void setRealtimePriority (int priority, bool useRoundRobin)
+    {
+        internal.realtimePriority = priority;
+        internal.useRoundRobin = useRoundRobin;
+    }
 
     void start (AudioIODeviceCallback* callback)
     {
@@ -60,9 +60,11 @@ JUCE_DECL_JACK_FUNCTION (jack_nframes_t, jack_get_sample_rate, (jack_client_t* c
 JUCE_DECL_VOID_JACK_FUNCTION (jack_on_shutdown, (jack_client_t* client, void (*function)(void* arg), void* arg), (client, function, arg));
 JUCE_DECL_JACK_FUNCTION (void* , jack_port_get_buffer, (jack_port_t* port, jack_nframes_t nframes), (port, nframes));
 JUCE_DECL_JACK_FUNCTION (jack_nframes_t, jack_port_get_total_latency, (jack_client_t* client, jack_port_t* port), (client, port));
+JUCE_DECL_VOID_JACK_FUNCTION (jack_port_get_latency_range, (jack_port_t* port, jack_latency_callback_mode_t mode, jack_latency_range_t* range), (port, mode, range));
 JUCE_DECL_JACK_FUNCTION (jack_port_t* , jack_port_register, (jack_client_t* client, const char* port_name, const char* port_type, unsigned long flags, unsigned long buffer_size), (client, port_name, port_type, flags, buffer_size));
 JUCE_DECL_VOID_JACK_FUNCTION (jack_set_error_function, (void (*func)(const char*)), (func));
 JUCE_DECL_JACK_FUNCTION (int, jack_set_process_callback, (jack_client_t* client, JackProcessCallback process_callback, void* arg), (client, process_callback, arg));
+JUCE_DECL_JACK_FUNCTION (int, jack_set_xrun_callback, (jack_client_t* client, JackXRunCallback xrun_callback, void* arg), (client, xrun_callback, arg));
 JUCE_DECL_JACK_FUNCTION (const char**, jack_get_ports, (jack_client_t* client, const char* port_name_pattern, const char* type_name_pattern, unsigned long flags), (client, port_name_pattern, type_name_pattern, flags));
 JUCE_DECL_JACK_FUNCTION (int, jack_connect, (jack_client_t* client, const char* source_port, const char* destination_port), (client, source_port, destination_port));
 JUCE_DECL_JACK_FUNCTION (const char*, jack_port_name, (const jack_port_t* port), (port));
@@ -127,7 +129,10 @@ public:
           inputId (inId),
           outputId (outId),
           isOpen_ (false),
-          callback (nullptr),
+          callbackGeneration (0),
+          acknowledgedGeneration (0),
+          processThreadId (nullptr),
+          numXRuns (0),
           totalNumberOfInputChannels (0),
           totalNumberOfOutputChannels (0)
     {
@@ -220,7 +225,10 @@ public:
         lastError = String::empty;
         close();
 
+        numXRuns = 0;
+
         juce::jack_set_process_callback (client, processCallback, this);
+        juce::jack_set_xrun_callback (client, xrunCallback, this);
         juce::jack_set_port_connect_callback (client, portConnectCallback, this);
         juce::jack_on_shutdown (client, shutdownCallback, this);
         juce::jack_activate (client);
@@ -281,6 +289,7 @@ public:
         {
             juce::jack_deactivate (client);
             juce::jack_set_process_callback (client, processCallback, nullptr);
+            juce::jack_set_xrun_callback (client, xrunCallback, nullptr);
             juce::jack_set_port_connect_callback (client, portConnectCallback, nullptr);
             juce::jack_on_shutdown (client, shutdownCallback, nullptr);
         }
@@ -290,17 +299,13 @@ public:
 
     void start (AudioIODeviceCallback* newCallback)
     {
-        if (isOpen_ && newCallback != callback)
+        if (isOpen_ && newCallback != callback.get())
         {
             if (newCallback != nullptr)
                 newCallback->audioDeviceAboutToStart (this);
 
-            AudioIODeviceCallback* const oldCallback = callback;
-
-            {
-                const ScopedLock sl (callbackLock);
-                callback = newCallback;
-            }
+            AudioIODeviceCallback* const oldCallback = callback.exchange (newCallback);
+            waitForCallbackToBeAcknowledged();
 
             if (oldCallback != nullptr)
                 oldCallback->audioDeviceStopped();
@@ -313,7 +318,7 @@ public:
     }
 
     bool isOpen()                           { return isOpen_; }
-    bool isPlaying()                        { return callback != nullptr; }
+    bool isPlaying()                        { return callback.get() != nullptr; }
     int getCurrentBufferSizeSamples()       { return getBufferSizeSamples (0); }
     double getCurrentSampleRate()           { return getSampleRate (0); }
     int getCurrentBitDepth()                { return 32; }
@@ -322,31 +327,86 @@ public:
     BigInteger getActiveOutputChannels() const { return activeOutputChannels; }
     BigInteger getActiveInputChannels()  const { return activeInputChannels;  }
 
-    int getOutputLatencyInSamples()
+    int getOutputLatencyInSamples()         { return getOutputLatencyRange().getEnd(); }
+    int getInputLatencyInSamples()          { return getInputLatencyRange().getEnd(); }
+
+    Range<int> getOutputLatencyRange()      { return getLatencyRange (outputPorts, JackPlaybackLatency); }
+    Range<int> getInputLatencyRange()       { return getLatencyRange (inputPorts, JackCaptureLatency); }
+
+    int getXRunCount() const noexcept       { return numXRuns.get(); }
+
+    String inputId, outputId;
+
+private:
+    Range<int> getLatencyRange (const Array<void*>& ports, const jack_latency_callback_mode_t mode) const
     {
-        int latency = 0;
+        if (client == nullptr || ports.size() == 0)
+            return Range<int>();
 
-        for (int i = 0; i < outputPorts.size(); i++)
-            latency = jmax (latency, (int) juce::jack_port_get_total_latency (client, (jack_port_t*) outputPorts [i]));
+        int minLatency = std::numeric_limits<int>::max(), maxLatency = 0;
 
-        return latency;
+        for (int i = 0; i < ports.size(); ++i)
+        {
+            jack_latency_range_t range = { 0, 0 };
+            juce::jack_port_get_latency_range ((jack_port_t*) ports.getUnchecked(i), mode, &range);
+
+            if (range.max == 0) // older servers only know the total latency
+                range.min = range.max = juce::jack_port_get_total_latency (client, (jack_port_t*) ports.getUnchecked(i));
+
+            minLatency = jmin (minLatency, (int) range.min);
+            maxLatency = jmax (maxLatency, (int) range.max);
+        }
+
+        return Range<int> (minLatency, maxLatency);
     }
 
-    int getInputLatencyInSamples()
+    /*  The JACK thread never locks anything: it reads the callback pointer at the start
+        of each cycle, and when the cycle is done it publishes the generation number it
+        saw. After swapping the pointer, start() waits here until a whole cycle has run
+        with the new one, so the old callback can't still be in use once it's been told
+        to stop. If JACK isn't running cycles (or we are the JACK thread), there's
+        nothing to wait for.
+    */
+    void waitForCallbackToBeAcknowledged()
     {
-        int latency = 0;
+        const int generation = ++callbackGeneration;
 
-        for (int i = 0; i < inputPorts.size(); i++)
-            latency = jmax (latency, (int) juce::jack_port_get_total_latency (client, (jack_port_t*) inputPorts [i]));
+        if (client == nullptr || ! isOpen_ || Thread::getCurrentThreadId() == processThreadId.get())
+            return;
 
-        return latency;
-    }
+        const uint32 timeout = Time::getMillisecondCounter() + 500;
 
-    String inputId, outputId;
+        while (acknowledgedGeneration.get() - generation < 0)
+        {
+            if (Time::getMillisecondCounter() > timeout)
+            {
+                jack_Log ("JackAudioIODevice: the JACK thread didn't acknowledge the new callback");
+                break;
+            }
+
+            Thread::sleep (1);
+        }
+    }
 
-private:
     void process (const int numSamples)
     {
+        processThreadId = Thread::getCurrentThreadId();
+
+        // (the generation must be read before the pointer, as start() writes them the other way round)
+        const int generation = callbackGeneration.get();
+        AudioIODeviceCallback* const currentCallback = callback.get();
+
+        if (currentCallback == nullptr)
+        {
+            // the active channel lists may be being changed while we're stopped, so don't touch them
+            for (int i = 0; i < totalNumberOfOutputChannels; ++i)
+                if (void* out = juce::jack_port_get_buffer ((jack_port_t*) outputPorts.getUnchecked(i), numSamples))
+                    zeromem (out, sizeof (float) * numSamples);
+
+            acknowledgedGeneration = generation;
+            return;
+        }
+
         int numActiveInChans = 0, numActiveOutChans = 0;
 
         for (int i = 0; i < totalNumberOfInputChannels; ++i)
@@ -365,19 +425,11 @@ private:
                     outChans [numActiveOutChans++] = (float*) out;
         }
 
-        const ScopedLock sl (callbackLock);
+        if ((numActiveInChans + numActiveOutChans) > 0)
+            currentCallback->audioDeviceIOCallback (const_cast <const float**> (inChans.getData()), numActiveInChans,
+                                                    outChans, numActiveOutChans, numSamples);
 
-        if (callback != nullptr)
-        {
-            if ((numActiveInChans + numActiveOutChans) > 0)
-                callback->audioDeviceIOCallback (const_cast <const float**> (inChans.getData()), numActiveInChans,
-                                                 outChans, numActiveOutChans, numSamples);
-        }
-        else
-        {
-            for (int i = 0; i < numActiveOutChans; ++i)
-                zeromem (outChans[i], sizeof (float) * numSamples);
-        }
+        acknowledgedGeneration = generation;
     }
 
     static int processCallback (jack_nframes_t nframes, void* callbackArgument)
@@ -403,7 +455,7 @@ private:
         if (newOutputChannels != activeOutputChannels
              || newInputChannels != activeInputChannels)
         {
-            AudioIODeviceCallback* const oldCallback = callback;
+            AudioIODeviceCallback* const oldCallback = callback.get();
 
             stop();
 
@@ -417,6 +469,14 @@ private:
         }
     }
 
+    static int xrunCallback (void* callbackArgument)
+    {
+        if (JackAudioIODevice* device = static_cast <JackAudioIODevice*> (callbackArgument))
+            ++(device->numXRuns);
+
+        return 0;
+    }
+
     static void portConnectCallback (jack_port_id_t, jack_port_id_t, int, void* arg)
     {
         if (JackAudioIODevice* device = static_cast <JackAudioIODevice*> (arg))
@@ -449,8 +509,10 @@ private:
     bool isOpen_;
     jack_client_t* client;
     String lastError;
-    AudioIODeviceCallback* callback;
-    CriticalSection callbackLock;
+    Atomic<AudioIODeviceCallback*> callback;
+    Atomic<int> callbackGeneration, acknowledgedGeneration;
+    Atomic<Thread::ThreadID> processThreadId;
+    Atomic<int> numXRuns;
 
     HeapBlock <float*> inChans, outChans;
     int totalNumberOfInputChannels;
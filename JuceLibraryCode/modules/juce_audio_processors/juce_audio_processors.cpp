@@ -52,6 +52,12 @@
  #endif
 #endif
 
+#if JUCE_MAC || JUCE_IOS
+ #include <mach/mach.h> // (semaphores for AudioProcessorGraph's render threads)
+#elif ! JUCE_WINDOWS
+ #include <semaphore.h>
+#endif
+
 #if JUCE_PLUGINHOST_VST && JUCE_LINUX
  #include <X11/Xlib.h>
  #include <X11/Xutil.h>
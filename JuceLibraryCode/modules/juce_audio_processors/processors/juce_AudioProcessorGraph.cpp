@@ -30,175 +30,174 @@ namespace GraphRenderingOps
 {
 
 //==============================================================================
-class AudioGraphRenderingOp
-{
-public:
-    AudioGraphRenderingOp() {}
-    virtual ~AudioGraphRenderingOp()  {}
-
-    virtual void perform (AudioSampleBuffer& sharedBufferChans,
-                          const OwnedArray <MidiBuffer>& sharedMidiBuffers,
-                          const int numSamples) = 0;
-
-    JUCE_LEAK_DETECTOR (AudioGraphRenderingOp)
-};
+/** Works out which nodes' ops depend on each other, from the shared buffers
+    each op reads and writes.
 
-//==============================================================================
-class ClearChannelOp : public AudioGraphRenderingOp
+    Ops are fed in rendering order, grouped into tasks. A task that reads a buffer
+    depends on the last task that wrote it, and a task that writes a buffer also
+    depends on every task that has read it since then.
+*/
+class BufferDependencyTracker
 {
 public:
-    ClearChannelOp (const int channelNum_)
-        : channelNum (channelNum_)
-    {}
-
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    BufferDependencyTracker (const int numAudioBuffers_, const int numMidiBuffers, const int numDelayLines)
+        : numAudioBuffers (numAudioBuffers_),
+          graphOutputResource (numAudioBuffers_ + numMidiBuffers),
+          currentTask (-1)
     {
-        sharedBufferChans.clear (channelNum, 0, numSamples);
+        for (int i = 0; i <= graphOutputResource + numDelayLines; ++i)
+        {
+            lastWriters.add (-1);
+            readers.add (new Array<int>());
+        }
     }
 
-private:
-    const int channelNum;
-
-    JUCE_DECLARE_NON_COPYABLE (ClearChannelOp)
-};
-
-//==============================================================================
-class CopyChannelOp : public AudioGraphRenderingOp
-{
-public:
-    CopyChannelOp (const int srcChannelNum_, const int dstChannelNum_)
-        : srcChannelNum (srcChannelNum_),
-          dstChannelNum (dstChannelNum_)
-    {}
-
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    void startTask()
     {
-        sharedBufferChans.copyFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
+        ++currentTask;
+        dependencies.add (new SortedSet<int>());
     }
 
-private:
-    const int srcChannelNum, dstChannelNum;
+    void readAudio (const int bufferNum)        { read (bufferNum); }
+    void writeAudio (const int bufferNum)       { write (bufferNum); }
+    void readMidi (const int bufferNum)         { read (numAudioBuffers + bufferNum); }
+    void writeMidi (const int bufferNum)        { write (numAudioBuffers + bufferNum); }
+    void readDelayLine (const int index)        { read (graphOutputResource + 1 + index); }
+    void writeDelayLine (const int index)       { write (graphOutputResource + 1 + index); }
 
-    JUCE_DECLARE_NON_COPYABLE (CopyChannelOp)
-};
+    /** The graph's output buffers are summed into in rendering order, so all the
+        output nodes are treated as writers of a single resource. */
+    void writeGraphOutput()                     { write (graphOutputResource); }
 
-//==============================================================================
-class AddChannelOp : public AudioGraphRenderingOp
-{
-public:
-    AddChannelOp (const int srcChannelNum_, const int dstChannelNum_)
-        : srcChannelNum (srcChannelNum_),
-          dstChannelNum (dstChannelNum_)
-    {}
+    int getNumTasks() const noexcept                                { return dependencies.size(); }
+    const SortedSet<int>& getDependencies (const int task) const    { return *dependencies.getUnchecked (task); }
+
+private:
+    const int numAudioBuffers, graphOutputResource;
+    int currentTask;
+    Array<int> lastWriters;
+    OwnedArray<Array<int> > readers;
+    OwnedArray<SortedSet<int> > dependencies;
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    void read (const int resource)
     {
-        sharedBufferChans.addFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
+        addDependency (lastWriters.getUnchecked (resource));
+        readers.getUnchecked (resource)->addIfNotAlreadyThere (currentTask);
     }
 
-private:
-    const int srcChannelNum, dstChannelNum;
+    void write (const int resource)
+    {
+        Array<int>& resourceReaders = *readers.getUnchecked (resource);
 
-    JUCE_DECLARE_NON_COPYABLE (AddChannelOp)
-};
+        addDependency (lastWriters.getUnchecked (resource));
 
-//==============================================================================
-class ClearMidiBufferOp : public AudioGraphRenderingOp
-{
-public:
-    ClearMidiBufferOp (const int bufferNum_)
-        : bufferNum (bufferNum_)
-    {}
+        for (int i = resourceReaders.size(); --i >= 0;)
+            addDependency (resourceReaders.getUnchecked (i));
 
-    void perform (AudioSampleBuffer&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int)
-    {
-        sharedMidiBuffers.getUnchecked (bufferNum)->clear();
+        resourceReaders.clearQuick();
+        lastWriters.set (resource, currentTask);
     }
 
-private:
-    const int bufferNum;
+    void addDependency (const int task)
+    {
+        if (task >= 0 && task != currentTask)
+            dependencies.getLast()->add (task);
+    }
 
-    JUCE_DECLARE_NON_COPYABLE (ClearMidiBufferOp)
+    JUCE_DECLARE_NON_COPYABLE (BufferDependencyTracker)
 };
 
 //==============================================================================
-class CopyMidiBufferOp : public AudioGraphRenderingOp
-{
-public:
-    CopyMidiBufferOp (const int srcBufferNum_, const int dstBufferNum_)
-        : srcBufferNum (srcBufferNum_),
-          dstBufferNum (dstBufferNum_)
-    {}
+/** One step of a rendering sequence.
 
-    void perform (AudioSampleBuffer&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int)
+    Ops are stored by value, one after another, and dispatched on their type, so
+    running a sequence doesn't chase a pointer and make a virtual call per op.
+    Anything that needs more state than a couple of buffer numbers keeps it in a
+    table owned by the sequence.
+*/
+struct RenderingOp
+{
+    enum Type
     {
-        *sharedMidiBuffers.getUnchecked (dstBufferNum) = *sharedMidiBuffers.getUnchecked (srcBufferNum);
-    }
-
-private:
-    const int srcBufferNum, dstBufferNum;
+        clearChannel,
+        copyChannel,
+        addChannel,
+        mixChannels,        // dest = the sum of several channels, in order
+        delayChannel,
+        readDelayedChannel, // dest = the output of an earlier delayChannel
+        clearMidiBuffer,
+        copyMidiBuffer,
+        addMidiBuffer,
+        processBuffer
+    };
 
-    JUCE_DECLARE_NON_COPYABLE (CopyMidiBufferOp)
+    Type type;
+    int source;     // source buffer, or for mixChannels, the index of its first entry in the mix sources
+    int dest;       // destination buffer
+    int extra;      // mixChannels: number of sources; delay ops: the delay line; processBuffer: the processor
 };
 
 //==============================================================================
-class AddMidiBufferOp : public AudioGraphRenderingOp
+/** Delays a channel by a fixed number of samples, for latency compensation.
+
+    Blocks are copied in and out of a ring buffer with at most two copies each way.
+    The ring has room for a whole block beyond the delay, so a block's input can be
+    written before its output is read, and the output stays there until the next
+    block - so anything else that needs the same signal with the same delay can
+    read it back, rather than keeping a delay line of its own.
+*/
+class DelayLine
 {
 public:
-    AddMidiBufferOp (const int srcBufferNum_, const int dstBufferNum_)
-        : srcBufferNum (srcBufferNum_),
-          dstBufferNum (dstBufferNum_)
-    {}
-
-    void perform (AudioSampleBuffer&, const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    DelayLine (const int numSamplesDelay_, const int maxBlockSize)
+        : numSamplesDelay (numSamplesDelay_),
+          bufferSize (numSamplesDelay_ + jmax (1, maxBlockSize)),
+          writeIndex (0)
     {
-        sharedMidiBuffers.getUnchecked (dstBufferNum)
-            ->addEvents (*sharedMidiBuffers.getUnchecked (srcBufferNum), 0, numSamples, 0);
+        buffer.calloc ((size_t) bufferSize);
     }
 
-private:
-    const int srcBufferNum, dstBufferNum;
+    /** The source and destination may be the same channel. */
+    void process (const float* const source, float* const dest, const int numSamples) noexcept
+    {
+        jassert (numSamples <= bufferSize - numSamplesDelay); // (the graph splits up bigger host blocks)
 
-    JUCE_DECLARE_NON_COPYABLE (AddMidiBufferOp)
-};
+        const int numBeforeWrap = jmin (numSamples, bufferSize - writeIndex);
+        FloatVectorOperations::copy (buffer + writeIndex, source, numBeforeWrap);
+        FloatVectorOperations::copy (buffer, source + numBeforeWrap, numSamples - numBeforeWrap);
 
-//==============================================================================
-class DelayChannelOp : public AudioGraphRenderingOp
-{
-public:
-    DelayChannelOp (const int channel_, const int numSamplesDelay_)
-        : channel (channel_),
-          bufferSize (numSamplesDelay_ + 1),
-          readIndex (0), writeIndex (numSamplesDelay_)
-    {
-        buffer.calloc ((size_t) bufferSize);
+        writeIndex += numSamples;
+
+        if (writeIndex >= bufferSize)
+            writeIndex -= bufferSize;
+
+        readLastBlock (dest, numSamples);
     }
 
-    void perform (AudioSampleBuffer& sharedBufferChans, const OwnedArray <MidiBuffer>&, const int numSamples)
+    /** Copies out the same samples as the last call to process() produced. */
+    void readLastBlock (float* const dest, const int numSamples) const noexcept
     {
-        float* data = sharedBufferChans.getSampleData (channel, 0);
+        int readIndex = writeIndex - numSamples - numSamplesDelay;
 
-        for (int i = numSamples; --i >= 0;)
-        {
-            buffer [writeIndex] = *data;
-            *data++ = buffer [readIndex];
+        if (readIndex < 0)
+            readIndex += bufferSize;
 
-            if (++readIndex  >= bufferSize) readIndex = 0;
-            if (++writeIndex >= bufferSize) writeIndex = 0;
-        }
+        const int numBeforeWrap = jmin (numSamples, bufferSize - readIndex);
+        FloatVectorOperations::copy (dest, buffer + readIndex, numBeforeWrap);
+        FloatVectorOperations::copy (dest + numBeforeWrap, buffer, numSamples - numBeforeWrap);
     }
 
 private:
     HeapBlock<float> buffer;
-    const int channel, bufferSize;
-    int readIndex, writeIndex;
+    const int numSamplesDelay, bufferSize;
+    int writeIndex;
 
-    JUCE_DECLARE_NON_COPYABLE (DelayChannelOp)
+    JUCE_DECLARE_NON_COPYABLE (DelayLine)
 };
 
 
 //==============================================================================
-class ProcessBufferOp : public AudioGraphRenderingOp
+class ProcessBufferOp
 {
 public:
     ProcessBufferOp (const AudioProcessorGraph::Node::Ptr& node_,
@@ -227,6 +226,27 @@ public:
         processor->processBlock (buffer, *sharedMidiBuffers.getUnchecked (midiBufferToUse));
     }
 
+    void addBufferAccesses (BufferDependencyTracker& tracker) const
+    {
+        const int numOuts = processor->getNumOutputChannels();
+
+        for (int i = 0; i < totalChans; ++i)
+        {
+            if (i < numOuts)
+                tracker.writeAudio (audioChannelsToUse.getUnchecked (i));
+            else
+                tracker.readAudio (audioChannelsToUse.getUnchecked (i));
+        }
+
+        // the processor gets a writable midi buffer whether it uses midi or not
+        tracker.writeMidi (midiBufferToUse);
+
+        if (const AudioProcessorGraph::AudioGraphIOProcessor* const ioProc
+                = dynamic_cast <const AudioProcessorGraph::AudioGraphIOProcessor*> (processor))
+            if (ioProc->isOutput())
+                tracker.writeGraphOutput();
+    }
+
     const AudioProcessorGraph::Node::Ptr node;
     AudioProcessor* const processor;
 
@@ -239,6 +259,311 @@ private:
     JUCE_DECLARE_NON_COPYABLE (ProcessBufferOp)
 };
 
+//==============================================================================
+/** A compiled rendering sequence: the ops in one contiguous array, plus the
+    delay lines, processor calls and mix source lists that they refer to.
+*/
+class RenderingOpSequence
+{
+public:
+    RenderingOpSequence (const int blockSize_)
+        : blockSize (blockSize_)
+    {}
+
+    //==============================================================================
+    void addClearChannelOp (const int channel)                      { addOp (RenderingOp::clearChannel, 0, channel); }
+    void addCopyChannelOp (const int source, const int dest)        { addOp (RenderingOp::copyChannel, source, dest); }
+    void addAddChannelOp (const int source, const int dest)         { addOp (RenderingOp::addChannel, source, dest); }
+    void addClearMidiBufferOp (const int buffer)                    { addOp (RenderingOp::clearMidiBuffer, 0, buffer); }
+    void addCopyMidiBufferOp (const int source, const int dest)     { addOp (RenderingOp::copyMidiBuffer, source, dest); }
+    void addAddMidiBufferOp (const int source, const int dest)      { addOp (RenderingOp::addMidiBuffer, source, dest); }
+
+    /** Delays a channel that holds the given output of a node. If that output has
+        already been delayed by the same amount, this just reads the earlier delay
+        line's output. */
+    void addDelayChannelOp (const int channel, const int numSamplesDelay,
+                            const uint32 sourceNodeId, const int sourceChannel)
+    {
+        for (int i = 0; i < delayLineSources.size(); ++i)
+        {
+            const DelayLineSource& d = delayLineSources.getReference (i);
+
+            if (d.nodeId == sourceNodeId && d.channel == sourceChannel && d.numSamplesDelay == numSamplesDelay)
+            {
+                addOp (RenderingOp::readDelayedChannel, 0, channel, i);
+                return;
+            }
+        }
+
+        const DelayLineSource source = { sourceNodeId, sourceChannel, numSamplesDelay };
+        delayLineSources.add (source);
+
+        addOp (RenderingOp::delayChannel, channel, channel, delayLines.size());
+        delayLines.add (new DelayLine (numSamplesDelay, blockSize));
+    }
+
+    void addProcessBufferOp (const AudioProcessorGraph::Node::Ptr& node, const Array <int>& audioChannelsToUse,
+                             const int totalChans, const int midiBufferToUse)
+    {
+        addOp (RenderingOp::processBuffer, 0, 0, processors.size());
+        processors.add (new ProcessBufferOp (node, audioChannelsToUse, totalChans, midiBufferToUse));
+    }
+
+    //==============================================================================
+    /** Merges neighbouring ops that work on the same channel.
+
+        A copy into a channel that's then delayed becomes a delay straight from the
+        source channel, or disappears if the delayed signal is read from an earlier
+        delay line. A clear, copy or add followed by more adds into the same
+        channel becomes a single pass that sums all of the sources; each sample is
+        still summed in the same order, so the output doesn't change. Ops are never
+        merged across a ProcessBufferOp, so each node keeps its own ops.
+    */
+    void optimise()
+    {
+        Array<RenderingOp> optimised;
+        optimised.ensureStorageAllocated (ops.size());
+
+        for (int i = 0; i < ops.size(); ++i)
+        {
+            RenderingOp op (ops.getUnchecked (i));
+
+            if (op.type == RenderingOp::copyChannel && isDelayInto (i + 1, op.dest))
+            {
+                const int source = op.source;
+                op = ops.getUnchecked (++i);
+
+                if (op.type == RenderingOp::delayChannel)
+                    op.source = source;
+            }
+            else if ((op.type == RenderingOp::clearChannel
+                       || op.type == RenderingOp::copyChannel
+                       || op.type == RenderingOp::addChannel)
+                      && isAddInto (i + 1, op.dest))
+            {
+                const int firstSource = mixSources.size();
+
+                switch (op.type)
+                {
+                    case RenderingOp::clearChannel:     mixSources.add (0); break; // the read-only empty buffer
+                    case RenderingOp::copyChannel:      mixSources.add (op.source); break;
+                    default:                            mixSources.add (op.dest); mixSources.add (op.source); break;
+                }
+
+                while (isAddInto (i + 1, op.dest))
+                    mixSources.add (ops.getReference (++i).source);
+
+                op.type = RenderingOp::mixChannels;
+                op.source = firstSource;
+                op.extra = mixSources.size() - firstSource;
+            }
+
+            optimised.add (op);
+        }
+
+        ops.swapWithArray (optimised);
+        ops.minimiseStorageOverheads();
+    }
+
+    //==============================================================================
+    int size() const noexcept                                       { return ops.size(); }
+    int getNumDelayLines() const noexcept                           { return delayLines.size(); }
+
+    bool isProcessBufferOp (const int index) const noexcept
+    {
+        return ops.getReference (index).type == RenderingOp::processBuffer;
+    }
+
+    void addBufferAccesses (const int index, BufferDependencyTracker& tracker) const
+    {
+        const RenderingOp& op = ops.getReference (index);
+
+        switch (op.type)
+        {
+            case RenderingOp::clearChannel:
+                tracker.writeAudio (op.dest);
+                break;
+
+            case RenderingOp::copyChannel:
+            case RenderingOp::addChannel:
+                tracker.readAudio (op.source);
+                tracker.writeAudio (op.dest);
+                break;
+
+            case RenderingOp::delayChannel:
+                tracker.readAudio (op.source);
+                tracker.writeAudio (op.dest);
+                tracker.writeDelayLine (op.extra);
+                break;
+
+            case RenderingOp::readDelayedChannel:
+                tracker.readDelayLine (op.extra);
+                tracker.writeAudio (op.dest);
+                break;
+
+            case RenderingOp::mixChannels:
+                for (int i = 0; i < op.extra; ++i)
+                    tracker.readAudio (mixSources.getUnchecked (op.source + i));
+
+                tracker.writeAudio (op.dest);
+                break;
+
+            case RenderingOp::clearMidiBuffer:
+                tracker.writeMidi (op.dest);
+                break;
+
+            case RenderingOp::copyMidiBuffer:
+            case RenderingOp::addMidiBuffer:
+                tracker.readMidi (op.source);
+                tracker.writeMidi (op.dest);
+                break;
+
+            case RenderingOp::processBuffer:
+                processors.getUnchecked (op.extra)->addBufferAccesses (tracker);
+                break;
+
+            default:
+                jassertfalse;
+                break;
+        }
+    }
+
+    //==============================================================================
+    /** Runs the ops from startOp up to (but not including) endOp. */
+    void perform (const int startOp, const int endOp, AudioSampleBuffer& sharedBufferChans,
+                  const OwnedArray <MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    {
+        const RenderingOp* const end = ops.getRawDataPointer() + endOp;
+
+        for (const RenderingOp* op = ops.getRawDataPointer() + startOp; op < end; ++op)
+        {
+            switch (op->type)
+            {
+                case RenderingOp::clearChannel:
+                    sharedBufferChans.clear (op->dest, 0, numSamples);
+                    break;
+
+                case RenderingOp::copyChannel:
+                    sharedBufferChans.copyFrom (op->dest, 0, sharedBufferChans, op->source, 0, numSamples);
+                    break;
+
+                case RenderingOp::addChannel:
+                    sharedBufferChans.addFrom (op->dest, 0, sharedBufferChans, op->source, 0, numSamples);
+                    break;
+
+                case RenderingOp::mixChannels:
+                    mix (*op, sharedBufferChans, numSamples);
+                    break;
+
+                case RenderingOp::delayChannel:
+                    delayLines.getUnchecked (op->extra)->process (sharedBufferChans.getSampleData (op->source, 0),
+                                                                  sharedBufferChans.getSampleData (op->dest, 0),
+                                                                  numSamples);
+                    break;
+
+                case RenderingOp::readDelayedChannel:
+                    delayLines.getUnchecked (op->extra)->readLastBlock (sharedBufferChans.getSampleData (op->dest, 0),
+                                                                        numSamples);
+                    break;
+
+                case RenderingOp::clearMidiBuffer:
+                    sharedMidiBuffers.getUnchecked (op->dest)->clear();
+                    break;
+
+                case RenderingOp::copyMidiBuffer:
+                    *sharedMidiBuffers.getUnchecked (op->dest) = *sharedMidiBuffers.getUnchecked (op->source);
+                    break;
+
+                case RenderingOp::addMidiBuffer:
+                    sharedMidiBuffers.getUnchecked (op->dest)
+                        ->addEvents (*sharedMidiBuffers.getUnchecked (op->source), 0, numSamples, 0);
+                    break;
+
+                case RenderingOp::processBuffer:
+                    processors.getUnchecked (op->extra)->perform (sharedBufferChans, sharedMidiBuffers, numSamples);
+                    break;
+
+                default:
+                    jassertfalse;
+                    break;
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    struct DelayLineSource
+    {
+        uint32 nodeId;
+        int channel, numSamplesDelay;
+    };
+
+    const int blockSize;
+    Array<RenderingOp> ops;
+    Array<int> mixSources;
+    OwnedArray<DelayLine> delayLines;
+    Array<DelayLineSource> delayLineSources;
+    OwnedArray<ProcessBufferOp> processors;
+
+    void addOp (const RenderingOp::Type type, const int source, const int dest, const int extra = 0)
+    {
+        const RenderingOp op = { type, source, dest, extra };
+        ops.add (op);
+    }
+
+    bool isDelayInto (const int index, const int dest) const noexcept
+    {
+        if (index >= ops.size())
+            return false;
+
+        const RenderingOp& op = ops.getReference (index);
+        return (op.type == RenderingOp::delayChannel || op.type == RenderingOp::readDelayedChannel)
+                 && op.dest == dest;
+    }
+
+    bool isAddInto (const int index, const int dest) const noexcept
+    {
+        if (index >= ops.size())
+            return false;
+
+        const RenderingOp& op = ops.getReference (index);
+        return op.type == RenderingOp::addChannel && op.dest == dest && op.source != dest;
+    }
+
+    /** Sums the sources into the destination, two at a time. Only the first
+        source may be the destination itself. */
+    void mix (const RenderingOp& op, AudioSampleBuffer& sharedBufferChans, const int numSamples) const noexcept
+    {
+        const int* sourceNums = &mixSources.getReference (op.source);
+        const int* const endSourceNums = sourceNums + op.extra;
+
+        float* const dest = sharedBufferChans.getSampleData (op.dest, 0);
+        const float* first = sharedBufferChans.getSampleData (*sourceNums++, 0);
+
+        while (sourceNums < endSourceNums)
+        {
+            const float* const a = sharedBufferChans.getSampleData (*sourceNums++, 0);
+
+            if (sourceNums < endSourceNums)
+            {
+                const float* const b = sharedBufferChans.getSampleData (*sourceNums++, 0);
+
+                for (int i = 0; i < numSamples; ++i)
+                    dest[i] = first[i] + a[i] + b[i];
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    dest[i] = first[i] + a[i];
+            }
+
+            first = dest;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (RenderingOpSequence)
+};
+
 //==============================================================================
 /** Used to calculate the correct sequence of rendering ops needed, based on
     the best re-use of shared buffers at each stage.
@@ -249,11 +574,16 @@ public:
     //==============================================================================
     RenderingOpSequenceCalculator (AudioProcessorGraph& graph_,
                                    const Array<void*>& orderedNodes_,
-                                   Array<void*>& renderingOps)
+                                   RenderingOpSequence& renderingOps,
+                                   const bool reuseFreeBuffers_ = true)
         : graph (graph_),
           orderedNodes (orderedNodes_),
-          totalLatency (0)
+          totalLatency (0),
+          reuseFreeBuffers (reuseFreeBuffers_),
+          nodeSteps (jmax (101, orderedNodes_.size() * 2))
     {
+        indexConnections();
+
         nodeIds.add ((uint32) zeroNodeID); // first buffer is read-only zeros
         channels.add (0);
 
@@ -288,6 +618,62 @@ private:
     Array <int> nodeDelays;
     int totalLatency;
 
+    // Re-using a buffer that an earlier node has finished with serialises the
+    // two nodes, so the parallel renderer gives every value its own buffer.
+    const bool reuseFreeBuffers;
+
+    //==============================================================================
+    // Each node's connections, indexed up front so that building the sequence is
+    // linear in the size of the graph, rather than searching every connection for
+    // every channel of every node.
+    struct Consumer
+    {
+        int sourceChannel, destStep, destChannel;
+    };
+
+    struct NodeConnections
+    {
+        Array<const AudioProcessorGraph::Connection*> inputs;
+        Array<Consumer> consumers;
+    };
+
+    HashMap<int, int> nodeSteps;
+    OwnedArray<NodeConnections> nodeConnections;
+
+    void indexConnections()
+    {
+        for (int i = 0; i < orderedNodes.size(); ++i)
+        {
+            nodeSteps.set ((int) ((const AudioProcessorGraph::Node*) orderedNodes.getUnchecked(i))->nodeId, i);
+            nodeConnections.add (new NodeConnections());
+        }
+
+        // Walked backwards, so that each node's inputs are mixed in the same order
+        // as they always have been.
+        for (int i = graph.getNumConnections(); --i >= 0;)
+        {
+            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+
+            if (nodeSteps.contains ((int) c->sourceNodeId) && nodeSteps.contains ((int) c->destNodeId))
+            {
+                const int destStep = getStepOf (c->destNodeId);
+                const AudioProcessorGraph::Node* const dest = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (destStep);
+
+                nodeConnections.getUnchecked (destStep)->inputs.add (c);
+
+                if (c->destChannelIndex == AudioProcessorGraph::midiChannelIndex
+                     || c->destChannelIndex < dest->getProcessor()->getNumInputChannels())
+                {
+                    const Consumer consumer = { c->sourceChannelIndex, destStep, c->destChannelIndex };
+                    nodeConnections.getUnchecked (getStepOf (c->sourceNodeId))->consumers.add (consumer);
+                }
+            }
+        }
+    }
+
+    int getStepOf (const uint32 nodeID) const                               { return nodeSteps [(int) nodeID]; }
+    const Array<const AudioProcessorGraph::Connection*>& getInputs (const int step) const    { return nodeConnections.getUnchecked (step)->inputs; }
+
     int getNodeDelay (const uint32 nodeID) const          { return nodeDelays [nodeDelayIDs.indexOf (nodeID)]; }
 
     void setNodeDelay (const uint32 nodeID, const int latency)
@@ -305,24 +691,20 @@ private:
         }
     }
 
-    int getInputLatencyForNode (const uint32 nodeID) const
+    int getInputLatencyForNode (const int step) const
     {
+        const Array<const AudioProcessorGraph::Connection*>& inputs = getInputs (step);
         int maxLatency = 0;
 
-        for (int i = graph.getNumConnections(); --i >= 0;)
-        {
-            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
-
-            if (c->destNodeId == nodeID)
-                maxLatency = jmax (maxLatency, getNodeDelay (c->sourceNodeId));
-        }
+        for (int i = 0; i < inputs.size(); ++i)
+            maxLatency = jmax (maxLatency, getNodeDelay (inputs.getUnchecked(i)->sourceNodeId));
 
         return maxLatency;
     }
 
     //==============================================================================
     void createRenderingOpsForNode (AudioProcessorGraph::Node* const node,
-                                    Array<void*>& renderingOps,
+                                    RenderingOpSequence& renderingOps,
                                     const int ourRenderingIndex)
     {
         const int numIns = node->getProcessor()->getNumInputChannels();
@@ -332,7 +714,8 @@ private:
         Array <int> audioChannelsToUse;
         int midiBufferToUse = -1;
 
-        int maxLatency = getInputLatencyForNode (node->nodeId);
+        const Array<const AudioProcessorGraph::Connection*>& inputs = getInputs (ourRenderingIndex);
+        int maxLatency = getInputLatencyForNode (ourRenderingIndex);
 
         for (int inputChan = 0; inputChan < numIns; ++inputChan)
         {
@@ -340,11 +723,11 @@ private:
             Array <uint32> sourceNodes;
             Array<int> sourceOutputChans;
 
-            for (int i = graph.getNumConnections(); --i >= 0;)
+            for (int i = 0; i < inputs.size(); ++i)
             {
-                const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+                const AudioProcessorGraph::Connection* const c = inputs.getUnchecked(i);
 
-                if (c->destNodeId == node->nodeId && c->destChannelIndex == inputChan)
+                if (c->destChannelIndex == inputChan)
                 {
                     sourceNodes.add (c->sourceNodeId);
                     sourceOutputChans.add (c->sourceChannelIndex);
@@ -365,7 +748,7 @@ private:
                 else
                 {
                     bufIndex = getFreeBuffer (false);
-                    renderingOps.add (new ClearChannelOp (bufIndex));
+                    renderingOps.addClearChannelOp (bufIndex);
                 }
             }
             else if (sourceNodes.size() == 1)
@@ -375,11 +758,13 @@ private:
                 const int srcChan = sourceOutputChans.getUnchecked(0);
 
                 bufIndex = getBufferContaining (srcNode, srcChan);
+                uint32 delayedNode = srcNode;
 
                 if (bufIndex < 0)
                 {
                     // if not found, this is probably a feedback loop
                     bufIndex = getReadOnlyEmptyBuffer();
+                    delayedNode = (uint32) zeroNodeID;
                     jassert (bufIndex >= 0);
                 }
 
@@ -392,7 +777,7 @@ private:
                     // need to use a copy of it..
                     const int newFreeBuffer = getFreeBuffer (false);
 
-                    renderingOps.add (new CopyChannelOp (bufIndex, newFreeBuffer));
+                    renderingOps.addCopyChannelOp (bufIndex, newFreeBuffer);
 
                     bufIndex = newFreeBuffer;
                 }
@@ -400,7 +785,7 @@ private:
                 const int nodeDelay = getNodeDelay (srcNode);
 
                 if (nodeDelay < maxLatency)
-                    renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay));
+                    renderingOps.addDelayChannelOp (bufIndex, maxLatency - nodeDelay, delayedNode, srcChan);
             }
             else
             {
@@ -426,7 +811,8 @@ private:
 
                         const int nodeDelay = getNodeDelay (sourceNodes.getUnchecked (i));
                         if (nodeDelay < maxLatency)
-                            renderingOps.add (new DelayChannelOp (sourceBufIndex, maxLatency - nodeDelay));
+                            renderingOps.addDelayChannelOp (sourceBufIndex, maxLatency - nodeDelay,
+                                                            sourceNodes.getUnchecked (i), sourceOutputChans.getUnchecked (i));
 
                         break;
                     }
@@ -443,18 +829,20 @@ private:
                     if (srcIndex < 0)
                     {
                         // if not found, this is probably a feedback loop
-                        renderingOps.add (new ClearChannelOp (bufIndex));
+                        renderingOps.addClearChannelOp (bufIndex);
                     }
                     else
                     {
-                        renderingOps.add (new CopyChannelOp (srcIndex, bufIndex));
+                        renderingOps.addCopyChannelOp (srcIndex, bufIndex);
                     }
 
                     reusableInputIndex = 0;
                     const int nodeDelay = getNodeDelay (sourceNodes.getFirst());
 
                     if (nodeDelay < maxLatency)
-                        renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay));
+                        renderingOps.addDelayChannelOp (bufIndex, maxLatency - nodeDelay,
+                                                        srcIndex < 0 ? (uint32) zeroNodeID : sourceNodes.getFirst(),
+                                                        sourceOutputChans.getFirst());
                 }
 
                 for (int j = 0; j < sourceNodes.size(); ++j)
@@ -473,18 +861,20 @@ private:
                                                            sourceNodes.getUnchecked(j),
                                                            sourceOutputChans.getUnchecked(j)))
                                 {
-                                    renderingOps.add (new DelayChannelOp (srcIndex, maxLatency - nodeDelay));
+                                    renderingOps.addDelayChannelOp (srcIndex, maxLatency - nodeDelay,
+                                                                    sourceNodes.getUnchecked (j), sourceOutputChans.getUnchecked (j));
                                 }
                                 else // buffer is reused elsewhere, can't be delayed
                                 {
                                     const int bufferToDelay = getFreeBuffer (false);
-                                    renderingOps.add (new CopyChannelOp (srcIndex, bufferToDelay));
-                                    renderingOps.add (new DelayChannelOp (bufferToDelay, maxLatency - nodeDelay));
+                                    renderingOps.addCopyChannelOp (srcIndex, bufferToDelay);
+                                    renderingOps.addDelayChannelOp (bufferToDelay, maxLatency - nodeDelay,
+                                                                    sourceNodes.getUnchecked (j), sourceOutputChans.getUnchecked (j));
                                     srcIndex = bufferToDelay;
                                 }
                             }
 
-                            renderingOps.add (new AddChannelOp (srcIndex, bufIndex));
+                            renderingOps.addAddChannelOp (srcIndex, bufIndex);
                         }
                     }
                 }
@@ -509,11 +899,11 @@ private:
         // Now the same thing for midi..
         Array <uint32> midiSourceNodes;
 
-        for (int i = graph.getNumConnections(); --i >= 0;)
+        for (int i = 0; i < inputs.size(); ++i)
         {
-            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+            const AudioProcessorGraph::Connection* const c = inputs.getUnchecked(i);
 
-            if (c->destNodeId == node->nodeId && c->destChannelIndex == AudioProcessorGraph::midiChannelIndex)
+            if (c->destChannelIndex == AudioProcessorGraph::midiChannelIndex)
                 midiSourceNodes.add (c->sourceNodeId);
         }
 
@@ -523,7 +913,7 @@ private:
             midiBufferToUse = getFreeBuffer (true); // need to pick a buffer even if the processor doesn't use midi
 
             if (node->getProcessor()->acceptsMidi() || node->getProcessor()->producesMidi())
-                renderingOps.add (new ClearMidiBufferOp (midiBufferToUse));
+                renderingOps.addClearMidiBufferOp (midiBufferToUse);
         }
         else if (midiSourceNodes.size() == 1)
         {
@@ -541,7 +931,7 @@ private:
                     // can't mess up this channel because it's needed later by another node, so we
                     // need to use a copy of it..
                     const int newFreeBuffer = getFreeBuffer (true);
-                    renderingOps.add (new CopyMidiBufferOp (midiBufferToUse, newFreeBuffer));
+                    renderingOps.addCopyMidiBufferOp (midiBufferToUse, newFreeBuffer);
                     midiBufferToUse = newFreeBuffer;
                 }
             }
@@ -583,9 +973,9 @@ private:
                 const int srcIndex = getBufferContaining (midiSourceNodes.getUnchecked(0),
                                                           AudioProcessorGraph::midiChannelIndex);
                 if (srcIndex >= 0)
-                    renderingOps.add (new CopyMidiBufferOp (srcIndex, midiBufferToUse));
+                    renderingOps.addCopyMidiBufferOp (srcIndex, midiBufferToUse);
                 else
-                    renderingOps.add (new ClearMidiBufferOp (midiBufferToUse));
+                    renderingOps.addClearMidiBufferOp (midiBufferToUse);
 
                 reusableInputIndex = 0;
             }
@@ -597,7 +987,7 @@ private:
                     const int srcIndex = getBufferContaining (midiSourceNodes.getUnchecked(j),
                                                               AudioProcessorGraph::midiChannelIndex);
                     if (srcIndex >= 0)
-                        renderingOps.add (new AddMidiBufferOp (srcIndex, midiBufferToUse));
+                        renderingOps.addAddMidiBufferOp (srcIndex, midiBufferToUse);
                 }
             }
         }
@@ -611,8 +1001,8 @@ private:
         if (numOuts == 0)
             totalLatency = maxLatency;
 
-        renderingOps.add (new ProcessBufferOp (node, audioChannelsToUse,
-                                               totalChans, midiBufferToUse));
+        renderingOps.addProcessBufferOp (node, audioChannelsToUse,
+                                         totalChans, midiBufferToUse);
     }
 
     //==============================================================================
@@ -620,7 +1010,7 @@ private:
     {
         if (forMidi)
         {
-            for (int i = 1; i < midiNodeIds.size(); ++i)
+            for (int i = 1; reuseFreeBuffers && i < midiNodeIds.size(); ++i)
                 if (midiNodeIds.getUnchecked(i) == freeNodeID)
                     return i;
 
@@ -629,7 +1019,7 @@ private:
         }
         else
         {
-            for (int i = 1; i < nodeIds.size(); ++i)
+            for (int i = 1; reuseFreeBuffers && i < nodeIds.size(); ++i)
                 if (nodeIds.getUnchecked(i) == freeNodeID)
                     return i;
 
@@ -688,33 +1078,23 @@ private:
         }
     }
 
-    bool isBufferNeededLater (int stepIndexToSearchFrom,
-                              int inputChannelOfIndexToIgnore,
+    /** True if any node from stepIndexToSearchFrom onwards reads this output (apart
+        from the given input of the node at stepIndexToSearchFrom itself). */
+    bool isBufferNeededLater (const int stepIndexToSearchFrom,
+                              const int inputChannelOfIndexToIgnore,
                               const uint32 nodeId,
                               const int outputChanIndex) const
     {
-        while (stepIndexToSearchFrom < orderedNodes.size())
-        {
-            const AudioProcessorGraph::Node* const node = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (stepIndexToSearchFrom);
+        const Array<Consumer>& consumers = nodeConnections.getUnchecked (getStepOf (nodeId))->consumers;
 
-            if (outputChanIndex == AudioProcessorGraph::midiChannelIndex)
-            {
-                if (inputChannelOfIndexToIgnore != AudioProcessorGraph::midiChannelIndex
-                     && graph.getConnectionBetween (nodeId, AudioProcessorGraph::midiChannelIndex,
-                                                    node->nodeId, AudioProcessorGraph::midiChannelIndex) != nullptr)
-                    return true;
-            }
-            else
-            {
-                for (int i = 0; i < node->getProcessor()->getNumInputChannels(); ++i)
-                    if (i != inputChannelOfIndexToIgnore
-                         && graph.getConnectionBetween (nodeId, outputChanIndex,
-                                                        node->nodeId, i) != nullptr)
-                        return true;
-            }
+        for (int i = consumers.size(); --i >= 0;)
+        {
+            const Consumer& c = consumers.getReference (i);
 
-            inputChannelOfIndexToIgnore = -1;
-            ++stepIndexToSearchFrom;
+            if (c.sourceChannel == outputChanIndex
+                 && (c.destStep > stepIndexToSearchFrom
+                      || (c.destStep == stepIndexToSearchFrom && c.destChannel != inputChannelOfIndexToIgnore)))
+                return true;
         }
 
         return false;
@@ -741,136 +1121,656 @@ private:
 };
 
 //==============================================================================
-// Holds a fast lookup table for checking which nodes are inputs to others.
-class ConnectionLookupTable
+/** Keeps the graph's nodes in rendering order - every node after the nodes that feed
+    it, apart from feedback loops - as connections are added.
+
+    Rather than re-sorting the whole graph, a new connection that goes against the
+    current order only moves its destination, and whatever is downstream of it that
+    currently renders before the source, to just after the source. Everything else
+    stays where it is. (Removing a connection or a node never breaks the order.)
+*/
+struct RenderOrderUpdater
 {
-public:
-    explicit ConnectionLookupTable (const OwnedArray<AudioProcessorGraph::Connection>& connections)
+    static void connectionAdded (Array<void*>& order,
+                                 const OwnedArray<AudioProcessorGraph::Connection>& connections,
+                                 const uint32 sourceNodeId, const uint32 destNodeId)
     {
-        for (int i = 0; i < connections.size(); ++i)
-        {
-            const AudioProcessorGraph::Connection* const c = connections.getUnchecked(i);
+        HashMap<int, int> positions (jmax (101, order.size() * 2));
 
-            int index;
-            Entry* entry = findEntry (c->destNodeId, index);
+        for (int i = 0; i < order.size(); ++i)
+            positions.set ((int) ((const AudioProcessorGraph::Node*) order.getUnchecked(i))->nodeId, i);
 
-            if (entry == nullptr)
-            {
-                entry = new Entry (c->destNodeId);
-                entries.insert (index, entry);
-            }
+        const int sourcePos = positions [(int) sourceNodeId];
+        const int destPos = positions [(int) destNodeId];
+
+        if (destPos > sourcePos)
+            return;
+
+        SortedSet<int> positionsToMove;
+        positionsToMove.add (destPos);
+
+        Array<uint32> nodesToVisit;
+        nodesToVisit.add (destNodeId);
+
+        while (nodesToVisit.size() > 0)
+        {
+            const uint32 nodeId = nodesToVisit.getLast();
+            nodesToVisit.removeLast();
+
+            for (int i = indexOfFirstConnectionFrom (connections, nodeId);
+                 i < connections.size() && connections.getUnchecked(i)->sourceNodeId == nodeId; ++i)
+            {
+                const uint32 nextId = connections.getUnchecked(i)->destNodeId;
+                const int nextPos = positions [(int) nextId];
 
-            entry->srcNodes.add (c->sourceNodeId);
+                if (nextPos == sourcePos)
+                    return; // a feedback loop, so no order will satisfy it
+
+                if (nextPos < sourcePos && ! positionsToMove.contains (nextPos))
+                {
+                    positionsToMove.add (nextPos);
+                    nodesToVisit.add (nextId);
+                }
+            }
         }
+
+        Array<void*> nodesToMove;
+
+        for (int i = 0; i < positionsToMove.size(); ++i)
+            nodesToMove.add (order.getUnchecked (positionsToMove.getUnchecked(i)));
+
+        for (int i = positionsToMove.size(); --i >= 0;)
+            order.remove (positionsToMove.getUnchecked(i));
+
+        // all of them were before the source, which has moved up to fill the gap
+        order.insertArray (sourcePos - nodesToMove.size() + 1, nodesToMove.getRawDataPointer(), nodesToMove.size());
     }
 
-    bool isAnInputTo (const uint32 possibleInputId,
-                      const uint32 possibleDestinationId) const noexcept
+private:
+    // The connections are sorted by source node first.
+    static int indexOfFirstConnectionFrom (const OwnedArray<AudioProcessorGraph::Connection>& connections,
+                                           const uint32 sourceNodeId) noexcept
     {
-        return isAnInputToRecursive (possibleInputId, possibleDestinationId, entries.size());
+        int start = 0;
+        int end = connections.size();
+
+        while (start < end)
+        {
+            const int halfway = (start + end) / 2;
+
+            if (connections.getUnchecked (halfway)->sourceNodeId < sourceNodeId)
+                start = halfway + 1;
+            else
+                end = halfway;
+        }
+
+        return start;
     }
+};
 
-private:
-    //==============================================================================
-    struct Entry
+//==============================================================================
+struct ConnectionSorter
+{
+    static int compareElements (const AudioProcessorGraph::Connection* const first,
+                                const AudioProcessorGraph::Connection* const second) noexcept
     {
-        explicit Entry (const uint32 destNodeId_) noexcept : destNodeId (destNodeId_) {}
+        if (first->sourceNodeId < second->sourceNodeId)                return -1;
+        if (first->sourceNodeId > second->sourceNodeId)                return 1;
+        if (first->destNodeId < second->destNodeId)                    return -1;
+        if (first->destNodeId > second->destNodeId)                    return 1;
+        if (first->sourceChannelIndex < second->sourceChannelIndex)    return -1;
+        if (first->sourceChannelIndex > second->sourceChannelIndex)    return 1;
+        if (first->destChannelIndex < second->destChannelIndex)        return -1;
+        if (first->destChannelIndex > second->destChannelIndex)        return 1;
 
-        const uint32 destNodeId;
-        SortedSet<uint32> srcNodes;
+        return 0;
+    }
+};
 
-        JUCE_DECLARE_NON_COPYABLE (Entry)
-    };
+}
+
+//==============================================================================
+/** A rendering sequence split into one task per node (the node's ProcessBufferOp
+    and the ops that prepare its buffers), plus the dependencies between them.
 
-    OwnedArray<Entry> entries;
+    Tasks with no path between them touch disjoint buffers, so the renderer may
+    run them in any order, or at the same time, and still produce exactly the
+    same data as the serial sequence.
 
-    bool isAnInputToRecursive (const uint32 possibleInputId,
-                               const uint32 possibleDestinationId,
-                               int recursionCheck) const noexcept
+    It also holds the per-block scheduling state, so that nothing needs to be
+    allocated on the audio thread.
+*/
+class AudioProcessorGraph::RenderingTasks
+{
+public:
+    RenderingTasks (const GraphRenderingOps::RenderingOpSequence& renderingOps, const int numAudioBuffers,
+                    const int numMidiBuffers, const int numQueues_)
+        : numQueues (numQueues_),
+          maxReadyTasks (1)
     {
-        int index;
+        using namespace GraphRenderingOps;
+        BufferDependencyTracker tracker (numAudioBuffers, numMidiBuffers, renderingOps.getNumDelayLines());
 
-        if (const Entry* const entry = findEntry (possibleDestinationId, index))
+        for (int i = 0; i < renderingOps.size(); ++i)
         {
-            const SortedSet<uint32>& srcNodes = entry->srcNodes;
+            if (taskEnds.size() == tracker.getNumTasks())
+                tracker.startTask();
 
-            if (srcNodes.contains (possibleInputId))
-                return true;
+            renderingOps.addBufferAccesses (i, tracker);
+
+            // each node's ops end with its ProcessBufferOp
+            if (renderingOps.isProcessBufferOp (i) || i == renderingOps.size() - 1)
+                taskEnds.add (i + 1);
+        }
+
+        const int numTasks = taskEnds.size();
+        Array<int> numSuccessors;
+        numSuccessors.insertMultiple (0, 0, numTasks);
+
+        for (int i = 0; i < numTasks; ++i)
+        {
+            const SortedSet<int>& deps = tracker.getDependencies (i);
+            numDependencies.add (deps.size());
+
+            if (deps.size() == 0)
+                rootTasks.add (i);
+
+            for (int j = deps.size(); --j >= 0;)
+                numSuccessors.set (deps.getUnchecked(j), numSuccessors.getUnchecked (deps.getUnchecked(j)) + 1);
+        }
+
+        for (int i = 0; i < numTasks; ++i)
+        {
+            successorStarts.add (successors.size());
+            successors.insertMultiple (-1, -1, numSuccessors.getUnchecked(i));
+            maxReadyTasks = jmax (maxReadyTasks, numSuccessors.getUnchecked(i));
+        }
+
+        successorStarts.add (successors.size());
+        maxReadyTasks = jmax (maxReadyTasks, rootTasks.size());
 
-            if (--recursionCheck >= 0)
+        for (int i = 0; i < numTasks; ++i)
+        {
+            const SortedSet<int>& deps = tracker.getDependencies (i);
+
+            for (int j = 0; j < deps.size(); ++j)
             {
-                for (int i = 0; i < srcNodes.size(); ++i)
-                    if (isAnInputToRecursive (possibleInputId, srcNodes.getUnchecked(i), recursionCheck))
-                        return true;
+                const int dep = deps.getUnchecked(j);
+                const int slot = successorStarts.getUnchecked (dep) + --numSuccessors.getReference (dep);
+                successors.set (slot, i);
             }
         }
 
-        return false;
+        pendingDependencies.calloc ((size_t) jmax (1, numTasks));
+        queueStorage.calloc ((size_t) (jmax (1, numTasks) * numQueues));
     }
 
-    Entry* findEntry (const uint32 destNodeId, int& insertIndex) const noexcept
+    int getNumTasks() const noexcept                    { return taskEnds.size(); }
+    int getNumQueues() const noexcept                   { return numQueues; }
+    int getFirstOp (const int task) const noexcept      { return task > 0 ? taskEnds.getUnchecked (task - 1) : 0; }
+    int getEndOp (const int task) const noexcept        { return taskEnds.getUnchecked (task); }
+
+    /** False if the tasks form a single chain, in which case there's nothing
+        to be gained from handing them to other threads. */
+    bool canRunInParallel() const noexcept              { return getNumTasks() > 1 && maxReadyTasks > 1; }
+
+    //==============================================================================
+    // Scheduling state for the block being rendered
+    void resetPendingDependencies() noexcept
     {
-        Entry* result = nullptr;
+        for (int i = getNumTasks(); --i >= 0;)
+            pendingDependencies[i].set (numDependencies.getUnchecked(i));
+    }
 
-        int start = 0;
-        int end = entries.size();
+    const Array<int>& getRootTasks() const noexcept     { return rootTasks; }
+
+    /** Called when a task has finished: hands each successor whose last dependency
+        this was to the given queue. */
+    template <class QueueType>
+    void releaseSuccessors (const int task, QueueType& queue) noexcept
+    {
+        const int end = successorStarts.getUnchecked (task + 1);
 
-        for (;;)
+        for (int i = successorStarts.getUnchecked (task); i < end; ++i)
         {
-            if (start >= end)
+            const int successor = successors.getUnchecked(i);
+
+            if (--(pendingDependencies[successor]) == 0)
+                queue.push (successor);
+        }
+    }
+
+    int* getQueueStorage (const int queue) const noexcept   { return queueStorage + queue * jmax (1, getNumTasks()); }
+
+private:
+    const int numQueues;
+    Array<int> taskEnds, numDependencies, successorStarts, successors, rootTasks;
+    int maxReadyTasks;
+
+    HeapBlock<Atomic<int> > pendingDependencies;
+    HeapBlock<int> queueStorage;
+
+    JUCE_DECLARE_NON_COPYABLE (RenderingTasks)
+};
+
+//==============================================================================
+/** Threads that render a block's independent tasks alongside the audio thread.
+
+    Every thread, including the audio thread, owns a deque of ready tasks: it pushes
+    the successors it releases onto the bottom and pops from there too, so a chain of
+    nodes tends to stay on one core. A thread whose own deque is empty steals from
+    the top of the others'. Nothing allocates or locks while rendering: idle workers
+    sleep on a semaphore, which the audio thread posts once per worker for each block.
+
+    The audio thread spins until the workers are done, so a worker that gets preempted
+    stalls the whole block. The workers therefore run with realtime scheduling, and a
+    pool whose workers can't get it is no use: see areWorkersRealtime().
+
+    Each RenderingProgram built for the pool holds a reference to it, so a pool that
+    has been replaced keeps running until the audio thread has moved on.
+*/
+class AudioProcessorGraph::RenderThreadPool  : public ReferenceCountedObject
+{
+public:
+    typedef ReferenceCountedObjectPtr<RenderThreadPool> Ptr;
+
+    RenderThreadPool (const int numThreads)
+        : currentTasks (nullptr), currentOps (nullptr),
+          currentBuffers (nullptr), currentMidiBuffers (nullptr),
+          currentNumSamples (0), workersAreRealtime (true)
+    {
+        queues.add (new TaskQueue()); // the audio thread's
+
+        for (int i = 0; i < numThreads; ++i)
+        {
+            queues.add (new TaskQueue());
+
+            RenderThread* const thread = new RenderThread (*this, i + 1);
+            workers.add (thread);
+            thread->startThread();
+        }
+
+        for (int i = 0; i < workers.size(); ++i)
+        {
+            RenderThread* const thread = workers.getUnchecked(i);
+            thread->started.wait();
+
+            if (! thread->isRealtime)
+                workersAreRealtime = false;
+        }
+    }
+
+    ~RenderThreadPool()
+    {
+        for (int i = workers.size(); --i >= 0;)
+            workers.getUnchecked(i)->signalThreadShouldExit();
+
+        for (int i = workers.size(); --i >= 0;)
+            wakeUp.post();
+
+        for (int i = workers.size(); --i >= 0;)
+            workers.getUnchecked(i)->stopThread (1000);
+
+        workers.clear();
+    }
+
+    int getNumThreads() const noexcept      { return workers.size(); }
+
+    /** False if any of the workers was refused realtime scheduling, in which case
+        the pool shouldn't be used.
+    */
+    bool areWorkersRealtime() const noexcept    { return workersAreRealtime; }
+
+    bool canRender (const RenderingTasks& tasks) const noexcept
+    {
+        return tasks.getNumQueues() == queues.size() && tasks.canRunInParallel();
+    }
+
+    /** Renders one block, returning once every task is done. */
+    void render (RenderingTasks& tasks, GraphRenderingOps::RenderingOpSequence& ops, AudioSampleBuffer& buffers,
+                 const OwnedArray <MidiBuffer>& midiBuffers, const int numSamples) noexcept
+    {
+        jassert (canRender (tasks));
+
+        // no worker can be looking at any of this while blockActive is clear
+        currentTasks = &tasks;
+        currentOps = &ops;
+        currentBuffers = &buffers;
+        currentMidiBuffers = &midiBuffers;
+        currentNumSamples = numSamples;
+        completedTasks.set (0);
+
+        tasks.resetPendingDependencies();
+
+        for (int i = queues.size(); --i >= 0;)
+            queues.getUnchecked(i)->reset (tasks.getQueueStorage (i));
+
+        TaskQueue& audioThreadQueue = *queues.getUnchecked(0);
+        const Array<int>& roots = tasks.getRootTasks();
+
+        for (int i = roots.size(); --i >= 0;)
+            audioThreadQueue.push (roots.getUnchecked(i));
+
+        blockActive.set (1);
+
+        for (int i = workers.size(); --i >= 0;)
+            wakeUp.post();
+
+        runTasks (0);
+        blockActive.set (0);
+
+        while (busyWorkers.get() != 0)
+        {} // spin: a worker is on its way out of runTasks()
+    }
+
+private:
+    //==============================================================================
+    /** A Chase-Lev deque of task indices. Each task is pushed once per block, so the
+        storage (one slot per task) never needs to wrap around. */
+    struct TaskQueue
+    {
+        TaskQueue() noexcept : tasks (nullptr) {}
+
+        void reset (int* const storage) noexcept
+        {
+            tasks = storage;
+            top.set (0);
+            bottom.set (0);
+        }
+
+        // Owner only
+        void push (const int task) noexcept
+        {
+            const int b = bottom.get();
+            tasks[b] = task;
+            bottom.set (b + 1);
+        }
+
+        // Owner only
+        int pop() noexcept
+        {
+            const int b = bottom.get() - 1;
+            bottom.set (b);
+            const int t = top.get();
+
+            if (t > b)
             {
-                break;
+                bottom.set (t);
+                return -1;
             }
-            else if (destNodeId == entries.getUnchecked (start)->destNodeId)
+
+            const int task = tasks[b];
+
+            if (t == b)
             {
-                result = entries.getUnchecked (start);
-                break;
+                // last one: race any thieves for it
+                const bool won = top.compareAndSetBool (t + 1, t);
+                bottom.set (t + 1);
+                return won ? task : -1;
             }
-            else
-            {
-                const int halfway = (start + end) / 2;
 
-                if (halfway == start)
-                {
-                    if (destNodeId >= entries.getUnchecked (halfway)->destNodeId)
-                        ++start;
+            return task;
+        }
+
+        // Any thread
+        int steal() noexcept
+        {
+            const int t = top.get();
+
+            if (t >= bottom.get())
+                return -1;
+
+            const int task = tasks[t];
+            return top.compareAndSetBool (t + 1, t) ? task : -1;
+        }
+
+        int* tasks;
+        Atomic<int> top, bottom;
+
+        JUCE_DECLARE_NON_COPYABLE (TaskQueue)
+    };
 
+    //==============================================================================
+    /** A counting semaphore. Posting it never blocks, so the audio thread can wake
+        the workers with it. */
+    class Semaphore
+    {
+    public:
+       #if JUCE_MAC || JUCE_IOS
+        Semaphore()         { semaphore_create (mach_task_self(), &semaphore, SYNC_POLICY_FIFO, 0); }
+        ~Semaphore()        { semaphore_destroy (mach_task_self(), semaphore); }
+        void post()         { semaphore_signal (semaphore); }
+        void wait()         { while (semaphore_wait (semaphore) == KERN_ABORTED) {} }
+       #elif JUCE_WINDOWS
+        Semaphore()         { semaphore = CreateSemaphore (0, 0, 0x7fffffff, 0); }
+        ~Semaphore()        { CloseHandle (semaphore); }
+        void post()         { ReleaseSemaphore (semaphore, 1, 0); }
+        void wait()         { WaitForSingleObject (semaphore, INFINITE); }
+       #else
+        Semaphore()         { sem_init (&semaphore, 0, 0); }
+        ~Semaphore()        { sem_destroy (&semaphore); }
+        void post()         { sem_post (&semaphore); }
+        void wait()         { while (sem_wait (&semaphore) != 0 && errno == EINTR) {} }
+       #endif
+
+    private:
+       #if JUCE_MAC || JUCE_IOS
+        semaphore_t semaphore;
+       #elif JUCE_WINDOWS
+        HANDLE semaphore;
+       #else
+        sem_t semaphore;
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE (Semaphore)
+    };
+
+    //==============================================================================
+    class RenderThread  : public Thread
+    {
+    public:
+        RenderThread (RenderThreadPool& pool_, const int queueIndex_)
+            : Thread ("AudioProcessorGraph renderer"),
+              isRealtime (false), pool (pool_), queueIndex (queueIndex_)
+        {}
+
+        void run()
+        {
+            isRealtime = Thread::setCurrentThreadRealtimePriority (realtimePriority);
+            started.signal();
+
+            if (! isRealtime)
+                return;
+
+            for (;;)
+            {
+                pool.wakeUp.wait();
+
+                if (threadShouldExit())
                     break;
-                }
-                else if (destNodeId >= entries.getUnchecked (halfway)->destNodeId)
-                    start = halfway;
-                else
-                    end = halfway;
+
+                // (a late wake-up can find the block already finished, or the next one started)
+                ++(pool.busyWorkers);
+
+                if (pool.blockActive.get() != 0)
+                    pool.runTasks (queueIndex);
+
+                --(pool.busyWorkers);
             }
         }
 
-        insertIndex = start;
-        return result;
+        WaitableEvent started;
+        bool isRealtime; // set before started is signalled
+
+    private:
+        RenderThreadPool& pool;
+        const int queueIndex;
+
+        JUCE_DECLARE_NON_COPYABLE (RenderThread)
+    };
+
+    //==============================================================================
+    enum { realtimePriority = 70 };     // 1..99: above ordinary threads, so nothing preempts a worker mid-block
+
+    OwnedArray<TaskQueue> queues;
+    OwnedArray<RenderThread> workers;
+
+    RenderingTasks* currentTasks;
+    GraphRenderingOps::RenderingOpSequence* currentOps;
+    AudioSampleBuffer* currentBuffers;
+    const OwnedArray <MidiBuffer>* currentMidiBuffers;
+    int currentNumSamples;
+    bool workersAreRealtime;
+
+    Atomic<int> blockActive, busyWorkers, completedTasks;
+    Semaphore wakeUp;
+
+    void runTasks (const int queueIndex) noexcept
+    {
+        TaskQueue& ownQueue = *queues.getUnchecked (queueIndex);
+        const int numQueues = queues.size();
+        const int numTasks = currentTasks->getNumTasks();
+
+        while (completedTasks.get() < numTasks)
+        {
+            int task = ownQueue.pop();
+
+            for (int i = 1; task < 0 && i < numQueues; ++i)
+                task = queues.getUnchecked ((queueIndex + i) % numQueues)->steal();
+
+            if (task >= 0)
+            {
+                currentOps->perform (currentTasks->getFirstOp (task), currentTasks->getEndOp (task),
+                                     *currentBuffers, *currentMidiBuffers, currentNumSamples);
+
+                currentTasks->releaseSuccessors (task, ownQueue);
+                ++completedTasks;
+            }
+        }
     }
 
-    JUCE_DECLARE_NON_COPYABLE (ConnectionLookupTable)
+    JUCE_DECLARE_NON_COPYABLE (RenderThreadPool)
 };
 
 //==============================================================================
-struct ConnectionSorter
+/** Everything the audio thread needs to render the graph: the ops, the buffers
+    they work on and, when rendering in parallel, the task graph and thread pool.
+
+    A published program is never touched by the message thread again. Graph edits
+    build a new one and swap it in, and the old one is deleted once the audio
+    thread has moved on to the new one.
+*/
+class AudioProcessorGraph::RenderingProgram
 {
-    static int compareElements (const AudioProcessorGraph::Connection* const first,
-                                const AudioProcessorGraph::Connection* const second) noexcept
+public:
+    RenderingProgram (GraphRenderingOps::RenderingOpSequence* const ops_, const int numBuffers,
+                      const int numMidiBuffers, const int blockSize, RenderThreadPool* const pool_)
+        : ops (ops_),
+          buffers (numBuffers, jmax (1, blockSize)),
+          pool (pool_)
     {
-        if (first->sourceNodeId < second->sourceNodeId)                return -1;
-        if (first->sourceNodeId > second->sourceNodeId)                return 1;
-        if (first->destNodeId < second->destNodeId)                    return -1;
-        if (first->destNodeId > second->destNodeId)                    return 1;
-        if (first->sourceChannelIndex < second->sourceChannelIndex)    return -1;
-        if (first->sourceChannelIndex > second->sourceChannelIndex)    return 1;
-        if (first->destChannelIndex < second->destChannelIndex)        return -1;
-        if (first->destChannelIndex > second->destChannelIndex)        return 1;
+        // Every op works on whole channels from offset 0, so the FloatVectorOperations
+        // calls always get aligned data, and channels rendered on different threads
+        // never share a cache line.
+        jassert (buffers.isSimdAligned());
+        buffers.clear();
 
-        return 0;
+        for (int i = 0; i < numMidiBuffers; ++i)
+            midiBuffers.add (new MidiBuffer());
+
+        if (pool != nullptr)
+            tasks = new RenderingTasks (*ops, numBuffers, numMidiBuffers, pool->getNumThreads() + 1);
     }
+
+    /** The most samples that render() can be asked for at once. */
+    int getBlockSize() const noexcept       { return buffers.getNumSamples(); }
+
+    void render (const int numSamples) noexcept
+    {
+        if (pool != nullptr && pool->canRender (*tasks))
+            pool->render (*tasks, *ops, buffers, midiBuffers, numSamples);
+        else
+            ops->perform (0, ops->size(), buffers, midiBuffers, numSamples);
+    }
+
+private:
+    const ScopedPointer<GraphRenderingOps::RenderingOpSequence> ops;
+    AudioSampleBuffer buffers;
+    OwnedArray <MidiBuffer> midiBuffers;
+    ScopedPointer<RenderingTasks> tasks;
+    const RenderThreadPool::Ptr pool;
+
+    JUCE_DECLARE_NON_COPYABLE (RenderingProgram)
 };
 
-}
+//==============================================================================
+/** Programs that have been swapped out, waiting for the audio thread to finish
+    with them.
+
+    The audio thread bumps the graph's callback counter on the way into and out of
+    processBlock, so an odd count means it's inside. A program swapped out while
+    the count was even can't be in use (the next callback will pick up its
+    replacement); otherwise it's safe to delete as soon as the count has moved on.
+*/
+class AudioProcessorGraph::RetiredPrograms  : private Timer
+{
+public:
+    RetiredPrograms (const Atomic<int>& callbackCount_)
+        : callbackCount (callbackCount_)
+    {}
+
+    ~RetiredPrograms()
+    {
+        stopTimer();
+    }
+
+    void retire (RenderingProgram* const program)
+    {
+        const int count = callbackCount.get();
+
+        if ((count & 1) == 0)
+        {
+            delete program;
+        }
+        else if (program != nullptr)
+        {
+            programs.add (program);
+            countsWhenRetired.add (count);
+            startTimer (retryIntervalMs);
+        }
+    }
+
+    void releaseFinishedPrograms()
+    {
+        const int count = callbackCount.get();
+
+        for (int i = programs.size(); --i >= 0;)
+        {
+            if (countsWhenRetired.getUnchecked(i) != count)
+            {
+                programs.remove (i);
+                countsWhenRetired.remove (i);
+            }
+        }
+
+        if (programs.size() == 0)
+            stopTimer();
+    }
+
+private:
+    enum { retryIntervalMs = 20 };
+
+    const Atomic<int>& callbackCount;
+    OwnedArray<RenderingProgram> programs;
+    Array<int> countsWhenRetired;
+
+    void timerCallback()
+    {
+        releaseFinishedPrograms();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (RetiredPrograms)
+};
 
 //==============================================================================
 AudioProcessorGraph::Connection::Connection (const uint32 sourceNodeId_, const int sourceChannelIndex_,
@@ -924,9 +1824,11 @@ void AudioProcessorGraph::Node::setParentGraph (AudioProcessorGraph* const graph
 //==============================================================================
 AudioProcessorGraph::AudioProcessorGraph()
     : lastNodeId (0),
-      renderingBuffers (1, 1),
+      changeBatchDepth (0),
+      changesPending (false),
       currentAudioOutputBuffer (1, 1)
 {
+    retiredPrograms = new RetiredPrograms (callbackCount);
 }
 
 AudioProcessorGraph::~AudioProcessorGraph()
@@ -945,7 +1847,8 @@ void AudioProcessorGraph::clear()
 {
     nodes.clear();
     connections.clear();
-    triggerAsyncUpdate();
+    renderOrder.clear();
+    renderingSequenceChanged();
 }
 
 AudioProcessorGraph::Node* AudioProcessorGraph::getNodeForId (const uint32 nodeId) const
@@ -992,7 +1895,8 @@ AudioProcessorGraph::Node* AudioProcessorGraph::addNode (AudioProcessor* const n
 
     Node* const n = new Node (nodeId, newProcessor);
     nodes.add (n);
-    triggerAsyncUpdate();
+    renderOrder.add (n);
+    renderingSequenceChanged();
 
     n->setParentGraph (this);
     return n;
@@ -1007,8 +1911,9 @@ bool AudioProcessorGraph::removeNode (const uint32 nodeId)
         if (nodes.getUnchecked(i)->nodeId == nodeId)
         {
             nodes.getUnchecked(i)->setParentGraph (nullptr);
+            renderOrder.removeFirstMatchingValue (nodes.getUnchecked(i));
             nodes.remove (i);
-            triggerAsyncUpdate();
+            renderingSequenceChanged();
 
             return true;
         }
@@ -1085,14 +1990,16 @@ bool AudioProcessorGraph::addConnection (const uint32 sourceNodeId,
     GraphRenderingOps::ConnectionSorter sorter;
     connections.addSorted (sorter, new Connection (sourceNodeId, sourceChannelIndex,
                                                    destNodeId, destChannelIndex));
-    triggerAsyncUpdate();
+
+    GraphRenderingOps::RenderOrderUpdater::connectionAdded (renderOrder, connections, sourceNodeId, destNodeId);
+    renderingSequenceChanged();
     return true;
 }
 
 void AudioProcessorGraph::removeConnection (const int index)
 {
     connections.remove (index);
-    triggerAsyncUpdate();
+    renderingSequenceChanged();
 }
 
 bool AudioProcessorGraph::removeConnection (const uint32 sourceNodeId, const int sourceChannelIndex,
@@ -1167,22 +2074,46 @@ bool AudioProcessorGraph::removeIllegalConnections()
 }
 
 //==============================================================================
-static void deleteRenderOpArray (Array<void*>& ops)
+void AudioProcessorGraph::publishRenderingProgram (RenderingProgram* const newProgram)
 {
-    for (int i = ops.size(); --i >= 0;)
-        delete static_cast<GraphRenderingOps::AudioGraphRenderingOp*> (ops.getUnchecked(i));
+    retiredPrograms->releaseFinishedPrograms();
+    retiredPrograms->retire (currentProgram.exchange (newProgram));
 }
 
 void AudioProcessorGraph::clearRenderingSequence()
 {
-    Array<void*> oldOps;
+    publishRenderingProgram (nullptr);
+}
+
+void AudioProcessorGraph::setNumRenderThreads (int numThreads)
+{
+    // The workers spin while a block is being rendered, so they each need a core
+    // that the audio thread isn't using.
+    numThreads = jlimit (0, jmax (0, SystemStats::getNumCpus() - 1), numThreads);
 
+    if (numThreads != getNumRenderThreads())
     {
-        const ScopedLock sl (getCallbackLock());
-        renderingOps.swapWithArray (oldOps);
+        RenderThreadPool::Ptr newPool (numThreads > 0 ? new RenderThreadPool (numThreads) : nullptr);
+
+        if (newPool != nullptr && ! newPool->areWorkersRealtime())
+        {
+            DBG ("AudioProcessorGraph: no realtime scheduling for the render threads, rendering serially");
+            newPool = nullptr;
+        }
+
+        if (newPool != renderThreadPool)
+        {
+            // The current program keeps the old pool alive (and working) until
+            // the rebuilt one replaces it.
+            renderThreadPool = newPool;
+            renderingSequenceChanged();
+        }
     }
+}
 
-    deleteRenderOpArray (oldOps);
+int AudioProcessorGraph::getNumRenderThreads() const noexcept
+{
+    return renderThreadPool != nullptr ? renderThreadPool->getNumThreads() : 0;
 }
 
 bool AudioProcessorGraph::isAnInputTo (const uint32 possibleInputId,
@@ -1207,62 +2138,64 @@ bool AudioProcessorGraph::isAnInputTo (const uint32 possibleInputId,
 
 void AudioProcessorGraph::buildRenderingSequence()
 {
-    Array<void*> newRenderingOps;
+    ScopedPointer<GraphRenderingOps::RenderingOpSequence> newRenderingOps (new GraphRenderingOps::RenderingOpSequence (getBlockSize()));
     int numRenderingBuffersNeeded = 2;
     int numMidiBuffersNeeded = 1;
 
     {
         MessageManagerLock mml;
 
-        Array<void*> orderedNodes;
-
-        {
-            const GraphRenderingOps::ConnectionLookupTable table (connections);
-
-            for (int i = 0; i < nodes.size(); ++i)
-            {
-                Node* const node = nodes.getUnchecked(i);
-
-                node->prepare (getSampleRate(), getBlockSize(), this);
-
-                int j = 0;
-                for (; j < orderedNodes.size(); ++j)
-                    if (table.isAnInputTo (node->nodeId, ((Node*) orderedNodes.getUnchecked(j))->nodeId))
-                      break;
-
-                orderedNodes.insert (j, node);
-            }
-        }
+        for (int i = 0; i < nodes.size(); ++i)
+            nodes.getUnchecked(i)->prepare (getSampleRate(), getBlockSize(), this);
 
-        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps);
+        // renderOrder is kept sorted as the graph is edited
+        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, renderOrder, *newRenderingOps,
+                                                                     renderThreadPool == nullptr);
 
         numRenderingBuffersNeeded = calculator.getNumBuffersNeeded();
         numMidiBuffersNeeded = calculator.getNumMidiBuffersNeeded();
     }
 
-    {
-        // swap over to the new rendering sequence..
-        const ScopedLock sl (getCallbackLock());
+    newRenderingOps->optimise();
 
-        renderingBuffers.setSize (numRenderingBuffersNeeded, getBlockSize());
-        renderingBuffers.clear();
+    // The audio thread picks up the new program on its next callback; nothing
+    // here waits for it, or blocks it.
+    publishRenderingProgram (new RenderingProgram (newRenderingOps.release(), numRenderingBuffersNeeded,
+                                                   numMidiBuffersNeeded, getBlockSize(),
+                                                   renderThreadPool));
+}
 
-        for (int i = midiBuffers.size(); --i >= 0;)
-            midiBuffers.getUnchecked(i)->clear();
+void AudioProcessorGraph::beginChanges()
+{
+    ++changeBatchDepth;
+}
 
-        while (midiBuffers.size() < numMidiBuffersNeeded)
-            midiBuffers.add (new MidiBuffer());
+void AudioProcessorGraph::commitChanges()
+{
+    jassert (changeBatchDepth > 0); // unmatched call!
 
-        renderingOps.swapWithArray (newRenderingOps);
+    if (changeBatchDepth > 0 && --changeBatchDepth == 0 && changesPending)
+    {
+        changesPending = false;
+        cancelPendingUpdate();
+        buildRenderingSequence();
     }
+}
 
-    // delete the old ones..
-    deleteRenderOpArray (newRenderingOps);
+void AudioProcessorGraph::renderingSequenceChanged()
+{
+    if (changeBatchDepth > 0)
+        changesPending = true;
+    else
+        triggerAsyncUpdate();
 }
 
 void AudioProcessorGraph::handleAsyncUpdate()
 {
-    buildRenderingSequence();
+    if (changeBatchDepth > 0)
+        changesPending = true;
+    else
+        buildRenderingSequence();
 }
 
 //==============================================================================
@@ -1282,8 +2215,7 @@ void AudioProcessorGraph::releaseResources()
     for (int i = 0; i < nodes.size(); ++i)
         nodes.getUnchecked(i)->unprepare();
 
-    renderingBuffers.setSize (1, 1);
-    midiBuffers.clear();
+    clearRenderingSequence();
 
     currentAudioInputBuffer = nullptr;
     currentAudioOutputBuffer.setSize (1, 1);
@@ -1303,25 +2235,59 @@ void AudioProcessorGraph::processBlock (AudioSampleBuffer& buffer, MidiBuffer& m
 {
     const int numSamples = buffer.getNumSamples();
 
+    ++callbackCount; // odd while we're in here: see RetiredPrograms
+
+    RenderingProgram* const program = currentProgram.get();
+
+    // The rendering buffers, delay lines and nodes are only prepared for blocks of up to
+    // the program's block size, so a bigger block from the host is rendered in pieces.
+    const int maxChunkSize = program != nullptr ? program->getBlockSize() : numSamples;
+
+    if (numSamples <= maxChunkSize)
+    {
+        renderChunk (program, buffer, midiMessages);
+    }
+    else
+    {
+        chunkMidiOutput.clear();
+
+        for (int start = 0; start < numSamples; start += maxChunkSize)
+        {
+            const int numInChunk = jmin (maxChunkSize, numSamples - start);
+            AudioSampleBuffer chunk (buffer.getArrayOfChannels(), buffer.getNumChannels(), start, numInChunk);
+
+            chunkMidi.clear();
+            chunkMidi.addEvents (midiMessages, start, numInChunk, -start);
+
+            renderChunk (program, chunk, chunkMidi);
+
+            chunkMidiOutput.addEvents (chunkMidi, 0, numInChunk, start);
+        }
+
+        midiMessages.swapWith (chunkMidiOutput);
+    }
+
+    ++callbackCount;
+}
+
+void AudioProcessorGraph::renderChunk (RenderingProgram* const program, AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
+{
+    const int numSamples = buffer.getNumSamples();
+
     currentAudioInputBuffer = &buffer;
-    currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples);
+    currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples, false, false, true);
     currentAudioOutputBuffer.clear();
     currentMidiInputBuffer = &midiMessages;
     currentMidiOutputBuffer.clear();
 
-    for (int i = 0; i < renderingOps.size(); ++i)
-    {
-        GraphRenderingOps::AudioGraphRenderingOp* const op
-            = (GraphRenderingOps::AudioGraphRenderingOp*) renderingOps.getUnchecked(i);
-
-        op->perform (renderingBuffers, midiBuffers, numSamples);
-    }
+    if (program != nullptr)
+        program->render (numSamples);
 
     for (int i = 0; i < buffer.getNumChannels(); ++i)
         buffer.copyFrom (i, 0, currentAudioOutputBuffer, i, 0, numSamples);
 
     midiMessages.clear();
-    midiMessages.addEvents (currentMidiOutputBuffer, 0, buffer.getNumSamples(), 0);
+    midiMessages.addEvents (currentMidiOutputBuffer, 0, numSamples, 0);
 }
 
 const String AudioProcessorGraph::getInputChannelName (int channelIndex) const
@@ -248,6 +248,45 @@ public:
     */
     bool removeIllegalConnections();
 
+    //==============================================================================
+    /** Holds back the rendering sequence rebuild that each edit to the graph would
+        otherwise trigger, until the matching commitChanges().
+
+        Wrap a batch of edits (e.g. loading a session) in these, so that the whole
+        batch costs a single rebuild. Calls can be nested.
+    */
+    void beginChanges();
+
+    /** Ends a batch of edits started with beginChanges().
+
+        When the outermost batch ends, the rendering sequence is rebuilt straight
+        away if anything has changed.
+    */
+    void commitChanges();
+
+    //==============================================================================
+    /** Sets the number of extra threads used to render independent nodes concurrently.
+
+        With zero (the default), every node is rendered in turn on the audio thread.
+        Otherwise, nodes that don't depend on each other's output (e.g. parallel tracks)
+        are shared between the audio thread and this many realtime worker threads.
+        The rendered audio is exactly the same either way, but the processors must be
+        safe to call from different threads at the same time as each other.
+
+        The number is limited to one less than the number of CPU cores. If the system
+        won't give the worker threads realtime scheduling, the nodes are rendered in
+        turn on the audio thread instead, and getNumRenderThreads() returns zero.
+
+        This starts threads, so call it from the message thread. It doesn't interrupt
+        the audio: the new threads take over when the rendering sequence is rebuilt.
+    */
+    void setNumRenderThreads (int numThreads);
+
+    /** Returns the number of extra rendering threads.
+        @see setNumRenderThreads
+    */
+    int getNumRenderThreads() const noexcept;
+
     //==============================================================================
     /** A special number that represents the midi channel of a node.
 
@@ -396,19 +435,36 @@ private:
     ReferenceCountedArray <Node> nodes;
     OwnedArray <Connection> connections;
     uint32 lastNodeId;
-    AudioSampleBuffer renderingBuffers;
-    OwnedArray <MidiBuffer> midiBuffers;
-    Array<void*> renderingOps;
+    Array<void*> renderOrder;
+    int changeBatchDepth;
+    bool changesPending;
+
+    class RenderingTasks;
+    class RenderThreadPool;
+    class RenderingProgram;
+    class RetiredPrograms;
+    friend class ScopedPointer<RenderingTasks>;
+    friend class ScopedPointer<RetiredPrograms>;
+    friend class ReferenceCountedObjectPtr<RenderThreadPool>;
+
+    Atomic<RenderingProgram*> currentProgram;
+    Atomic<int> callbackCount;
+    ScopedPointer<RetiredPrograms> retiredPrograms;
+    ReferenceCountedObjectPtr<RenderThreadPool> renderThreadPool;
 
     friend class AudioGraphIOProcessor;
     AudioSampleBuffer* currentAudioInputBuffer;
     AudioSampleBuffer currentAudioOutputBuffer;
     MidiBuffer* currentMidiInputBuffer;
     MidiBuffer currentMidiOutputBuffer;
+    MidiBuffer chunkMidi, chunkMidiOutput; // for host blocks bigger than the prepared size
 
     void handleAsyncUpdate();
     void clearRenderingSequence();
     void buildRenderingSequence();
+    void publishRenderingProgram (RenderingProgram*);
+    void renderChunk (RenderingProgram*, AudioSampleBuffer&, MidiBuffer&);
+    void renderingSequenceChanged();
     bool isAnInputTo (uint32 possibleInputId, uint32 possibleDestinationId, int recursionCheck) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorGraph)
@@ -271,6 +271,9 @@ SystemStats::CPUFlags::CPUFlags()
     hasSSE = false;
     hasSSE2 = false;
     has3DNow = false;
+    hasAVX = false;
+    hasAVX2 = false;
+    hasFMA3 = false;
 
     numCpus = jmax (1, sysconf (_SC_NPROCESSORS_ONLN));
 }
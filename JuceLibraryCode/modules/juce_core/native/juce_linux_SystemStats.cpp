@@ -139,6 +139,13 @@ SystemStats::CPUFlags::CPUFlags()
     hasSSE2  = flags.contains ("sse2");
     has3DNow = flags.contains ("3dnow");
 
+    // the kernel leaves these out if it doesn't save the AVX registers
+    StringArray flagList;
+    flagList.addTokens (flags, false);
+    hasAVX   = flagList.contains ("avx");
+    hasAVX2  = flagList.contains ("avx2");
+    hasFMA3  = flagList.contains ("fma");
+
     numCpus = LinuxStatsHelpers::getCpuInfo ("processor").getIntValue() + 1;
 }
 
@@ -62,6 +62,17 @@ namespace SystemStatsHelpers
 
         a = la; b = lb; c = lc; d = ld;
     }
+
+    // True if the OS saves the AVX registers on a context switch
+    static bool isAVXStateEnabled (const uint32 features)
+    {
+        if ((features & (1u << 27)) == 0) // OSXSAVE
+            return false;
+
+        uint32 lo = 0, hi = 0;
+        asm ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+        return (lo & 6) == 6;
+    }
    #endif
 }
 
@@ -69,18 +80,40 @@ namespace SystemStatsHelpers
 SystemStats::CPUFlags::CPUFlags()
 {
    #if JUCE_INTEL && ! JUCE_NO_INLINE_ASM
-    uint32 familyModel = 0, extFeatures = 0, features = 0, dummy = 0;
-    SystemStatsHelpers::doCPUID (familyModel, extFeatures, dummy, features, 1);
+    uint32 familyModel = 0, extFeatures = 0, features = 0, features2 = 0;
+    SystemStatsHelpers::doCPUID (familyModel, extFeatures, features2, features, 1);
 
     hasMMX   = (features    & (1u << 23)) != 0;
     hasSSE   = (features    & (1u << 25)) != 0;
     hasSSE2  = (features    & (1u << 26)) != 0;
     has3DNow = (extFeatures & (1u << 31)) != 0;
+
+    const bool avxStateEnabled = SystemStatsHelpers::isAVXStateEnabled (features2);
+    hasAVX   = avxStateEnabled && (features2 & (1u << 28)) != 0;
+    hasFMA3  = avxStateEnabled && (features2 & (1u << 12)) != 0;
+
+   #if JUCE_64BIT // (leaf 7 needs ecx = 0, which doCPUID only passes in on 64-bit)
+    uint32 maxLeaf = 0, dummy = 0, extFeatures7 = 0;
+    SystemStatsHelpers::doCPUID (maxLeaf, dummy, dummy, dummy, 0);
+
+    if (maxLeaf >= 7)
+    {
+        dummy = 0;
+        SystemStatsHelpers::doCPUID (dummy, extFeatures7, dummy, dummy, 7);
+    }
+
+    hasAVX2  = hasAVX && (extFeatures7 & (1u << 5)) != 0;
+   #else
+    hasAVX2 = false;
+   #endif
    #else
     hasMMX = false;
     hasSSE = false;
     hasSSE2 = false;
     has3DNow = false;
+    hasAVX = false;
+    hasAVX2 = false;
+    hasFMA3 = false;
    #endif
 
    #if JUCE_IOS || (MAC_OS_X_VERSION_MIN_REQUIRED >= MAC_OS_X_VERSION_10_5)
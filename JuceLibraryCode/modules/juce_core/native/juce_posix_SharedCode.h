@@ -905,6 +905,21 @@ bool Thread::setThreadPriority (void* handle, int priority)
     return pthread_setschedparam ((pthread_t) handle, policy, &param) == 0;
 }
 
+bool Thread::setCurrentThreadRealtimePriority (const int priority, const bool useRoundRobin)
+{
+    const int policy = useRoundRobin ? SCHED_RR : SCHED_FIFO;
+
+    struct sched_param param;
+    param.sched_priority = jlimit (sched_get_priority_min (policy), sched_get_priority_max (policy), priority);
+
+    return pthread_setschedparam (pthread_self(), policy, &param) == 0;
+}
+
+bool Process::lockMemory()
+{
+    return mlockall (MCL_CURRENT | MCL_FUTURE) == 0;
+}
+
 Thread::ThreadID Thread::getCurrentThreadId()
 {
     return (ThreadID) pthread_self();
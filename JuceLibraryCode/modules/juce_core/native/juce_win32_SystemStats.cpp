@@ -112,6 +112,22 @@ SystemStats::CPUFlags::CPUFlags()
     has3DNow = IsProcessorFeaturePresent (PF_3DNOW_INSTRUCTIONS_AVAILABLE) != 0;
    #endif
 
+   #ifdef PF_AVX2_INSTRUCTIONS_AVAILABLE
+    hasAVX   = IsProcessorFeaturePresent (PF_AVX_INSTRUCTIONS_AVAILABLE) != 0;
+    hasAVX2  = IsProcessorFeaturePresent (PF_AVX2_INSTRUCTIONS_AVAILABLE) != 0;
+   #else
+    hasAVX = false;
+    hasAVX2 = false;
+   #endif
+
+   #if JUCE_USE_INTRINSICS
+    int info [4];
+    __cpuid (info, 1);
+    hasFMA3  = hasAVX && (info[2] & (1 << 12)) != 0;
+   #else
+    hasFMA3 = false;
+   #endif
+
     SYSTEM_INFO systemInfo;
     GetNativeSystemInfo (&systemInfo);
     numCpus = (int) systemInfo.dwNumberOfProcessors;
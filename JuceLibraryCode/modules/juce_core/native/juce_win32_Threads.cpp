@@ -196,6 +196,11 @@ bool Thread::setThreadPriority (void* handle, int priority)
     return SetThreadPriority (handle, pri) != FALSE;
 }
 
+bool Thread::setCurrentThreadRealtimePriority (int, bool)
+{
+    return SetThreadPriority (GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != FALSE;
+}
+
 void Thread::setCurrentThreadAffinityMask (const uint32 affinityMask)
 {
     SetThreadAffinityMask (GetCurrentThread(), affinityMask);
@@ -312,6 +317,11 @@ void Process::lowerPrivilege()
     jassertfalse; // xxx not implemented
 }
 
+bool Process::lockMemory()
+{
+    return false;
+}
+
 void Process::terminate()
 {
    #if JUCE_MSVC && JUCE_CHECK_MEMORY_LEAKS
@@ -150,6 +150,15 @@ public:
     /** Checks whether AMD 3DNOW instructions are available. */
     static bool has3DNow() noexcept             { return getCPUFlags().has3DNow; }
 
+    /** Checks whether Intel AVX instructions are available, and enabled by the OS. */
+    static bool hasAVX() noexcept               { return getCPUFlags().hasAVX; }
+
+    /** Checks whether Intel AVX2 instructions are available, and enabled by the OS. */
+    static bool hasAVX2() noexcept              { return getCPUFlags().hasAVX2; }
+
+    /** Checks whether FMA3 (fused multiply-add) instructions are available. */
+    static bool hasFMA3() noexcept              { return getCPUFlags().hasFMA3; }
+
     //==============================================================================
     /** Finds out how much RAM is in the machine.
         @returns    the approximate number of megabytes of memory, or zero if
@@ -191,6 +200,9 @@ private:
         bool hasSSE : 1;
         bool hasSSE2 : 1;
         bool has3DNow : 1;
+        bool hasAVX : 1;
+        bool hasAVX2 : 1;
+        bool hasFMA3 : 1;
     };
 
     SystemStats();
@@ -92,6 +92,16 @@ public:
     */
     static void lowerPrivilege();
 
+    //==============================================================================
+    /** Locks all of the process's current and future memory into RAM, so that
+        realtime threads never have to wait for a page to be faulted in.
+
+        This uses mlockall() on POSIX systems, which normally needs permission to
+        do so (e.g. a memlock limit on Linux). Returns false if the memory couldn't
+        be locked, or if this isn't supported on the current OS.
+    */
+    static bool lockMemory();
+
     //==============================================================================
     /** Returns true if this process is being hosted by a debugger. */
     static bool JUCE_CALLTYPE isRunningUnderDebugger();
@@ -172,6 +172,19 @@ public:
     */
     static bool setCurrentThreadPriority (int priority);
 
+    /** Puts the caller thread under realtime scheduling, at a priority from 1 to 99.
+
+        On POSIX systems this uses SCHED_FIFO, or SCHED_RR if useRoundRobin is true,
+        which normally needs permission to do so (e.g. an rtprio limit on Linux). On
+        Windows the thread is given time-critical priority.
+
+        Returns false if the scheduling couldn't be changed, in which case the thread
+        is left as it was.
+
+        @see setCurrentThreadPriority, Process::lockMemory
+    */
+    static bool setCurrentThreadRealtimePriority (int priority, bool useRoundRobin = false);
+
     //==============================================================================
     /** Sets the affinity mask for the thread.
 
@@ -0,0 +1,594 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+*/
+
+/**
+ * Benchmark.cpp
+ * BiasedDelayRender
+ */
+
+#include "Benchmark.h"
+
+const int BLOCK_SIZES[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+const double SAMPLE_RATES[] = { 44100, 48000, 88200, 96000, 176400, 192000 };
+const int CHANNEL_COUNTS[] = { 1, 2, 8, 32 };
+
+// Bias parameter values: 0.5 maps to an exponent of 1 (no bias)
+const float BIAS_VALUES[] = { 0.5f, 0.2f, 0.8f };
+
+const char* const INSTRUCTION_SET_NAMES[] = { "scalar", "sse", "avx2" };
+
+// Each case is measured this many times; we report the fastest run.
+const int NUM_RUNS = 5;
+
+// Fixed seed, so every build sees the same input.
+const int64 NOISE_SEED = 0x5eed;
+
+// Resamplers compared by the resampling cases, which convert 44.1kHz
+// sources to 96kHz, as the offline renders do; their block size counts
+// input samples.
+const char* const RESAMPLER_NAMES[] = { "SincResampler", "LagrangeInterpolator", "ResamplingAudioSource" };
+const double RESAMPLING_INPUT_RATE = 44100;
+const double RESAMPLING_OUTPUT_RATE = 96000;
+
+// Test tones for the quality measurements. Tones above the output's
+// Nyquist frequency should be removed, so their level is the aliasing.
+struct ResamplingTestTone {
+  double inputRate;
+  double outputRate;
+  double frequency;
+};
+const ResamplingTestTone RESAMPLING_TEST_TONES[] = {
+  { 44100, 96000, 997 }, { 44100, 96000, 15000 },
+  { 44100, 96000.5, 15000 }, // not a simple ratio
+  { 96000, 44100, 30000 }
+};
+const float TEST_TONE_LEVEL = 0.5f;
+
+// Feeds ResamplingAudioSource from a block of samples, once or looped.
+class SampleSource : public AudioSource {
+public:
+  SampleSource(const float* samples, int numSamples, bool looping) :
+    samples(samples), numSamples(numSamples), looping(looping), position(0) {
+  }
+
+  void prepareToPlay(int, double){}
+  void releaseResources(){}
+
+  void getNextAudioBlock(const AudioSourceChannelInfo& info){
+    AudioSampleBuffer& buffer = *info.buffer;
+    for (int done=0; done<info.numSamples; )
+    {
+      if (position==numSamples)
+      {
+        if (!looping)
+        {
+          for (int channel=0; channel<buffer.getNumChannels(); channel++)
+            buffer.clear(channel, info.startSample + done, info.numSamples - done);
+          return;
+        }
+        position = 0;
+      }
+      const int num = jmin(info.numSamples - done, numSamples - position);
+      for (int channel=0; channel<buffer.getNumChannels(); channel++)
+        buffer.copyFrom(channel, info.startSample + done, samples + position, num);
+      position += num;
+      done += num;
+    }
+  }
+
+private:
+  const float* samples;
+  int numSamples;
+  bool looping;
+  int position;
+};
+
+// Signal to noise-and-distortion ratio in dB: the least-squares fit of a
+// sine at the known frequency (plus DC) is the signal, the rest is error.
+static double measureSinad(const float* samples, int numSamples, double radiansPerSample){
+  double equations[3][4] = {{ 0 }};
+  for (int i=0; i<numSamples; i++)
+  {
+    const double basis[3] = { std::sin(radiansPerSample * i), std::cos(radiansPerSample * i), 1 };
+    for (int row=0; row<3; row++)
+    {
+      for (int column=0; column<3; column++)
+        equations[row][column] += basis[row] * basis[column];
+      equations[row][3] += basis[row] * samples[i];
+    }
+  }
+
+  double fit[3];
+  for (int k=0; k<3; k++)
+    for (int row=k+1; row<3; row++)
+    {
+      const double factor = equations[row][k] / equations[k][k];
+      for (int column=k; column<4; column++)
+        equations[row][column] -= factor * equations[k][column];
+    }
+  for (int k=2; k>=0; k--)
+  {
+    double sum = equations[k][3];
+    for (int column=k+1; column<3; column++)
+      sum -= equations[k][column] * fit[column];
+    fit[k] = sum / equations[k][k];
+  }
+
+  double signal = 0, error = 0;
+  for (int i=0; i<numSamples; i++)
+  {
+    const double sine = fit[0] * std::sin(radiansPerSample * i) + fit[1] * std::cos(radiansPerSample * i) + fit[2];
+    signal += sine * sine;
+    error += (samples[i] - sine) * (samples[i] - sine);
+  }
+  return 10 * std::log10(signal / jmax(error, 1e-30));
+}
+
+BiasedDelayBenchmark::BiasedDelayBenchmark(double secondsPerCase) :
+  secondsPerCase(secondsPerCase), input(MAX_CHANNELS, 4096), sink(0) {
+  Random random(NOISE_SEED);
+  for (int channel=0; channel<input.getNumChannels(); channel++)
+  {
+    float* samples = input.getSampleData(channel);
+    for (int i=0; i<input.getNumSamples(); i++)
+      samples[i] = random.nextFloat() - 0.5f;
+  }
+}
+
+var BiasedDelayBenchmark::run(){
+  results.clear();
+
+  for (int b=0; b<numElementsInArray(BLOCK_SIZES); b++)
+  {
+    const int blockSize = BLOCK_SIZES[b];
+
+    for (int i=0; i<numElementsInArray(BIAS_VALUES); i++)
+      benchmarkApplyBias(blockSize, BIAS_VALUES[i]);
+
+    benchmarkLimit("hardLimit", &BiasedDelay::hardLimit, blockSize);
+    benchmarkLimit("softLimit", &BiasedDelay::softLimit, blockSize);
+    benchmarkMix("linearXFade", &BiasedDelay::linearXFade, blockSize);
+    benchmarkMix("sigmoidXFade", &BiasedDelay::sigmoidXFade, blockSize);
+    benchmarkMix("linearTransFade", &BiasedDelay::linearTransFade, blockSize);
+    benchmarkMix("sigmoidTransFade", &BiasedDelay::sigmoidTransFade, blockSize);
+    benchmarkMix("dryWetFade", &BiasedDelay::dryWetFade, blockSize);
+
+    // Tiers the CPU doesn't have are skipped
+    const FloatVectorOperations::InstructionSet best = FloatVectorOperations::getInstructionSet();
+    for (int i=0; i<=best; i++)
+    {
+      benchmarkVectorOps(blockSize, (FloatVectorOperations::InstructionSet)i);
+      benchmarkResampling(blockSize, (FloatVectorOperations::InstructionSet)i);
+    }
+    FloatVectorOperations::setInstructionSet(best);
+
+    for (int r=0; r<numElementsInArray(SAMPLE_RATES); r++)
+    {
+      for (int i=0; i<numElementsInArray(BIAS_VALUES); i++)
+        benchmarkChannelBlock(blockSize, SAMPLE_RATES[r], BIAS_VALUES[i]);
+
+      for (int c=0; c<numElementsInArray(CHANNEL_COUNTS); c++)
+      {
+        const int numChannels = CHANNEL_COUNTS[c];
+        for (int i=0; i<numElementsInArray(BIAS_VALUES); i++)
+          benchmarkProcessBlock(blockSize, SAMPLE_RATES[r], numChannels, BIAS_VALUES[i], false);
+        if (numChannels >= MIN_PARALLEL_CHANNELS)
+          benchmarkProcessBlock(blockSize, SAMPLE_RATES[r], numChannels, BIAS_VALUES[0], true);
+      }
+    }
+  }
+
+  DynamicObject* report = new DynamicObject();
+  report->setProperty("system", getSystemInfo());
+  report->setProperty("results", results);
+  report->setProperty("resamplingQuality", measureResamplingQuality());
+  return var(report);
+}
+
+/**
+ * Cases.
+ */
+
+void BiasedDelayBenchmark::benchmarkChannelBlock(int blockSize, double sampleRate, float bias){
+  BiasedDelay biasedDelay;
+  biasedDelay.setParameterValue(PARAMETER_BIAS, bias);
+  biasedDelay.prepareToPlay(sampleRate, blockSize, 1);
+  AudioSampleBuffer buffer(1, blockSize);
+
+  double seconds = measure([&]() {
+    buffer.copyFrom(0, 0, input, 0, 0, blockSize);
+    biasedDelay.processChannelBlock(blockSize, buffer.getSampleData(0),
+                                    biasedDelay.delayBuffer->getSampleData(0),
+                                    biasedDelay.delayBufferIdx);
+    biasedDelay.delayBufferIdx = (biasedDelay.delayBufferIdx + blockSize) %
+      biasedDelay.getSampleDelay(biasedDelay.getParameterValue(PARAMETER_TIME));
+  });
+  addResult("processChannelBlock", blockSize, sampleRate, 1, bias, seconds);
+}
+
+void BiasedDelayBenchmark::benchmarkApplyBias(int blockSize, float bias){
+  BiasedDelay biasedDelay;
+  const float exponent = biasedDelay.getBiasExponent(1 - bias);
+  const float* samples = input.getSampleData(0);
+
+  double seconds = measure([&]() {
+    float sum = 0;
+    for (int i=0; i<blockSize; i++)
+      sum += biasedDelay.applyBias(samples[i], exponent);
+    sink = sum;
+  });
+  addResult("applyBias", blockSize, 0, 1, bias, seconds);
+}
+
+void BiasedDelayBenchmark::benchmarkLimit(const char* name, LimitFunction function, int blockSize){
+  BiasedDelay biasedDelay;
+  const float* samples = input.getSampleData(0);
+
+  double seconds = measure([&]() {
+    float sum = 0;
+    for (int i=0; i<blockSize; i++)
+      sum += (biasedDelay.*function)(samples[i] * 4);
+    sink = sum;
+  });
+  addResult(name, blockSize, 0, 1, -1, seconds);
+}
+
+void BiasedDelayBenchmark::benchmarkMix(const char* name, MixFunction function, int blockSize){
+  BiasedDelay biasedDelay;
+  const float* a = input.getSampleData(0);
+  const float* b = input.getSampleData(1);
+
+  double seconds = measure([&]() {
+    float sum = 0;
+    for (int i=0; i<blockSize; i++)
+      sum += (biasedDelay.*function)(a[i], b[i], 0.3f);
+    sink = sum;
+  });
+  addResult(name, blockSize, 0, 1, -1, seconds);
+}
+
+void BiasedDelayBenchmark::benchmarkProcessBlock(int blockSize, double sampleRate, int numChannels,
+                                                 float bias, bool parallel){
+  BiasedDelay biasedDelay;
+  biasedDelay.setParameterValue(PARAMETER_BIAS, bias);
+  biasedDelay.setParallelProcessing(parallel);
+  biasedDelay.prepareToPlay(sampleRate, blockSize, numChannels);
+  AudioSampleBuffer buffer(numChannels, blockSize);
+  MidiBuffer midiMessages;
+
+  double seconds = measure([&]() {
+    for (int channel=0; channel<numChannels; channel++)
+      buffer.copyFrom(channel, 0, input, channel, 0, blockSize);
+    biasedDelay.processBlock(buffer, numChannels, numChannels, midiMessages);
+  });
+  addResult(parallel ? "processBlock (parallel)" : "processBlock",
+            blockSize, sampleRate, numChannels, bias, seconds);
+}
+
+void BiasedDelayBenchmark::benchmarkVectorOps(int blockSize, FloatVectorOperations::InstructionSet instructionSet){
+  FloatVectorOperations::setInstructionSet(instructionSet);
+  const String suffix = String(" (") + INSTRUCTION_SET_NAMES[instructionSet] + ")";
+  const float* a = input.getSampleData(0);
+  const float* b = input.getSampleData(1);
+  const float* const sources[] = { a, b };
+  AudioSampleBuffer buffer(2, blockSize);
+  AudioSampleBuffer interleaved(1, blockSize * 2);
+  AudioSampleBuffer rampBuffer(8, blockSize);
+  MemoryBlock pcm(sizeof(int16) * 2 * blockSize, true);
+  float* dest = buffer.getSampleData(0);
+  float* const dests[] = { buffer.getSampleData(0), buffer.getSampleData(1) };
+
+  // Each op leaves dest bounded, so repeating it can't denormalise or overflow
+  addResult("FloatVectorOperations::add" + suffix, blockSize, 0, 1, -1, measure([&]() {
+    FloatVectorOperations::copy(dest, a, blockSize);
+    FloatVectorOperations::add(dest, b, blockSize);
+  }));
+  addResult("FloatVectorOperations::addWithMultiply" + suffix, blockSize, 0, 1, -1, measure([&]() {
+    FloatVectorOperations::copy(dest, a, blockSize);
+    FloatVectorOperations::addWithMultiply(dest, b, 0.5f, blockSize);
+  }));
+  addResult("FloatVectorOperations::addWithMultiply (vector)" + suffix, blockSize, 0, 1, -1, measure([&]() {
+    FloatVectorOperations::copy(dest, a, blockSize);
+    FloatVectorOperations::addWithMultiply(dest, a, b, blockSize);
+  }));
+  addResult("FloatVectorOperations::copyWithMultiply" + suffix, blockSize, 0, 1, -1, measure([&]() {
+    FloatVectorOperations::copyWithMultiply(dest, a, 0.5f, blockSize);
+  }));
+  addResult("FloatVectorOperations::multiplyWithRamp" + suffix, blockSize, 0, 1, -1, measure([&]() {
+    FloatVectorOperations::copy(dest, a, blockSize);
+    FloatVectorOperations::multiplyWithRamp(dest, 1.0f, 0.5f, blockSize);
+  }));
+  addResult("FloatVectorOperations::addWithRamp" + suffix, blockSize, 0, 1, -1, measure([&]() {
+    FloatVectorOperations::copy(dest, a, blockSize);
+    FloatVectorOperations::addWithRamp(dest, b, 0.5f, 0.25f, blockSize);
+  }));
+  addResult("AudioSampleBuffer::applyGainRamp" + suffix, blockSize, 0, rampBuffer.getNumChannels(), -1, measure([&]() {
+    for (int channel=0; channel<rampBuffer.getNumChannels(); channel++)
+      rampBuffer.copyFrom(channel, 0, input, channel, 0, blockSize);
+    rampBuffer.applyGainRamp(0, blockSize, 1.0f, 0.5f);
+  }));
+  addResult("FloatVectorOperations::clip" + suffix, blockSize, 0, 1, -1, measure([&]() {
+    FloatVectorOperations::clip(dest, a, -0.25f, 0.25f, blockSize);
+  }));
+  addResult("FloatVectorOperations::abs" + suffix, blockSize, 0, 1, -1, measure([&]() {
+    FloatVectorOperations::abs(dest, a, blockSize);
+  }));
+  addResult("FloatVectorOperations::findMinAndMax" + suffix, blockSize, 0, 1, -1, measure([&]() {
+    float minimum, maximum;
+    FloatVectorOperations::findMinAndMax(a, blockSize, minimum, maximum);
+    sink = maximum - minimum;
+  }));
+  addResult("FloatVectorOperations::interleave" + suffix, blockSize, 0, 2, -1, measure([&]() {
+    FloatVectorOperations::interleave(interleaved.getSampleData(0), sources, 2, blockSize);
+  }));
+  addResult("FloatVectorOperations::deinterleave" + suffix, blockSize, 0, 2, -1, measure([&]() {
+    FloatVectorOperations::deinterleave(dests, interleaved.getSampleData(0), 2, blockSize);
+  }));
+  addResult("AudioDataConverters::convertFloatToInterleaved (int16)" + suffix, blockSize, 0, 2, -1, measure([&]() {
+    AudioDataConverters::convertFloatToInterleaved(AudioDataConverters::int16LE, sources, 2, pcm.getData(), blockSize);
+  }));
+  addResult("AudioDataConverters::convertInterleavedToFloat (int16)" + suffix, blockSize, 0, 2, -1, measure([&]() {
+    AudioDataConverters::convertInterleavedToFloat(AudioDataConverters::int16LE, pcm.getData(), 2, dests, blockSize);
+  }));
+
+  // An 8th-order cascade on 8 channels; the input is refilled each time so it can't decay
+  const IIRCoefficients sections[] = {
+    IIRCoefficients::makeLowPass(48000, 8000), IIRCoefficients::makeHighPass(48000, 40),
+    IIRCoefficients::makeLowShelf(48000, 200, 0.7, 1.5f), IIRCoefficients::makeBandPass(48000, 2000, 1.0, 0.5f)
+  };
+  const int numSections = numElementsInArray(sections);
+  AudioSampleBuffer filterBuffer(8, blockSize);
+  if (instructionSet == FloatVectorOperations::scalarInstructions)
+  {
+    OwnedArray<IIRFilter> filters;
+    for (int i=0; i<filterBuffer.getNumChannels() * numSections; i++)
+    {
+      filters.add(new IIRFilter());
+      filters.getLast()->setCoefficients(sections[i % numSections]);
+    }
+    addResult("IIRFilter (8 channels, 4 sections)", blockSize, 0, filterBuffer.getNumChannels(), -1, measure([&]() {
+      for (int channel=0; channel<filterBuffer.getNumChannels(); channel++)
+      {
+        float* samples = filterBuffer.getSampleData(channel);
+        FloatVectorOperations::copy(samples, input.getSampleData(channel), blockSize);
+        for (int section=0; section<numSections; section++)
+          filters.getUnchecked(channel * numSections + section)->processSamples(samples, blockSize);
+      }
+    }));
+  }
+  for (int precision=0; precision<2; precision++)
+  {
+    MultiChannelIIRFilter filter(filterBuffer.getNumChannels(), numSections, precision != 0);
+    for (int section=0; section<numSections; section++)
+      filter.setCoefficients(section, sections[section]);
+    const String name = precision != 0 ? "MultiChannelIIRFilter (8 channels, 4 sections, double)"
+                                       : "MultiChannelIIRFilter (8 channels, 4 sections)";
+    addResult(name + suffix, blockSize, 0, filterBuffer.getNumChannels(), -1, measure([&]() {
+      for (int channel=0; channel<filterBuffer.getNumChannels(); channel++)
+        FloatVectorOperations::copy(filterBuffer.getSampleData(channel), input.getSampleData(channel), blockSize);
+      filter.processSamples(filterBuffer, 0, blockSize);
+    }));
+  }
+}
+
+// Two channels of 44.1kHz noise to 96kHz. SincResampler is timed at each
+// tier, with an exact and a non-simple ratio; the others don't use
+// FloatVectorOperations, so they're timed once.
+void BiasedDelayBenchmark::benchmarkResampling(int blockSize, FloatVectorOperations::InstructionSet instructionSet){
+  FloatVectorOperations::setInstructionSet(instructionSet);
+  const String suffix = String(" (") + INSTRUCTION_SET_NAMES[instructionSet] + ")";
+  const int numChannels = 2;
+  const float* const sources[] = { input.getSampleData(0), input.getSampleData(1) };
+
+  for (int exact=1; exact>=0; exact--)
+  {
+    SincResampler resampler(numChannels, RESAMPLING_INPUT_RATE, RESAMPLING_OUTPUT_RATE + (exact ? 0 : 0.5));
+    AudioSampleBuffer output(numChannels, resampler.getMaxNumOutputSamples(blockSize));
+    float* const dests[] = { output.getSampleData(0), output.getSampleData(1) };
+    const String name = exact ? "SincResampler (44.1k->96k)" : "SincResampler (44.1k->96.0005k)";
+    addResult(name + suffix, blockSize, RESAMPLING_INPUT_RATE, numChannels, -1, measure([&]() {
+      resampler.process(sources, blockSize, dests);
+    }));
+  }
+
+  if (instructionSet != FloatVectorOperations::scalarInstructions)
+    return;
+
+  // As many outputs as a block of input makes, less one for the interpolators' lookahead
+  const double ratio = RESAMPLING_INPUT_RATE / RESAMPLING_OUTPUT_RATE;
+  const int numOutput = (int)((blockSize - 1) / ratio);
+  AudioSampleBuffer output(numChannels, numOutput);
+
+  LagrangeInterpolator interpolators[numChannels];
+  addResult("LagrangeInterpolator (44.1k->96k)", blockSize, RESAMPLING_INPUT_RATE, numChannels, -1, measure([&]() {
+    for (int channel=0; channel<numChannels; channel++)
+      interpolators[channel].process(ratio, sources[channel], output.getSampleData(channel), numOutput);
+  }));
+
+  ResamplingAudioSource resamplingSource(new SampleSource(sources[0], input.getNumSamples(), true), true, numChannels);
+  resamplingSource.setResamplingRatio(ratio);
+  resamplingSource.prepareToPlay(numOutput, RESAMPLING_OUTPUT_RATE);
+  AudioSourceChannelInfo info;
+  info.buffer = &output;
+  info.startSample = 0;
+  info.numSamples = numOutput;
+  addResult("ResamplingAudioSource (44.1k->96k)", blockSize, RESAMPLING_INPUT_RATE, numChannels, -1, measure([&]() {
+    resamplingSource.getNextAudioBlock(info);
+  }));
+}
+
+/**
+ * Resampling quality.
+ */
+
+var BiasedDelayBenchmark::measureResamplingQuality(){
+  const int numSource = 65536;
+  const int numSkipped = 1024; // start and end transients
+  HeapBlock<float> source(numSource);
+  Array<var> measurements;
+
+  for (int t=0; t<numElementsInArray(RESAMPLING_TEST_TONES); t++)
+  {
+    const ResamplingTestTone& tone = RESAMPLING_TEST_TONES[t];
+    for (int i=0; i<numSource; i++)
+      source[i] = TEST_TONE_LEVEL * (float)std::sin(2 * double_Pi * tone.frequency * i / tone.inputRate);
+
+    const int numDest = (int)((numSource - 8) * tone.outputRate / tone.inputRate);
+    HeapBlock<float> dest(numDest);
+    const float* const analysed = dest + numSkipped;
+    const int numAnalysed = numDest - 2 * numSkipped;
+
+    for (int r=0; r<numElementsInArray(RESAMPLER_NAMES); r++)
+    {
+      resample(r, source, numSource, tone.inputRate, tone.outputRate, dest, numDest);
+
+      DynamicObject* measurement = new DynamicObject();
+      measurement->setProperty("resampler", RESAMPLER_NAMES[r]);
+      measurement->setProperty("inputRate", tone.inputRate);
+      measurement->setProperty("outputRate", tone.outputRate);
+      measurement->setProperty("frequency", tone.frequency);
+      if (tone.frequency < tone.outputRate / 2)
+        measurement->setProperty("sinadDb", measureSinad(analysed, numAnalysed, 2 * double_Pi * tone.frequency / tone.outputRate));
+      else
+      {
+        // Relative to the tone
+        double sum = 0;
+        for (int i=0; i<numAnalysed; i++)
+          sum += analysed[i] * analysed[i];
+        const double toneLevel = TEST_TONE_LEVEL * TEST_TONE_LEVEL / 2;
+        measurement->setProperty("aliasDb", 10 * std::log10(jmax(sum / numAnalysed / toneLevel, 1e-30)));
+      }
+      measurements.add(var(measurement));
+    }
+  }
+  return measurements;
+}
+
+// Converts a mono signal with one of RESAMPLER_NAMES; dest gets numDest
+// samples, which the source has to be long enough for.
+void BiasedDelayBenchmark::resample(int resampler, const float* source, int numSource,
+                                    double inputRate, double outputRate, float* dest, int numDest){
+  const double ratio = inputRate / outputRate;
+  if (resampler==0)
+  {
+    // Pushing the lookahead as silence flushes out the end of the source
+    SincResampler sincResampler(1, inputRate, outputRate);
+    const int lookahead = sincResampler.getLookahead();
+    HeapBlock<float> output(sincResampler.getMaxNumOutputSamples(numSource) + sincResampler.getMaxNumOutputSamples(lookahead));
+    HeapBlock<float> silence(lookahead, true);
+    float* outputs[] = { output.getData() };
+    int numOutput = sincResampler.process(&source, numSource, outputs);
+    outputs[0] += numOutput;
+    const float* silences[] = { silence.getData() };
+    numOutput += sincResampler.process(silences, lookahead, outputs);
+    jassert(numOutput >= numDest);
+    FloatVectorOperations::copy(dest, output, jmin(numDest, numOutput));
+  }
+  else if (resampler==1)
+  {
+    LagrangeInterpolator interpolator;
+    interpolator.process(ratio, source, dest, numDest);
+  }
+  else
+  {
+    ResamplingAudioSource resamplingSource(new SampleSource(source, numSource, false), true, 1);
+    resamplingSource.setResamplingRatio(ratio);
+    resamplingSource.prepareToPlay(512, outputRate);
+    AudioSampleBuffer output(1, numDest);
+    AudioSourceChannelInfo info;
+    info.buffer = &output;
+    for (info.startSample=0; info.startSample<numDest; info.startSample+=512)
+    {
+      info.numSamples = jmin(512, numDest - info.startSample);
+      resamplingSource.getNextAudioBlock(info);
+    }
+    FloatVectorOperations::copy(dest, output.getSampleData(0), numDest);
+  }
+}
+
+/**
+ * Measuring.
+ */
+
+template <class Function>
+double BiasedDelayBenchmark::measure(Function function){
+  const int64 ticksPerRun = (int64)(Time::getHighResolutionTicksPerSecond() * secondsPerCase / NUM_RUNS);
+
+  function(); // Warm up
+  double best = 0;
+  for (int run=0; run<NUM_RUNS; run++)
+  {
+    int iterations = 0;
+    const int64 start = Time::getHighResolutionTicks();
+    int64 elapsed;
+    do
+    {
+      function();
+      iterations++;
+      elapsed = Time::getHighResolutionTicks() - start;
+    } while (elapsed < ticksPerRun);
+
+    double seconds = Time::highResolutionTicksToSeconds(elapsed) / iterations;
+    if (run==0 || seconds < best)
+      best = seconds;
+  }
+  return best;
+}
+
+// Cycles are estimated from the nominal CPU clock. Realtime headroom is
+// the block's duration over its processing time, i.e. how many times
+// over the case would fit into one core's realtime budget.
+void BiasedDelayBenchmark::addResult(const String& kernel, int blockSize, double sampleRate,
+                                     int numChannels, float bias, double secondsPerBlock){
+  const double samples = (double)blockSize * numChannels;
+  const double nsPerSample = secondsPerBlock * 1e9 / samples;
+
+  DynamicObject* result = new DynamicObject();
+  result->setProperty("kernel", kernel);
+  result->setProperty("blockSize", blockSize);
+  if (sampleRate > 0)
+    result->setProperty("sampleRate", sampleRate);
+  result->setProperty("channels", numChannels);
+  if (bias >= 0)
+  {
+    result->setProperty("bias", bias);
+    result->setProperty("biasExponent", BiasedDelay().getBiasExponent(1 - bias));
+  }
+  result->setProperty("nsPerSample", nsPerSample);
+  result->setProperty("cyclesPerSample", nsPerSample * SystemStats::getCpuSpeedInMegaherz() / 1000);
+  if (sampleRate > 0)
+    result->setProperty("realtimeHeadroom", (blockSize / sampleRate) / secondsPerBlock);
+  results.add(var(result));
+}
+
+var BiasedDelayBenchmark::getSystemInfo(){
+  DynamicObject* info = new DynamicObject();
+  info->setProperty("date", Time::getCurrentTime().formatted("%Y-%m-%dT%H:%M:%S"));
+  info->setProperty("os", SystemStats::getOperatingSystemName());
+  info->setProperty("cpuVendor", SystemStats::getCpuVendor());
+  info->setProperty("cpuMHz", SystemStats::getCpuSpeedInMegaherz());
+  info->setProperty("numCpus", SystemStats::getNumCpus());
+  info->setProperty("juceVersion", SystemStats::getJUCEVersion());
+  info->setProperty("instructionSet", INSTRUCTION_SET_NAMES[FloatVectorOperations::getInstructionSet()]);
+ #if JUCE_DEBUG
+  info->setProperty("build", "debug");
+ #else
+  info->setProperty("build", "release");
+ #endif
+  info->setProperty("secondsPerCase", secondsPerCase);
+  return var(info);
+}
@@ -0,0 +1,73 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+ */
+
+/**
+ * Benchmark.h
+ * BiasedDelayRender
+ *
+ * Times the BiasedDelay kernels, and the FloatVectorOperations they use
+ * at each instruction set tier, and reports the results as JSON.
+ */
+
+#ifndef BiasedDelayRender_Benchmark_h
+#define BiasedDelayRender_Benchmark_h
+
+#include "JuceHeader.h"
+#include "../../Source/BiasedDelay.h"
+
+class BiasedDelayBenchmark {
+public:
+  // secondsPerCase: measuring time per result (split across several runs)
+  BiasedDelayBenchmark(double secondsPerCase);
+
+  // Runs all cases; returns a JSON object with "system", "results"
+  // and "resamplingQuality"
+  var run();
+
+private:
+  typedef float (BiasedDelay::*LimitFunction)(float v);
+  typedef float (BiasedDelay::*MixFunction)(float a, float b, float mix);
+
+  void benchmarkChannelBlock(int blockSize, double sampleRate, float bias);
+  void benchmarkApplyBias(int blockSize, float bias);
+  void benchmarkLimit(const char* name, LimitFunction function, int blockSize);
+  void benchmarkMix(const char* name, MixFunction function, int blockSize);
+  void benchmarkProcessBlock(int blockSize, double sampleRate, int numChannels, float bias, bool parallel);
+  void benchmarkVectorOps(int blockSize, FloatVectorOperations::InstructionSet instructionSet);
+  void benchmarkResampling(int blockSize, FloatVectorOperations::InstructionSet instructionSet);
+
+  // SINAD and alias levels of each resampler, for a few test tones
+  var measureResamplingQuality();
+  void resample(int resampler, const float* source, int numSource,
+                double inputRate, double outputRate, float* dest, int numDest);
+
+  // Best time per call across several runs, in seconds
+  template <class Function>
+  double measure(Function function);
+
+  void addResult(const String& kernel, int blockSize, double sampleRate,
+                 int numChannels, float bias, double secondsPerBlock);
+  var getSystemInfo();
+
+private:
+  double secondsPerCase;
+  AudioSampleBuffer input;
+  Array<var> results;
+  volatile float sink;
+};
+
+#endif
@@ -0,0 +1,341 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+*/
+
+/**
+ * Main.cpp
+ * BiasedDelayRender
+ *
+ * Headless offline renderer: streams audio files through BiasedDelay.
+ */
+
+#include "JuceHeader.h"
+#include "RenderJob.h"
+#include "Benchmark.h"
+#include "RenderComparison.h"
+#include "StressTest.h"
+
+#include <iostream>
+
+static void printUsage(){
+  std::cout
+    << "Usage: BiasedDelayRender [options] <input files...>" << std::endl
+    << std::endl
+    << "  --time <0..1>       Delay time" << std::endl
+    << "  --feedback <0..1>   Feedback" << std::endl
+    << "  --bias <0..1>       Bias (0.5: no bias)" << std::endl
+    << "  --drywet <0..1>     Dry/wet mix" << std::endl
+    << "  --preset <file>     Load parameters from a BiasedDelayState XML file" << std::endl
+    << "  --tail <seconds>    Fixed tail length (default: until the tail has decayed)" << std::endl
+    << "  --max-tail <secs>   Longest decaying tail to render (default: " << DEFAULT_MAX_TAIL << ")" << std::endl
+    << "  --block <samples>   Block size (default: 512)" << std::endl
+    << "  --threads <n>       Files to render concurrently (default: number of CPUs)" << std::endl
+    << "  -o <dir>            Output directory (default: next to each input)" << std::endl
+    << "  --suffix <text>     Appended to output file names (default: \"-biased\")" << std::endl
+    << "  --load-state <file> Start from a saved state, incl. its delay buffer (one input only)" << std::endl
+    << "  --save-state <file> Save the state at the end of the input, e.g. to render in" << std::endl
+    << "                      chunks (one input only; implies --tail 0)" << std::endl
+    << std::endl
+    << "Usage: BiasedDelayRender --benchmark [--benchmark-time <seconds>]" << std::endl
+    << std::endl
+    << "  Times the DSP kernels and prints the results as JSON." << std::endl
+    << "  --benchmark-time    Measuring time per case (default: 0.02)" << std::endl
+    << std::endl
+    << "Usage: BiasedDelayRender --write-test-signals <dir>" << std::endl
+    << "       BiasedDelayRender --compare <reference> <other> [thresholds]" << std::endl
+    << std::endl
+    << "  Golden-output checks. Writes deterministic test signals, or compares" << std::endl
+    << "  a render (or a directory of renders) against a reference render." << std::endl
+    << "  --max-abs <x>       Largest allowed absolute error (default: 0)" << std::endl
+    << "  --max-rms <x>       Largest allowed RMS error (default: 0)" << std::endl
+    << "  --max-ulp <n>       Largest allowed ULP distance (default: 0)" << std::endl
+    << std::endl
+    << "Usage: BiasedDelayRender --check-kernels [thresholds]" << std::endl
+    << std::endl
+    << "  Renders the test signals through a frozen scalar reference kernel and" << std::endl
+    << "  through each processing mode (block sizes, parallel, morphing, state" << std::endl
+    << "  restore, automation), and compares every mode against the reference." << std::endl
+    << std::endl
+    << "Usage: BiasedDelayRender --stress [options]" << std::endl
+    << std::endl
+    << "  Times every block under randomized automation, extreme settings, sample" << std::endl
+    << "  rate switches and denormal input; fails if any block misses its deadline." << std::endl
+    << "  --sessions <n>      Sample rate/layout switches (default: 24)" << std::endl
+    << "  --session-time <s>  Audio per session, in seconds (default: 2)" << std::endl
+    << "  --budget <x>        Deadline as a fraction of the block duration (default: 0.5)" << std::endl
+    << "  --seed <n>          Random seed (default: 1)" << std::endl;
+}
+
+struct FileNameComparator {
+  static int compareElements(const File& a, const File& b){
+    return a.getFileName().compare(b.getFileName());
+  }
+};
+
+// Compares single files, or each file in the reference directory with
+// the file of the same name in the other directory.
+static int compareRenders(const File& reference, const File& other,
+                          const ComparisonThresholds& thresholds){
+  AudioFormatManager formatManager;
+  formatManager.registerBasicFormats();
+
+  Array<File> references;
+  if (reference.isDirectory())
+    reference.findChildFiles(references, File::findFiles, false, formatManager.getWildcardForAllFormats());
+  else
+    references.add(reference);
+  FileNameComparator comparator;
+  references.sort(comparator);
+
+  int numFailed = 0;
+  for (int i=0; i<references.size(); i++)
+  {
+    File file = other.isDirectory() ? other.getChildFile(references[i].getFileName()) : other;
+    ComparisonResult result = RenderComparison::compare(formatManager, references[i], file);
+    bool passed = result.passes(thresholds);
+    if (!passed)
+      numFailed++;
+
+    std::cout << (passed ? "PASS " : "FAIL ") << file.getFullPathName() << ": ";
+    if (result.errorMessage.isNotEmpty())
+      std::cout << result.errorMessage << std::endl;
+    else
+      std::cout << "max abs " << String(result.maxAbsError, 9)
+        << ", rms " << String(result.rmsError, 9)
+        << ", max ulp " << result.maxUlpDistance << std::endl;
+  }
+  std::cout << (references.size() - numFailed) << " of " << references.size() << " passed" << std::endl;
+  return (numFailed==0 && references.size() > 0) ? 0 : 1;
+}
+
+static bool loadPreset(const File& file, BiasedDelay& biasedDelay){
+  ScopedPointer<XmlElement> state(XmlDocument::parse(file));
+  if (state == nullptr || !state->hasTagName("BiasedDelayState"))
+    return false;
+  biasedDelay.setStateInformation(state);
+  return true;
+}
+
+int main (int argc, char* argv[]){
+  StringArray args;
+  for (int i=1; i<argc; i++)
+    args.add(CharPointer_UTF8(argv[i]));
+
+  // Defaults and presets go through BiasedDelay, so they match the plugin.
+  BiasedDelay parameters;
+  RenderSettings settings;
+  int numThreads = SystemStats::getNumCpus();
+  File outputDir;
+  String suffix("-biased");
+  Array<File> inputs;
+  bool benchmark = false;
+  bool stress = false;
+  bool checkKernels = false;
+  int stressSessions = 24;
+  double stressSessionTime = 2;
+  double stressBudget = 0.5;
+  int64 stressSeed = 1;
+  File compareReference, compareOther, testSignalDir;
+  ComparisonThresholds thresholds;
+  double benchmarkTime = 0.02;
+
+  for (int i=0; i<args.size(); i++)
+  {
+    const String& arg = args[i];
+    const bool hasValue = i+1 < args.size();
+
+    if (arg=="-h" || arg=="--help")
+    {
+      printUsage();
+      return 0;
+    }
+    else if (arg=="--benchmark")
+      benchmark = true;
+    else if (arg=="--benchmark-time" && hasValue)
+      benchmarkTime = jmax(0.001, args[++i].getDoubleValue());
+    else if (arg=="--stress")
+      stress = true;
+    else if (arg=="--sessions" && hasValue)
+      stressSessions = jmax(1, args[++i].getIntValue());
+    else if (arg=="--session-time" && hasValue)
+      stressSessionTime = jmax(0.01, args[++i].getDoubleValue());
+    else if (arg=="--budget" && hasValue)
+      stressBudget = jmax(0.001, args[++i].getDoubleValue());
+    else if (arg=="--seed" && hasValue)
+      stressSeed = args[++i].getLargeIntValue();
+    else if (arg=="--check-kernels")
+      checkKernels = true;
+    else if (arg=="--write-test-signals" && hasValue)
+      testSignalDir = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+    else if (arg=="--compare" && i+2 < args.size())
+    {
+      compareReference = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+      compareOther = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+    }
+    else if (arg=="--max-abs" && hasValue)
+      thresholds.maxAbsError = args[++i].getDoubleValue();
+    else if (arg=="--max-rms" && hasValue)
+      thresholds.maxRmsError = args[++i].getDoubleValue();
+    else if (arg=="--max-ulp" && hasValue)
+      thresholds.maxUlpDistance = args[++i].getLargeIntValue();
+    else if (arg=="--time" && hasValue)
+      parameters.setParameterValue(PARAMETER_TIME, args[++i].getFloatValue());
+    else if (arg=="--feedback" && hasValue)
+      parameters.setParameterValue(PARAMETER_FEEDBACK, args[++i].getFloatValue());
+    else if (arg=="--bias" && hasValue)
+      parameters.setParameterValue(PARAMETER_BIAS, args[++i].getFloatValue());
+    else if (arg=="--drywet" && hasValue)
+      parameters.setParameterValue(PARAMETER_DRYWET, args[++i].getFloatValue());
+    else if (arg=="--preset" && hasValue)
+    {
+      File preset = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+      if (!loadPreset(preset, parameters))
+      {
+        std::cerr << "Can't load preset " << preset.getFullPathName() << std::endl;
+        return 1;
+      }
+    }
+    else if (arg=="--tail" && hasValue)
+      settings.tailSeconds = jmax(0.0, args[++i].getDoubleValue());
+    else if (arg=="--max-tail" && hasValue)
+      settings.maxTailSeconds = jmax(0.0, args[++i].getDoubleValue());
+    else if (arg=="--block" && hasValue)
+      settings.blockSize = jlimit(16, 65536, args[++i].getIntValue());
+    else if (arg=="--threads" && hasValue)
+      numThreads = jmax(1, args[++i].getIntValue());
+    else if (arg=="-o" && hasValue)
+      outputDir = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+    else if (arg=="--suffix" && hasValue)
+      suffix = args[++i];
+    else if (arg=="--load-state" && hasValue)
+      settings.loadState = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+    else if (arg=="--save-state" && hasValue)
+      settings.saveState = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+    else if (arg.startsWith("-"))
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      printUsage();
+      return 1;
+    }
+    else
+      inputs.add(File::getCurrentWorkingDirectory().getChildFile(arg));
+  }
+
+  if (benchmark)
+  {
+    BiasedDelayBenchmark benchmark(benchmarkTime);
+    std::cout << JSON::toString(benchmark.run()) << std::endl;
+    return 0;
+  }
+
+  if (stress)
+  {
+    StressTest stressTest(stressSessions, stressSessionTime, stressBudget, stressSeed);
+    return stressTest.run() ? 0 : 1;
+  }
+
+  if (testSignalDir != File::nonexistent)
+  {
+    String errorMessage;
+    if (!RenderComparison::writeTestSignals(testSignalDir, errorMessage))
+    {
+      std::cerr << errorMessage << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  if (compareReference != File::nonexistent)
+    return compareRenders(compareReference, compareOther, thresholds);
+
+  if (checkKernels)
+    return RenderComparison::checkKernels(thresholds)==0 ? 0 : 1;
+
+  if (inputs.size()==0)
+  {
+    printUsage();
+    return 1;
+  }
+  if (inputs.size() > 1 && (settings.loadState != File::nonexistent || settings.saveState != File::nonexistent))
+  {
+    std::cerr << "--load-state and --save-state take a single input file" << std::endl;
+    return 1;
+  }
+  // A chunk's tail would be rendered again by the next chunk
+  if (settings.saveState != File::nonexistent)
+  {
+    if (settings.tailSeconds > 0)
+    {
+      std::cerr << "--save-state renders no tail, so it can't take --tail" << std::endl;
+      return 1;
+    }
+    settings.tailSeconds = 0;
+  }
+  if (outputDir != File::nonexistent && !outputDir.createDirectory())
+  {
+    std::cerr << "Can't create " << outputDir.getFullPathName() << std::endl;
+    return 1;
+  }
+
+  for (int i=0; i<parameters.getNumParameters(); i++)
+    settings.parameterValues.add(parameters.getParameterValue(i));
+
+  AudioFormatManager formatManager;
+  formatManager.registerBasicFormats();
+
+  OwnedArray<RenderJob> jobs;
+  for (int i=0; i<inputs.size(); i++)
+  {
+    const File& input = inputs[i];
+    File dir = (outputDir != File::nonexistent) ? outputDir : input.getParentDirectory();
+    File output = dir.getChildFile(input.getFileNameWithoutExtension() + suffix + input.getFileExtension());
+    jobs.add(new RenderJob(formatManager, input, output, settings));
+  }
+
+  // Render
+  double startTime = Time::getMillisecondCounterHiRes();
+  {
+    ThreadPool pool(jmin(numThreads, jobs.size()));
+    for (int i=0; i<jobs.size(); i++)
+      pool.addJob(jobs[i], false);
+    while (pool.getNumJobs() > 0)
+      Thread::sleep(20);
+  }
+  double wallSeconds = (Time::getMillisecondCounterHiRes() - startTime) / 1000;
+
+  // Report
+  int numFailed = 0;
+  double audioSeconds = 0;
+  for (int i=0; i<jobs.size(); i++)
+  {
+    RenderJob* job = jobs[i];
+    if (!job->wasSuccessful())
+    {
+      numFailed++;
+      std::cerr << job->getInputFile().getFullPathName() << ": " << job->getErrorMessage() << std::endl;
+      continue;
+    }
+    audioSeconds += job->getAudioSeconds();
+    std::cout << job->getOutputFile().getFullPathName() << ": "
+      << String(job->getAudioSeconds(), 2) << "s audio, "
+      << String(job->getAudioSeconds() / jmax(0.001, job->getRenderSeconds()), 1) << "x realtime" << std::endl;
+  }
+  std::cout << (jobs.size() - numFailed) << " of " << jobs.size() << " files, "
+    << String(audioSeconds, 2) << "s audio in " << String(wallSeconds, 2) << "s, "
+    << String(audioSeconds / jmax(0.001, wallSeconds), 1) << "x realtime" << std::endl;
+
+  return numFailed==0 ? 0 : 1;
+}
@@ -0,0 +1,437 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+*/
+
+/**
+ * RenderComparison.cpp
+ * BiasedDelayRender
+ */
+
+#include "RenderComparison.h"
+#include "../../Source/BiasedDelay.h"
+
+#include <iostream>
+
+const double SIGNAL_SAMPLE_RATE = 48000;
+const int SIGNAL_CHANNELS = 2;
+const double SIGNAL_LENGTH = 3; // in seconds
+
+const int COMPARE_BLOCK_SIZE = 4096;
+
+// Kernel checks: the test signals are widened to this many channels (at
+// decreasing levels), so the parallel mode has enough to fan out.
+const int CHECK_CHANNELS = MIN_PARALLEL_CHANNELS;
+const int CHECK_BLOCK_SIZE = 512;
+const int CHECK_ODD_BLOCK_SIZES[] = { 1, 37, 1000, 3, 511, 4096 };
+
+// Time, feedback, bias, dry/wet
+const float CHECK_PARAMETERS[][NUM_PARAMETERS] = {
+  { 0.2f, 0.1f, 0.5f, 0.5f },   // Defaults
+  { 0.01f, 0.9f, 0.1f, 0.8f },  // Short, heavy feedback, low bias
+  { 0.05f, 0.7f, 0.95f, 1.0f }  // High bias, fully wet
+};
+
+enum CheckMode {
+  CHECK_SERIAL = 0,
+  CHECK_ODD_BLOCKS,
+  CHECK_PARALLEL,
+  CHECK_MORPHING,
+  CHECK_STATE_RESTORE,
+  CHECK_AUTOMATION,
+  NUM_CHECK_MODES
+};
+const char* const CHECK_MODE_NAMES[] = {
+  "processBlock", "processBlock (odd block sizes)", "processBlock (parallel)",
+  "processBlock (morphing)", "processBlock (state save/restore)",
+  "processBlock (automation during a morph)"
+};
+
+ComparisonThresholds::ComparisonThresholds() :
+  maxAbsError(0), maxRmsError(0), maxUlpDistance(0) {
+}
+
+ComparisonResult::ComparisonResult() :
+  numSamples(0), maxAbsError(0), rmsError(0), maxUlpDistance(0) {
+}
+
+bool ComparisonResult::passes(const ComparisonThresholds& thresholds) const {
+  return errorMessage.isEmpty()
+    && maxAbsError <= thresholds.maxAbsError
+    && rmsError <= thresholds.maxRmsError
+    && maxUlpDistance <= thresholds.maxUlpDistance;
+}
+
+/**
+ * Comparison.
+ */
+
+static void addSample(ComparisonResult& result, double& sumOfSquares, float a, float b){
+  double error = std::abs((double)a - (double)b);
+  result.maxAbsError = jmax(result.maxAbsError, error);
+  result.maxUlpDistance = jmax(result.maxUlpDistance, RenderComparison::getUlpDistance(a, b));
+  sumOfSquares += error * error;
+}
+
+ComparisonResult RenderComparison::compare(AudioFormatManager& formatManager,
+                                           const File& reference, const File& other){
+  ComparisonResult result;
+  ScopedPointer<AudioFormatReader> a(formatManager.createReaderFor(reference));
+  ScopedPointer<AudioFormatReader> b(formatManager.createReaderFor(other));
+  if (a == nullptr || b == nullptr)
+  {
+    result.errorMessage = "Can't read " + (a == nullptr ? reference : other).getFullPathName();
+    return result;
+  }
+  if (a->numChannels != b->numChannels || a->lengthInSamples != b->lengthInSamples)
+  {
+    result.errorMessage = "Layout differs: "
+      + String(a->numChannels) + " channels/" + String(a->lengthInSamples) + " samples vs. "
+      + String(b->numChannels) + " channels/" + String(b->lengthInSamples) + " samples";
+    return result;
+  }
+
+  const int numChannels = (int)a->numChannels;
+  AudioSampleBuffer bufferA(numChannels, COMPARE_BLOCK_SIZE);
+  AudioSampleBuffer bufferB(numChannels, COMPARE_BLOCK_SIZE);
+  double sumOfSquares = 0;
+
+  for (int64 position=0; position<a->lengthInSamples; position+=COMPARE_BLOCK_SIZE)
+  {
+    int numSamples = (int)jmin((int64)COMPARE_BLOCK_SIZE, a->lengthInSamples - position);
+    a->read((int**)bufferA.getArrayOfChannels(), numChannels, position, numSamples, false);
+    b->read((int**)bufferB.getArrayOfChannels(), numChannels, position, numSamples, false);
+
+    for (int channel=0; channel<numChannels; channel++)
+    {
+      const float* x = bufferA.getSampleData(channel);
+      const float* y = bufferB.getSampleData(channel);
+      for (int i=0; i<numSamples; i++)
+      {
+        // Integer formats: compare the raw values scaled to [-1..1].
+        float sx = a->usesFloatingPointData ? x[i] : *reinterpret_cast<const int*>(x + i) / (float)0x7fffffff;
+        float sy = b->usesFloatingPointData ? y[i] : *reinterpret_cast<const int*>(y + i) / (float)0x7fffffff;
+        addSample(result, sumOfSquares, sx, sy);
+      }
+    }
+    result.numSamples += numSamples * numChannels;
+  }
+
+  if (result.numSamples > 0)
+    result.rmsError = std::sqrt(sumOfSquares / result.numSamples);
+  return result;
+}
+
+ComparisonResult RenderComparison::compare(const AudioSampleBuffer& reference, const AudioSampleBuffer& other){
+  ComparisonResult result;
+  if (reference.getNumChannels() != other.getNumChannels() || reference.getNumSamples() != other.getNumSamples())
+  {
+    result.errorMessage = "Layout differs";
+    return result;
+  }
+
+  double sumOfSquares = 0;
+  for (int channel=0; channel<reference.getNumChannels(); channel++)
+  {
+    const float* x = reference.getSampleData(channel);
+    const float* y = other.getSampleData(channel);
+    for (int i=0; i<reference.getNumSamples(); i++)
+      addSample(result, sumOfSquares, x[i], y[i]);
+  }
+  result.numSamples = (int64)reference.getNumChannels() * reference.getNumSamples();
+  if (result.numSamples > 0)
+    result.rmsError = std::sqrt(sumOfSquares / result.numSamples);
+  return result;
+}
+
+// Maps float bit patterns onto a monotonic integer line, so
+// neighbouring floats are 1 apart (and +0/-0 are 0 apart).
+int64 RenderComparison::getUlpDistance(float a, float b){
+  union { float f; int32 i; } ua, ub;
+  ua.f = a;
+  ub.f = b;
+  int64 ia = ua.i < 0 ? (int64)(int32)0x80000000 - ua.i : ua.i;
+  int64 ib = ub.i < 0 ? (int64)(int32)0x80000000 - ub.i : ub.i;
+  return ia > ib ? ia - ib : ib - ia;
+}
+
+/**
+ * Test signals.
+ */
+
+static bool writeSignal(const File& file, const AudioSampleBuffer& signal, String& errorMessage){
+  file.deleteFile();
+  ScopedPointer<FileOutputStream> stream(file.createOutputStream());
+  WavAudioFormat wavFormat;
+  ScopedPointer<AudioFormatWriter> writer;
+  if (stream != nullptr)
+    writer = wavFormat.createWriterFor(stream, SIGNAL_SAMPLE_RATE, signal.getNumChannels(),
+                                       32, StringPairArray(), 0);
+  if (writer == nullptr)
+  {
+    errorMessage = "Can't write " + file.getFullPathName();
+    return false;
+  }
+  stream.release(); // Now owned by the writer
+  return writer->writeFromAudioSampleBuffer(signal, 0, signal.getNumSamples());
+}
+
+void RenderComparison::createTestSignals(StringArray& names, OwnedArray<AudioSampleBuffer>& signals){
+  const int length = (int)(SIGNAL_LENGTH * SIGNAL_SAMPLE_RATE);
+
+  // Impulses: one per second, alternating polarity
+  AudioSampleBuffer* signal = new AudioSampleBuffer(SIGNAL_CHANNELS, length);
+  signals.add(signal);
+  names.add("impulse");
+  signal->clear();
+  for (int channel=0; channel<SIGNAL_CHANNELS; channel++)
+    for (int i=0; i<length; i+=(int)SIGNAL_SAMPLE_RATE)
+      *signal->getSampleData(channel, i + channel) = (i/(int)SIGNAL_SAMPLE_RATE) % 2 ? -0.9f : 0.9f;
+
+  // Exponential sine sweep, 20Hz..20kHz
+  signal = new AudioSampleBuffer(SIGNAL_CHANNELS, length);
+  signals.add(signal);
+  names.add("sweep");
+  const double f0 = 20, f1 = 20000;
+  const double k = std::log(f1 / f0);
+  for (int channel=0; channel<SIGNAL_CHANNELS; channel++)
+  {
+    float* samples = signal->getSampleData(channel);
+    for (int i=0; i<length; i++)
+    {
+      double t = i / SIGNAL_SAMPLE_RATE;
+      double phase = 2 * double_Pi * f0 * SIGNAL_LENGTH / k * (std::exp(t / SIGNAL_LENGTH * k) - 1);
+      samples[i] = 0.5f * (float)std::sin(phase);
+    }
+  }
+
+  // White noise at a nominal and a clipping level
+  const float levels[] = { 0.5f, 2.0f };
+  const char* noiseNames[] = { "noise", "noise-hot" };
+  for (int n=0; n<2; n++)
+  {
+    signal = new AudioSampleBuffer(SIGNAL_CHANNELS, length);
+    signals.add(signal);
+    names.add(noiseNames[n]);
+    Random random(0x5eed + n);
+    for (int channel=0; channel<SIGNAL_CHANNELS; channel++)
+    {
+      float* samples = signal->getSampleData(channel);
+      for (int i=0; i<length; i++)
+        samples[i] = levels[n] * (random.nextFloat() * 2 - 1);
+    }
+  }
+}
+
+bool RenderComparison::writeTestSignals(const File& dir, String& errorMessage){
+  if (!dir.createDirectory())
+  {
+    errorMessage = "Can't create " + dir.getFullPathName();
+    return false;
+  }
+
+  StringArray names;
+  OwnedArray<AudioSampleBuffer> signals;
+  createTestSignals(names, signals);
+  for (int i=0; i<signals.size(); i++)
+    if (!writeSignal(dir.getChildFile(names[i] + ".wav"), *signals[i], errorMessage))
+      return false;
+  return true;
+}
+
+/**
+ * Reference kernel: a frozen copy of the original scalar
+ * BiasedDelay::processChannelBlock, and of the helpers it calls. Leave
+ * it alone when optimising the plugin; it's what the plugin is checked
+ * against.
+ */
+
+static float referenceSigmoid(float x){
+  return sin(fminf(1, fmaxf(0, x)) * M_PI - M_PI_2) / 2 + 0.5f;
+}
+
+static float referenceBiasExponent(float p1){
+  if (p1 < 0.5)
+  {
+    p1 = p1 * 2;
+    return p1*p1 * (MED_BIAS-MIN_BIAS) + MIN_BIAS;
+  } else
+  {
+    p1 = (p1 - 0.5) * 2;
+    return p1*p1 * (MAX_BIAS-MED_BIAS) + MED_BIAS;
+  }
+}
+
+static float referenceApplyBias(float v, float bias){
+  return powf(fabs(v), bias) * (v < 0 ? -1 : 1);
+}
+
+static float referenceSoftLimit(float v){
+  return fminf(1, fmaxf(-1, v));
+}
+
+static float referenceSigmoidXFade(float a, float b, float mix){
+  return a * referenceSigmoid(1 - mix) + b * referenceSigmoid(mix);
+}
+
+// One channel, from a silent delay buffer. sampleRate is a float, as in
+// BiasedDelay, so the delay length rounds the same way.
+static void renderReferenceChannel(float* buf, int size, const float* parameters, float sampleRate){
+  unsigned int sampleDelay = (MIN_DELAY + parameters[PARAMETER_TIME] * (MAX_DELAY-MIN_DELAY)) * sampleRate;
+  float feedback = parameters[PARAMETER_FEEDBACK];
+  float bias = referenceBiasExponent(1 - parameters[PARAMETER_BIAS]);
+  float dryWetMix = parameters[PARAMETER_DRYWET];
+
+  HeapBlock<float> delayBuf(sampleDelay, true);
+  unsigned int delayBufIdx = 0;
+  for (int i=0; i<size; i++)
+  {
+    float delaySample = delayBuf[delayBufIdx];
+    float v = buf[i] + delaySample * feedback;
+    v = referenceApplyBias(v, bias);
+    delayBuf[delayBufIdx] = referenceSoftLimit(v);
+    buf[i] = referenceSigmoidXFade(buf[i], delaySample, dryWetMix);
+
+    delayBufIdx = (delayBufIdx + 1) % sampleDelay;
+  }
+}
+
+/**
+ * Kernel checks.
+ */
+
+static BiasedDelay* createCheckInstance(const float* parameters, bool parallel){
+  BiasedDelay* biasedDelay = new BiasedDelay();
+  for (int i=0; i<NUM_PARAMETERS; i++)
+    biasedDelay->setParameterValue(i, parameters[i]);
+  biasedDelay->setParallelProcessing(parallel);
+  biasedDelay->prepareToPlay(SIGNAL_SAMPLE_RATE, CHECK_BLOCK_SIZE, CHECK_CHANNELS);
+  return biasedDelay;
+}
+
+// Renders buffer in place with one of CHECK_MODE_NAMES. Returns false,
+// and renders nothing, if the parallel mode got no workers: it would
+// only run serially again.
+static bool renderCheckMode(int mode, AudioSampleBuffer& buffer, const float* parameters){
+  ScopedPointer<BiasedDelay> biasedDelay(createCheckInstance(parameters, mode==CHECK_PARALLEL));
+  if (mode==CHECK_PARALLEL && biasedDelay->getNumWorkers()==0)
+    return false;
+  MidiBuffer midiMessages;
+
+  // Morphing towards the current values runs the morphing kernel
+  // without changing the result.
+  ParameterSet sameParameters;
+  for (int i=0; i<NUM_PARAMETERS; i++)
+    sameParameters.values[i] = parameters[i];
+  if (mode==CHECK_MORPHING)
+    biasedDelay->setParameterSet(sameParameters, SIGNAL_LENGTH);
+
+  // Morph towards other values, and have the host automate every
+  // parameter back to where it was: half of them while the switch is
+  // pending, half once the morph has started (an empty block takes the
+  // switch). Automation wins, so the result mustn't change.
+  if (mode==CHECK_AUTOMATION)
+  {
+    ParameterSet otherParameters;
+    for (int i=0; i<NUM_PARAMETERS; i++)
+      otherParameters.values[i] = 1 - parameters[i];
+    biasedDelay->setParameterSet(otherParameters, SIGNAL_LENGTH);
+    for (int i=0; i<NUM_PARAMETERS; i+=2)
+      biasedDelay->setAutomatedParameterValue(i, parameters[i]);
+    AudioSampleBuffer empty(buffer.getArrayOfChannels(), buffer.getNumChannels(), 0);
+    biasedDelay->processBlock(empty, buffer.getNumChannels(), buffer.getNumChannels(), midiMessages);
+    for (int i=1; i<NUM_PARAMETERS; i+=2)
+      biasedDelay->setAutomatedParameterValue(i, parameters[i]);
+  }
+
+  const int length = buffer.getNumSamples();
+  bool restored = false;
+  for (int position=0, block=0; position<length; block++)
+  {
+    // Continue in a new instance from the saved state, half-way through
+    if (mode==CHECK_STATE_RESTORE && !restored && position >= length / 2)
+    {
+      MemoryBlock state;
+      biasedDelay->setStoreDelayBuffer(true);
+      biasedDelay->getStateInformation(state);
+      biasedDelay = new BiasedDelay();
+      biasedDelay->setStateInformation(state.getData(), (int)state.getSize());
+      biasedDelay->prepareToPlay(SIGNAL_SAMPLE_RATE, CHECK_BLOCK_SIZE, CHECK_CHANNELS);
+      restored = true;
+    }
+
+    const int blockSize = mode==CHECK_ODD_BLOCKS ?
+      CHECK_ODD_BLOCK_SIZES[block % numElementsInArray(CHECK_ODD_BLOCK_SIZES)] : CHECK_BLOCK_SIZE;
+    const int numSamples = jmin(blockSize, length - position);
+    AudioSampleBuffer view(buffer.getArrayOfChannels(), buffer.getNumChannels(), position, numSamples);
+    biasedDelay->processBlock(view, buffer.getNumChannels(), buffer.getNumChannels(), midiMessages);
+    position += numSamples;
+  }
+  return true;
+}
+
+int RenderComparison::checkKernels(const ComparisonThresholds& thresholds){
+  StringArray names;
+  OwnedArray<AudioSampleBuffer> signals;
+  createTestSignals(names, signals);
+
+  int numCases = 0;
+  int numFailed = 0;
+  int numSkipped = 0;
+  for (int s=0; s<signals.size(); s++)
+  {
+    const AudioSampleBuffer& signal = *signals[s];
+    AudioSampleBuffer input(CHECK_CHANNELS, signal.getNumSamples());
+    for (int channel=0; channel<CHECK_CHANNELS; channel++)
+      input.copyFrom(channel, 0, signal.getSampleData(channel % SIGNAL_CHANNELS), signal.getNumSamples(),
+                     1.0f - 0.1f * (channel / SIGNAL_CHANNELS));
+
+    for (int p=0; p<numElementsInArray(CHECK_PARAMETERS); p++)
+    {
+      const float* parameters = CHECK_PARAMETERS[p];
+      AudioSampleBuffer reference(input);
+      for (int channel=0; channel<CHECK_CHANNELS; channel++)
+        renderReferenceChannel(reference.getSampleData(channel), reference.getNumSamples(),
+                               parameters, (float)SIGNAL_SAMPLE_RATE);
+
+      for (int mode=0; mode<NUM_CHECK_MODES; mode++)
+      {
+        AudioSampleBuffer output(input);
+        if (!renderCheckMode(mode, output, parameters))
+        {
+          numSkipped++;
+          std::cout << "SKIP " << CHECK_MODE_NAMES[mode] << ", " << names[s]
+            << ", parameters " << p << ": no worker threads (one CPU, or no realtime scheduling), would run serially" << std::endl;
+          continue;
+        }
+        ComparisonResult result = compare(reference, output);
+        bool passed = result.passes(thresholds);
+        numCases++;
+        if (!passed)
+          numFailed++;
+
+        std::cout << (passed ? "PASS " : "FAIL ") << CHECK_MODE_NAMES[mode] << ", " << names[s]
+          << ", parameters " << p << ": max abs " << String(result.maxAbsError, 9)
+          << ", rms " << String(result.rmsError, 9)
+          << ", max ulp " << result.maxUlpDistance << std::endl;
+      }
+    }
+  }
+  std::cout << (numCases - numFailed) << " of " << numCases << " passed";
+  if (numSkipped > 0)
+    std::cout << ", " << numSkipped << " skipped (no worker threads for the parallel mode)";
+  std::cout << std::endl;
+  return numFailed;
+}
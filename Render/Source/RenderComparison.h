@@ -0,0 +1,81 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+ */
+
+/**
+ * RenderComparison.h
+ * BiasedDelayRender
+ *
+ * Golden-output checks: deterministic test signals, a sample-by-sample
+ * comparison of a render against a reference render, and a check of
+ * BiasedDelay's processing modes against a reference kernel.
+ */
+
+#ifndef BiasedDelayRender_RenderComparison_h
+#define BiasedDelayRender_RenderComparison_h
+
+#include "JuceHeader.h"
+
+struct ComparisonThresholds {
+  ComparisonThresholds();
+
+  double maxAbsError;
+  double maxRmsError;
+  int64 maxUlpDistance;
+};
+
+struct ComparisonResult {
+  ComparisonResult();
+  bool passes(const ComparisonThresholds& thresholds) const;
+
+  String errorMessage; // Set if the files couldn't be compared at all
+  int64 numSamples;
+  double maxAbsError;
+  double rmsError;
+  int64 maxUlpDistance;
+};
+
+class RenderComparison {
+public:
+  // Compares every sample of every channel. Files must match in
+  // channel count and length.
+  static ComparisonResult compare(AudioFormatManager& formatManager,
+                                  const File& reference, const File& other);
+
+  // Same, for two buffers of the same layout
+  static ComparisonResult compare(const AudioSampleBuffer& reference, const AudioSampleBuffer& other);
+
+  // Writes impulse, sweep and noise signals as 32-bit float WAVs; noise
+  // uses fixed Random seeds, so every build writes identical files.
+  static bool writeTestSignals(const File& dir, String& errorMessage);
+
+  // Renders the test signals through a frozen copy of the original scalar
+  // processChannelBlock, and through each of BiasedDelay's processing
+  // modes (block sizes, parallel channels, the morphing kernel, a state
+  // save/restore mid-stream, host automation overriding a morph), and
+  // compares every mode against the reference. Prints one line per case;
+  // returns the number of failures. Parallel cases without workers are
+  // skipped, not run serially.
+  static int checkKernels(const ComparisonThresholds& thresholds);
+
+  // Distance between two floats in units in the last place
+  static int64 getUlpDistance(float a, float b);
+
+private:
+  static void createTestSignals(StringArray& names, OwnedArray<AudioSampleBuffer>& signals);
+};
+
+#endif
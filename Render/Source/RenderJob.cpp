@@ -0,0 +1,195 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+*/
+
+/**
+ * RenderJob.cpp
+ * BiasedDelayRender
+ */
+
+#include "RenderJob.h"
+
+RenderSettings::RenderSettings() :
+  blockSize(512), tailSeconds(-1), maxTailSeconds(DEFAULT_MAX_TAIL) {
+}
+
+RenderJob::RenderJob(AudioFormatManager& formatManager, const File& input,
+                     const File& output, const RenderSettings& settings) :
+  ThreadPoolJob(input.getFileName()),
+  formatManager(formatManager), input(input), output(output), settings(settings),
+  errorMessage("Not rendered"), audioSeconds(0), renderSeconds(0) {
+}
+
+ThreadPoolJob::JobStatus RenderJob::runJob(){
+  errorMessage = String::empty;
+  double startTime = Time::getMillisecondCounterHiRes();
+
+  ScopedPointer<AudioFormatReader> reader(createReader());
+  if (reader == nullptr)
+  {
+    errorMessage = "Can't read " + input.getFullPathName();
+    return jobHasFinished;
+  }
+
+  ScopedPointer<AudioFormatWriter> writer(createWriter(*reader));
+  if (writer == nullptr)
+  {
+    errorMessage = "Can't write " + output.getFullPathName();
+    return jobHasFinished;
+  }
+
+  render(*reader, *writer);
+  renderSeconds = (Time::getMillisecondCounterHiRes() - startTime) / 1000;
+  return jobHasFinished;
+}
+
+// Memory-mapped WAV where possible, then any registered format.
+AudioFormatReader* RenderJob::createReader(){
+  WavAudioFormat wavFormat;
+  if (input.hasFileExtension(wavFormat.getFileExtensions().joinIntoString(";")))
+  {
+    ScopedPointer<MemoryMappedAudioFormatReader> mapped(wavFormat.createMemoryMappedReader(input));
+    if (mapped != nullptr && mapped->mapEntireFile())
+      return mapped.release();
+  }
+  return formatManager.createReaderFor(input);
+}
+
+// Same format, rate, channels and resolution as the input; WAV if
+// we can't write the input's format.
+AudioFormatWriter* RenderJob::createWriter(AudioFormatReader& reader){
+  AudioFormat* format = formatManager.findFormatForFileExtension(output.getFileExtension());
+  if (format == nullptr)
+    format = formatManager.findFormatForFileExtension("wav");
+
+  output.deleteFile();
+  ScopedPointer<FileOutputStream> stream(output.createOutputStream());
+  if (stream == nullptr)
+    return nullptr;
+
+  AudioFormatWriter* writer = format->createWriterFor(stream, reader.sampleRate,
+                                                      reader.numChannels,
+                                                      (int)reader.bitsPerSample,
+                                                      reader.metadataValues, 0);
+  if (writer != nullptr)
+    stream.release(); // Now owned by the writer
+  else
+  {
+    stream = nullptr;
+    output.deleteFile();
+  }
+  return writer;
+}
+
+void RenderJob::render(AudioFormatReader& reader, AudioFormatWriter& writer){
+  const int numChannels = (int)reader.numChannels;
+  const int blockSize = settings.blockSize;
+
+  BiasedDelay biasedDelay;
+  for (int i=0; i<settings.parameterValues.size(); i++)
+    biasedDelay.setParameterValue(i, settings.parameterValues[i]);
+  if (settings.loadState != File::nonexistent)
+  {
+    MemoryBlock state;
+    if (!settings.loadState.loadFileAsData(state) ||
+        !biasedDelay.setStateInformation(state.getData(), (int)state.getSize()))
+    {
+      errorMessage = "Can't load state " + settings.loadState.getFullPathName();
+      return;
+    }
+  }
+  biasedDelay.prepareToPlay(reader.sampleRate, blockSize, numChannels);
+  if (biasedDelay.getNumChannels() < numChannels)
+  {
+    errorMessage = String(numChannels) + " channels, can only process " + String(biasedDelay.getNumChannels());
+    return;
+  }
+
+  AudioSampleBuffer buffer(numChannels, blockSize);
+  MidiBuffer midiMessages;
+
+  // Input
+  int64 position = 0;
+  while (position < reader.lengthInSamples)
+  {
+    if (shouldExit())
+    {
+      errorMessage = "Cancelled";
+      return;
+    }
+    int numSamples = (int)jmin((int64)blockSize, reader.lengthInSamples - position);
+    AudioSampleBuffer block(buffer.getArrayOfChannels(), numChannels, numSamples);
+
+    // AudioFormatReader::read(AudioSampleBuffer*...) only handles stereo.
+    reader.read((int**)block.getArrayOfChannels(), numChannels, position, numSamples, false);
+    if (!reader.usesFloatingPointData)
+    {
+      for (int channel=0; channel<numChannels; channel++)
+      {
+        float* samples = block.getSampleData(channel);
+        const float multiplier = 1.0f / 0x7fffffff;
+        for (int i=0; i<numSamples; i++)
+          samples[i] = *reinterpret_cast<int*>(samples + i) * multiplier;
+      }
+    }
+
+    biasedDelay.processBlock(block, numChannels, numChannels, midiMessages);
+    writer.writeFromAudioSampleBuffer(block, 0, numSamples);
+    position += numSamples;
+  }
+
+  // The next chunk continues from the end of the input, not of the tail
+  if (settings.saveState != File::nonexistent)
+  {
+    MemoryBlock state;
+    biasedDelay.setStoreDelayBuffer(true);
+    biasedDelay.getStateInformation(state);
+    if (!settings.saveState.replaceWithData(state.getData(), state.getSize()))
+    {
+      errorMessage = "Can't save state " + settings.saveState.getFullPathName();
+      return;
+    }
+  }
+
+  // Tail: either a fixed length, or until a full delay period has
+  // stayed below TAIL_THRESHOLD.
+  const int64 maxTail = (int64)((settings.tailSeconds < 0 ? settings.maxTailSeconds : settings.tailSeconds) * reader.sampleRate);
+  const int64 silencePeriod = (int64)(biasedDelay.getDelayTime() * reader.sampleRate) + blockSize;
+  int64 tail = 0;
+  int64 silence = 0;
+  while (tail < maxTail && (settings.tailSeconds >= 0 || silence < silencePeriod))
+  {
+    if (shouldExit())
+    {
+      errorMessage = "Cancelled";
+      return;
+    }
+    int numSamples = (int)jmin((int64)blockSize, maxTail - tail);
+    AudioSampleBuffer block(buffer.getArrayOfChannels(), numChannels, numSamples);
+    block.clear();
+
+    biasedDelay.processBlock(block, numChannels, numChannels, midiMessages);
+    writer.writeFromAudioSampleBuffer(block, 0, numSamples);
+    tail += numSamples;
+
+    if (block.getMagnitude(0, numSamples) < TAIL_THRESHOLD)
+      silence += numSamples;
+    else
+      silence = 0;
+  }
+
+  audioSeconds = (position + tail) / reader.sampleRate;
+}
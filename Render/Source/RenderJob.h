@@ -0,0 +1,87 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+ */
+
+/**
+ * RenderJob.h
+ * BiasedDelayRender
+ *
+ * Streams one audio file through a BiasedDelay instance.
+ */
+
+#ifndef BiasedDelayRender_RenderJob_h
+#define BiasedDelayRender_RenderJob_h
+
+#include "JuceHeader.h"
+#include "../../Source/BiasedDelay.h"
+
+// Output below this level counts as silence when rendering the tail
+const float TAIL_THRESHOLD = 0.00003f; // ca. -90dBFS
+const double DEFAULT_MAX_TAIL = 30; // in seconds
+
+struct RenderSettings {
+  RenderSettings();
+
+  Array<float> parameterValues;
+  int blockSize;
+
+  // Fixed tail length in seconds; negative: render until the tail
+  // has decayed, but at most maxTailSeconds.
+  double tailSeconds;
+  double maxTailSeconds;
+
+  // Binary plugin state to start from, and to save at the end of the
+  // input, before any tail. The saved state includes the delay buffer,
+  // so consecutive chunks of a file, rendered without a tail, render
+  // exactly like the whole file.
+  File loadState;
+  File saveState;
+};
+
+class RenderJob : public ThreadPoolJob {
+public:
+  RenderJob(AudioFormatManager& formatManager, const File& input,
+            const File& output, const RenderSettings& settings);
+
+  JobStatus runJob();
+
+  // Results, valid once the job has finished
+  bool wasSuccessful(){return errorMessage.isEmpty();};
+  const String& getErrorMessage(){return errorMessage;};
+  const File& getInputFile(){return input;};
+  const File& getOutputFile(){return output;};
+  double getAudioSeconds(){return audioSeconds;};
+  double getRenderSeconds(){return renderSeconds;};
+
+private:
+  AudioFormatReader* createReader();
+  AudioFormatWriter* createWriter(AudioFormatReader& reader);
+  void render(AudioFormatReader& reader, AudioFormatWriter& writer);
+
+private:
+  AudioFormatManager& formatManager;
+  File input;
+  File output;
+  RenderSettings settings;
+
+  String errorMessage;
+  double audioSeconds;
+  double renderSeconds;
+
+  JUCE_DECLARE_NON_COPYABLE (RenderJob)
+};
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+*/
+
+/**
+ * StressTest.cpp
+ * BiasedDelayRender
+ */
+
+#include "StressTest.h"
+
+#include <iostream>
+
+const double STRESS_SAMPLE_RATES[] = { 44100, 48000, 88200, 96000, 176400, 192000 };
+const int STRESS_BLOCK_SIZES[] = { 32, 64, 128, 256, 512, 1024 };
+const int STRESS_CHANNEL_COUNTS[] = { 1, 2, 6, 8, 16 };
+
+// Chance per block of a parameter change, and of switching the input
+const float AUTOMATION_RATE = 0.2f;
+const float SIGNAL_CHANGE_RATE = 0.02f;
+
+StressTest::StressTest(int numSessions, double secondsPerSession, double budget, int64 seed) :
+  numSessions(numSessions), secondsPerSession(secondsPerSession), budget(budget), random(seed) {
+  biasedDelay.setParallelProcessing(true);
+}
+
+bool StressTest::run(){
+  int numFailed = 0;
+  for (int session=0; session<numSessions; session++)
+    if (!runSession(session))
+      numFailed++;
+  std::cout << (numSessions - numFailed) << " of " << numSessions << " sessions within budget" << std::endl;
+
+  if (RealtimeCheck::isEnabled())
+  {
+    std::cout << RealtimeCheck::getNumViolations() << " realtime violations" << std::endl;
+    if (RealtimeCheck::getNumViolations() > 0)
+      return false;
+  }
+  return numFailed == 0;
+}
+
+// One host session: re-prepared for a new layout and sample rate, like
+// a host switching settings, then a stream of blocks with automation.
+// Only processBlock is timed.
+bool StressTest::runSession(int session){
+  const double sampleRate = STRESS_SAMPLE_RATES[random.nextInt(numElementsInArray(STRESS_SAMPLE_RATES))];
+  const int blockSize = STRESS_BLOCK_SIZES[random.nextInt(numElementsInArray(STRESS_BLOCK_SIZES))];
+  const int numChannels = STRESS_CHANNEL_COUNTS[random.nextInt(numElementsInArray(STRESS_CHANNEL_COUNTS))];
+
+  biasedDelay.prepareToPlay(sampleRate, blockSize, numChannels);
+
+  BlockTimeHistogram blockTimes;
+  blockTimes.setBudget(budget * blockSize / sampleRate);
+
+  AudioSampleBuffer buffer(numChannels, blockSize);
+  MidiBuffer midiMessages;
+  Signal signal = SIGNAL_NOISE;
+  const int numBlocks = (int)(secondsPerSession * sampleRate / blockSize);
+
+  for (int block=0; block<numBlocks; block++)
+  {
+    if (random.nextFloat() < AUTOMATION_RATE)
+      automate();
+    if (random.nextFloat() < SIGNAL_CHANGE_RATE)
+      signal = (Signal)random.nextInt(NUM_SIGNALS);
+    fill(buffer, signal);
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+    biasedDelay.processBlock(buffer, numChannels, numChannels, midiMessages);
+    blockTimes.addBlock(startTicks, Time::getHighResolutionTicks());
+  }
+
+  const bool passed = blockTimes.getNumOverruns() == 0;
+  std::cout << (passed ? "PASS " : "FAIL ") << "session " << session << ": "
+    << String(sampleRate / 1000, 1) << "kHz, " << blockSize << " samples, "
+    << numChannels << " channels, budget " << String(blockTimes.getBudget() * 1e6, 1) << "us: "
+    << blockTimes.toString() << std::endl;
+  return passed;
+}
+
+// Random parameter jumps, biased towards the extremes: full feedback
+// and the ends of the bias range are where the kernel works hardest.
+void StressTest::automate(){
+  const int index = random.nextInt(biasedDelay.getNumParameters());
+  float value;
+  switch (random.nextInt(3))
+  {
+    case 0: value = 0; break;
+    case 1: value = 1; break;
+    default: value = random.nextFloat(); break;
+  }
+  biasedDelay.setAutomatedParameterValue(index, value);
+}
+
+void StressTest::fill(AudioSampleBuffer& buffer, Signal signal){
+  for (int channel=0; channel<buffer.getNumChannels(); channel++)
+  {
+    float* samples = buffer.getSampleData(channel);
+    for (int i=0; i<buffer.getNumSamples(); i++)
+    {
+      switch (signal)
+      {
+        case SIGNAL_NOISE: samples[i] = random.nextFloat() * 2 - 1; break;
+        case SIGNAL_SILENCE: samples[i] = 0; break;
+        case SIGNAL_DENORMAL: samples[i] = (random.nextFloat() - 0.5f) * 1e-38f; break;
+        case SIGNAL_FULL_SCALE: samples[i] = (i / 16) % 2 ? -1.0f : 1.0f; break;
+        default: break;
+      }
+    }
+  }
+}
@@ -0,0 +1,63 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+ */
+
+/**
+ * StressTest.h
+ * BiasedDelayRender
+ *
+ * Worst-case timing under hostile conditions: randomized automation,
+ * extreme settings, sample rate switches and denormal input. Every
+ * block is checked against a deadline.
+ */
+
+#ifndef BiasedDelayRender_StressTest_h
+#define BiasedDelayRender_StressTest_h
+
+#include "JuceHeader.h"
+#include "../../Source/BiasedDelay.h"
+#include "../../Source/BlockTimeHistogram.h"
+
+class StressTest {
+public:
+  // budget: deadline as a fraction of each block's duration
+  StressTest(int numSessions, double secondsPerSession, double budget, int64 seed);
+
+  // Prints a line per session; returns false if any block was late
+  bool run();
+
+private:
+  enum Signal {
+    SIGNAL_NOISE = 0,
+    SIGNAL_SILENCE,
+    SIGNAL_DENORMAL,
+    SIGNAL_FULL_SCALE,
+    NUM_SIGNALS
+  };
+
+  bool runSession(int session);
+  void automate();
+  void fill(AudioSampleBuffer& buffer, Signal signal);
+
+private:
+  int numSessions;
+  double secondsPerSession;
+  double budget;
+  Random random;
+  BiasedDelay biasedDelay;
+};
+
+#endif
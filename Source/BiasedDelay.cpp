@@ -25,7 +25,40 @@
 
 #include "BiasedDelay.h"
 
-BiasedDelay::BiasedDelay() : delayBuffer(MAX_CHANNELS, INITIAL_BUFFER_SIZE) {
+// Binary state: a fixed header, then tagged sections of
+// { uint32 id, uint32 size, payload }, all little-endian. Readers
+// skip sections they don't know, so adding one needs no version bump.
+const uint32 STATE_MAGIC = 0x74734442; // "BDst"
+const uint16 STATE_VERSION = 1;
+const int STATE_HEADER_SIZE = 8; // magic, version, header size
+const int STATE_SECTION_HEADER_SIZE = 8;
+
+// { uint32 count, float values[count] }
+const uint32 STATE_SECTION_PARAMETERS = 0x4d524150; // "PARM"
+
+// { uint32 channels, uint32 samples, uint32 index, gzip(float samples[channels][samples]) }
+const uint32 STATE_SECTION_DELAY_BUFFER = 0x46554244; // "DBUF"
+const int DELAY_SNAPSHOT_HEADER_SIZE = 12;
+const int MAX_SNAPSHOT_SAMPLES = MAX_DELAY * 384000; // Sanity limit
+
+// Snapshot compression: fast rather than small, most of it is silence
+// or noise anyway.
+const int DELAY_SNAPSHOT_COMPRESSION = 1;
+const int DELAY_SNAPSHOT_CHUNK = 1024; // samples
+
+enum DelaySnapshotState {
+  SNAPSHOT_NONE = 0,
+  SNAPSHOT_PENDING,
+  SNAPSHOT_APPLYING,
+  SNAPSHOT_APPLIED // holds the old delay buffer until the message thread frees it
+};
+
+BiasedDelay::BiasedDelay() :
+  sampleRate(0), delayBuffer(new AudioSampleBuffer(1, 0)), delayBufferIdx(0),
+  maxChannels(MAX_CHANNELS), numChannels(0),
+  parallelProcessing(false), currentBlock(nullptr), nextDelayBufferIdx(0),
+  lastSwitch(nullptr), morphSwitch(0), morphPosition(0), morphLength(0),
+  storeDelayBuffer(false) {
   parameterNames.add("Time");
   parameterNames.add("Feedback");
   parameterNames.add("Bias");
@@ -41,32 +74,97 @@ BiasedDelay::BiasedDelay() : delayBuffer(MAX_CHANNELS, INITIAL_BUFFER_SIZE) {
  * Processing.
  */
 
-void BiasedDelay::prepareToPlay(double sampleRate, int samplesPerBlock){
-  if (this->sampleRate!=sampleRate)
+void BiasedDelay::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels){
+  numChannels = jlimit(1, maxChannels, numChannels);
+  if (this->sampleRate!=sampleRate || this->numChannels!=numChannels)
   {
     this->sampleRate = sampleRate;
-    delayBuffer.setSize(MAX_CHANNELS, MAX_DELAY * sampleRate, true, false, true);
+    this->numChannels = numChannels;
+    delayBuffer->setSize(numChannels, MAX_DELAY * sampleRate, false, false, false);
   }
   delayBufferIdx = 0;
-  delayBuffer.clear();
+  // Either way every page of the buffer we keep has been written here,
+  // so the audio thread never faults on a fresh one.
+  if (!applyDelaySnapshot())
+    delayBuffer->clear();
+  releaseDelaySnapshot();
+
+  // Land on any pending switch or morph target right away
+  if (morphLength > 0)
+  {
+    pinAutomatedParameters();
+    for (int i=0; i<NUM_PARAMETERS; i++)
+      setParameterValue(i, morphTo[i]);
+    morphLength = 0;
+    landedSwitch.set(morphSwitch);
+  }
+  takeParameterSwitch(true);
+
+  // The audio thread takes a share of the channels itself.
+  if (parallelProcessing && numChannels >= MIN_PARALLEL_CHANNELS)
+    workerPool.setNumWorkers(jmin(numChannels, SystemStats::getNumCpus()) - 1);
+  else
+    workerPool.setNumWorkers(0);
 }
 
 void BiasedDelay::processBlock(AudioSampleBuffer& buffer, int numInputChannels,
                                int numOutputChannels, MidiBuffer& midiMessages){
+  RealtimeCheck::ScopedRealtimeThread realtimeThread;
+
   // Atm we're assuming matching input/output channel counts
   jassert(numInputChannels==numOutputChannels);
-  
-  for (int channel=0; channel<numInputChannels; channel++)
+
+  // Not prepared for this layout: pass through rather than reallocate
+  // on the audio thread.
+  if (numInputChannels > numChannels || numInputChannels > buffer.getNumChannels())
+  {
+    ++numSkippedBlocks;
+    return;
+  }
+
+  if (delaySnapshotState.get() == SNAPSHOT_PENDING)
+    applyDelaySnapshot();
+
+  takeParameterSwitch(false);
+  if (morphLength > 0)
+    pinAutomatedParameters();
+
+  // Channels are independent, and delayBufferIdx only advances
+  // once they're all done.
+  currentBlock = &buffer;
+  nextDelayBufferIdx = delayBufferIdx;
+  workerPool.run(*this, numInputChannels);
+  currentBlock = nullptr;
+  delayBufferIdx = nextDelayBufferIdx;
+
+  if (morphLength > 0)
   {
-    processChannelBlock(buffer.getNumSamples(),
-                        buffer.getSampleData(channel),
-                        delayBuffer.getSampleData(channel),
-                        delayBufferIdx);
+    morphPosition += buffer.getNumSamples();
+    if (morphPosition >= morphLength)
+    {
+      morphLength = 0;
+      landedSwitch.set(morphSwitch);
+    }
+    pinAutomatedParameters(); // Again, for automation during the block
+    for (int i=0; i<NUM_PARAMETERS; i++)
+      setParameterValue(i, morphLength > 0 ? getMorphValue(i, morphPosition) : morphTo[i]);
   }
-  delayBufferIdx = (delayBufferIdx + buffer.getNumSamples()) % getSampleDelay(getParameterValue(PARAMETER_TIME));
 }
 
-void BiasedDelay::processChannelBlock(int size, float* buf, float* delayBuf, int delayBufIdx){
+// Every channel walks the same index sequence; channel 0 reports where
+// it ends up.
+void BiasedDelay::processJob(int channel){
+  const int size = currentBlock->getNumSamples();
+  float* buf = currentBlock->getSampleData(channel);
+  float* delayBuf = delayBuffer->getSampleData(channel);
+  int idx = morphLength > 0 ?
+    processChannelBlockMorphing(size, buf, delayBuf, delayBufferIdx) :
+    processChannelBlock(size, buf, delayBuf, delayBufferIdx);
+  if (channel == 0)
+    nextDelayBufferIdx = idx;
+}
+
+int BiasedDelay::processChannelBlock(int size, float* buf, float* delayBuf, int delayBufIdx){
   unsigned int sampleDelay = getSampleDelay(getParameterValue(PARAMETER_TIME));
   float feedback = getParameterValue(PARAMETER_FEEDBACK);
   float bias = getBiasExponent(1 - getParameterValue(PARAMETER_BIAS));
@@ -80,12 +178,38 @@ void BiasedDelay::processChannelBlock(int size, float* buf, float* delayBuf, int
     delayBuf[delayBufIdx] = softLimit(v); // Guard: range limit.
     buf[i] = sigmoidXFade(buf[i], delaySample, dryWetMix);
     
-    delayBufIdx = (++delayBufIdx) % sampleDelay;
+    delayBufIdx = (delayBufIdx + 1) % sampleDelay;
+  }
+  return delayBufIdx;
+}
+
+// As processChannelBlock, with parameters interpolated for every sample.
+int BiasedDelay::processChannelBlockMorphing(int size, float* buf, float* delayBuf, int delayBufIdx){
+  for (int i=0; i<size; i++)
+  {
+    const int position = morphPosition + i;
+    unsigned int sampleDelay = getSampleDelay(getMorphValue(PARAMETER_TIME, position));
+    float feedback = getMorphValue(PARAMETER_FEEDBACK, position);
+    float bias = getBiasExponent(1 - getMorphValue(PARAMETER_BIAS, position));
+    float dryWetMix = getMorphValue(PARAMETER_DRYWET, position);
+
+    float delaySample = delayBuf[delayBufIdx];
+    float v = buf[i] + delaySample * feedback;
+    v = applyBias(v, bias);
+    delayBuf[delayBufIdx] = softLimit(v); // Guard: range limit.
+    buf[i] = sigmoidXFade(buf[i], delaySample, dryWetMix);
+
+    delayBufIdx = (delayBufIdx + 1) % sampleDelay;
   }
+  return delayBufIdx;
 }
 
 void BiasedDelay::reset(){
-  delayBuffer.clear();
+  delayBuffer->clear();
+}
+
+void BiasedDelay::setMaxChannels(int maxChannels){
+  this->maxChannels = jlimit(1, (int)MAX_CHANNELS, maxChannels);
 }
 
 unsigned int BiasedDelay::getSampleDelay(float p1){
@@ -184,15 +308,352 @@ void BiasedDelay::setParameterValue(int index, float value){
     parameterValues[index] = value;
 }
 
+void BiasedDelay::setAutomatedParameterValue(int index, float value){
+  if (index >= NUM_PARAMETERS || !juce_isfinite(value))
+    return;
+  value = jlimit(0.0f, 1.0f, value);
+  automatedValues[index] = value;
+  setParameterValue(index, value);
+  automatedSwitch[index].set(numSwitches.get()); // Full barrier: the value is written
+}
+
+float BiasedDelay::getDelayTime(){
+  return MIN_DELAY + getParameterValue(PARAMETER_TIME) * (MAX_DELAY-MIN_DELAY);
+}
+
+float BiasedDelay::getTargetParameterValue(int index){
+  const int switchId = numSwitches.get();
+  if (landedSwitch.get() != switchId && index < NUM_PARAMETERS && !isAutomatedSince(index, switchId))
+    return targetParameters.values[index];
+  return getParameterValue(index);
+}
+
+void BiasedDelay::setParameterSet(const ParameterSet& parameters, double morphSeconds){
+  ParameterSwitch* const taking = takingSwitch.get();
+  ParameterSwitch* parameterSwitch = parameterSwitches;
+  while (parameterSwitch == lastSwitch || parameterSwitch == taking)
+    parameterSwitch++;
+
+  // Same validation as restored state; a bad value keeps its target.
+  for (int i=0; i<NUM_PARAMETERS; i++)
+    if (juce_isfinite(parameters.values[i]))
+      targetParameters.values[i] = jlimit(0.0f, 1.0f, parameters.values[i]);
+    else
+      targetParameters.values[i] = getTargetParameterValue(i);
+  parameterSwitch->parameters = targetParameters;
+  parameterSwitch->morphSeconds = morphSeconds;
+  parameterSwitch->id = ++numSwitches;
+  lastSwitch = parameterSwitch;
+  pendingSwitch.set(parameterSwitch); // Full barrier: the slot is written
+}
+
+// Audio thread, or prepareToPlay (instant: no morph). takingSwitch is
+// set before the pending switch is claimed, so the writer can't pick
+// its slot; if a newer one was published meanwhile, the claim fails and
+// the newer one is taken next time.
+void BiasedDelay::takeParameterSwitch(bool instant){
+  ParameterSwitch* parameterSwitch = pendingSwitch.get();
+  if (parameterSwitch == nullptr)
+    return;
+  takingSwitch.set(parameterSwitch);
+  if (pendingSwitch.compareAndSetBool(nullptr, parameterSwitch))
+    startParameterSet(parameterSwitch->parameters, instant ? 0 : parameterSwitch->morphSeconds, parameterSwitch->id);
+  takingSwitch.set(nullptr);
+}
+
+// A new morph starts from wherever the current one is.
+void BiasedDelay::startParameterSet(const ParameterSet& parameters, double morphSeconds, int id){
+  const int length = (int)(morphSeconds * sampleRate);
+  for (int i=0; i<NUM_PARAMETERS; i++)
+  {
+    morphFrom[i] = getParameterValue(i);
+    morphTo[i] = parameters.values[i];
+  }
+  morphPosition = 0;
+  morphLength = jmax(0, length);
+  morphSwitch = id;
+  pinAutomatedParameters();
+  if (morphLength == 0)
+  {
+    for (int i=0; i<NUM_PARAMETERS; i++)
+      setParameterValue(i, morphTo[i]);
+    landedSwitch.set(id);
+  }
+}
+
+// Parameters the host automated after the switch being morphed to was
+// published stay where the host put them, for the rest of the morph.
+void BiasedDelay::pinAutomatedParameters(){
+  for (int i=0; i<NUM_PARAMETERS; i++)
+    if (isAutomatedSince(i, morphSwitch))
+      morphFrom[i] = morphTo[i] = automatedValues[i];
+}
+
+// Linear interpolation, position in samples since the morph started
+float BiasedDelay::getMorphValue(int index, int position){
+  const float mix = jmin(1.0f, position / (float)morphLength);
+  return morphFrom[index] + (morphTo[index] - morphFrom[index]) * mix;
+}
+
 
 /**
  * State
  */
 
+static char* writeUInt32(char* dest, uint32 value){
+  value = ByteOrder::swapIfBigEndian(value);
+  memcpy(dest, &value, sizeof(value));
+  return dest + sizeof(value);
+}
+
+static char* writeUInt16(char* dest, uint16 value){
+  value = ByteOrder::swapIfBigEndian(value);
+  memcpy(dest, &value, sizeof(value));
+  return dest + sizeof(value);
+}
+
+static uint32 readUInt32(const char* src){
+  uint32 value;
+  memcpy(&value, src, sizeof(value));
+  return ByteOrder::swapIfBigEndian(value);
+}
+
+static uint16 readUInt16(const char* src){
+  uint16 value;
+  memcpy(&value, src, sizeof(value));
+  return ByteOrder::swapIfBigEndian(value);
+}
+
+void BiasedDelay::getStateInformation(MemoryBlock& destData){
+  // Hosts ask for state regularly, which makes this a good place to
+  // free the buffer a restore swapped out.
+  freeAppliedDelaySnapshot();
+
+  const int numParameters = getNumParameters();
+  const int parametersSize = sizeof(uint32) + numParameters * sizeof(float);
+  destData.setSize(STATE_HEADER_SIZE + STATE_SECTION_HEADER_SIZE + parametersSize, false);
+
+  char* p = static_cast<char*>(destData.getData());
+  p = writeUInt32(p, STATE_MAGIC);
+  p = writeUInt16(p, STATE_VERSION);
+  p = writeUInt16(p, STATE_HEADER_SIZE);
+
+  p = writeUInt32(p, STATE_SECTION_PARAMETERS);
+  p = writeUInt32(p, parametersSize);
+  p = writeUInt32(p, numParameters);
+  for (int i=0; i<numParameters; i++)
+  {
+    float value = getTargetParameterValue(i);
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    p = writeUInt32(p, bits);
+  }
+
+  if (storeDelayBuffer && numChannels > 0)
+    writeDelaySnapshot(destData);
+}
+
+bool BiasedDelay::setStateInformation(const void* data, int sizeInBytes){
+  const char* p = static_cast<const char*>(data);
+  if (p == nullptr || sizeInBytes < STATE_HEADER_SIZE || readUInt32(p) != STATE_MAGIC)
+    return false;
+  const int headerSize = readUInt16(p + 6);
+  if (headerSize < STATE_HEADER_SIZE || headerSize > sizeInBytes)
+    return false;
+
+  const char* end = p + sizeInBytes;
+  p += headerSize;
+  while (end - p >= STATE_SECTION_HEADER_SIZE)
+  {
+    const uint32 id = readUInt32(p);
+    const uint32 size = readUInt32(p + 4);
+    p += STATE_SECTION_HEADER_SIZE;
+    if (size > (uint32)(end - p))
+      return false; // Truncated
+
+    if (id == STATE_SECTION_PARAMETERS && size >= sizeof(uint32))
+    {
+      const int count = jmin((int)readUInt32(p), (int)((size - sizeof(uint32)) / sizeof(float)));
+      for (int i=0; i<count && i<getNumParameters(); i++)
+      {
+        uint32 bits = readUInt32(p + sizeof(uint32) + i * sizeof(float));
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        // Parameters are normalised; anything else (e.g. a delay time
+        // beyond the delay buffer) would be unsafe to process with.
+        if (juce_isfinite(value))
+          setParameterValue(i, jlimit(0.0f, 1.0f, value));
+      }
+    }
+    else if (id == STATE_SECTION_DELAY_BUFFER)
+      readDelaySnapshot(p, size);
+    p += size;
+  }
+  return true;
+}
+
+void BiasedDelay::appendStateSection(MemoryBlock& destData, uint32 id, const void* payload, int size){
+  char header[STATE_SECTION_HEADER_SIZE];
+  writeUInt32(writeUInt32(header, id), size);
+  destData.append(header, sizeof(header));
+  destData.append(payload, size);
+}
+
+bool BiasedDelay::findStateSection(const void* data, int sizeInBytes, uint32 id, MemoryBlock& payload){
+  const char* p = static_cast<const char*>(data);
+  if (p == nullptr || sizeInBytes < STATE_HEADER_SIZE || readUInt32(p) != STATE_MAGIC)
+    return false;
+  const int headerSize = readUInt16(p + 6);
+  if (headerSize < STATE_HEADER_SIZE || headerSize > sizeInBytes)
+    return false;
+
+  const char* end = p + sizeInBytes;
+  p += headerSize;
+  while (end - p >= STATE_SECTION_HEADER_SIZE)
+  {
+    const uint32 sectionId = readUInt32(p);
+    const uint32 size = readUInt32(p + 4);
+    p += STATE_SECTION_HEADER_SIZE;
+    if (size > (uint32)(end - p))
+      return false;
+    if (sectionId == id)
+    {
+      payload.replaceWith(p, size);
+      return true;
+    }
+    p += size;
+  }
+  return false;
+}
+
+/**
+ * Delay buffer snapshots.
+ */
+
+BiasedDelay::DelaySnapshot::DelaySnapshot(int numChannels, int numSamples) :
+  buffer(new AudioSampleBuffer(numChannels, numSamples)), delayBufferIdx(0) {
+}
+
+// Appends a snapshot section. Taken while the audio thread is running,
+// it may straddle a block boundary; offline it's exact.
+void BiasedDelay::writeDelaySnapshot(MemoryBlock& destData){
+  // Only the message thread frees a swapped-out buffer, so whichever one
+  // we pick up here stays valid.
+  const AudioSampleBuffer& buffer = *delayBuffer;
+  MemoryOutputStream compressed;
+  {
+    GZIPCompressorOutputStream gzip(&compressed, DELAY_SNAPSHOT_COMPRESSION);
+    uint32 chunk[DELAY_SNAPSHOT_CHUNK];
+    for (int channel=0; channel<numChannels; channel++)
+    {
+      const float* samples = buffer.getSampleData(channel);
+      for (int i=0; i<buffer.getNumSamples(); i+=DELAY_SNAPSHOT_CHUNK)
+      {
+        const int n = jmin(DELAY_SNAPSHOT_CHUNK, buffer.getNumSamples() - i);
+        memcpy(chunk, samples + i, n * sizeof(float));
+        for (int j=0; j<n; j++)
+          chunk[j] = ByteOrder::swapIfBigEndian(chunk[j]);
+        gzip.write(chunk, n * sizeof(float));
+      }
+    }
+  }
+
+  char header[STATE_SECTION_HEADER_SIZE + DELAY_SNAPSHOT_HEADER_SIZE];
+  char* p = header;
+  p = writeUInt32(p, STATE_SECTION_DELAY_BUFFER);
+  p = writeUInt32(p, DELAY_SNAPSHOT_HEADER_SIZE + compressed.getDataSize());
+  p = writeUInt32(p, numChannels);
+  p = writeUInt32(p, buffer.getNumSamples());
+  p = writeUInt32(p, delayBufferIdx);
+  destData.append(header, sizeof(header));
+  destData.append(compressed.getData(), compressed.getDataSize());
+}
+
+// Message thread: decompresses into a new snapshot and publishes it.
+bool BiasedDelay::readDelaySnapshot(const char* data, int size){
+  if (size < DELAY_SNAPSHOT_HEADER_SIZE)
+    return false;
+  const int channels = (int)readUInt32(data);
+  const int samples = (int)readUInt32(data + 4);
+  if (channels < 1 || channels > (int)MAX_CHANNELS || samples < 1 || samples > MAX_SNAPSHOT_SAMPLES)
+    return false;
+
+  ScopedPointer<DelaySnapshot> snapshot(new DelaySnapshot(channels, samples));
+  snapshot->delayBufferIdx = readUInt32(data + 8);
+  if (snapshot->delayBufferIdx >= (unsigned int)samples)
+    return false;
+
+  MemoryInputStream compressed(data + DELAY_SNAPSHOT_HEADER_SIZE, size - DELAY_SNAPSHOT_HEADER_SIZE, false);
+  GZIPDecompressorInputStream gzip(compressed);
+  uint32 chunk[DELAY_SNAPSHOT_CHUNK];
+  for (int channel=0; channel<channels; channel++)
+  {
+    float* dest = snapshot->buffer->getSampleData(channel);
+    for (int i=0; i<samples; i+=DELAY_SNAPSHOT_CHUNK)
+    {
+      const int n = jmin(DELAY_SNAPSHOT_CHUNK, samples - i);
+      if (gzip.read(chunk, n * sizeof(float)) != (int)(n * sizeof(float)))
+        return false;
+      for (int j=0; j<n; j++)
+        chunk[j] = ByteOrder::swapIfBigEndian(chunk[j]);
+      memcpy(dest + i, chunk, n * sizeof(float));
+    }
+  }
+
+  releaseDelaySnapshot();
+  delaySnapshot = snapshot;
+  delaySnapshotState.set(SNAPSHOT_PENDING);
+  return true;
+}
+
+// Audio thread (or prepareToPlay). Swaps in a pending snapshot if it was
+// taken with the current layout and sample rate, and ignores it otherwise.
+// Either way the snapshot is left for the message thread to free, along
+// with the old delay buffer it now holds.
+bool BiasedDelay::applyDelaySnapshot(){
+  if (!delaySnapshotState.compareAndSetBool(SNAPSHOT_APPLYING, SNAPSHOT_PENDING))
+    return false;
+
+  const AudioSampleBuffer& snapshot = *delaySnapshot->buffer;
+  const bool matches = snapshot.getNumChannels() == delayBuffer->getNumChannels() &&
+    snapshot.getNumSamples() == delayBuffer->getNumSamples();
+  if (matches)
+  {
+    delayBuffer.swapWith(delaySnapshot->buffer);
+    delayBufferIdx = delaySnapshot->delayBufferIdx;
+  }
+  delaySnapshotState.set(SNAPSHOT_APPLIED);
+  return matches;
+}
+
+// Message thread. Takes back a pending snapshot or frees an applied one.
+// The audio thread only holds SNAPSHOT_APPLYING for a pointer swap, so
+// the wait is short, and it never waits for us.
+void BiasedDelay::releaseDelaySnapshot(){
+  for (;;)
+  {
+    const int state = delaySnapshotState.get();
+    if (state == SNAPSHOT_NONE)
+      break;
+    if (state != SNAPSHOT_APPLYING && delaySnapshotState.compareAndSetBool(SNAPSHOT_NONE, state))
+      break;
+    Thread::yield();
+  }
+  delaySnapshot = nullptr;
+}
+
+// Message thread. Frees a snapshot the audio thread is done with, and
+// leaves a pending one alone.
+void BiasedDelay::freeAppliedDelaySnapshot(){
+  if (delaySnapshotState.compareAndSetBool(SNAPSHOT_NONE, SNAPSHOT_APPLIED))
+    delaySnapshot = nullptr;
+}
+
 XmlElement BiasedDelay::getStateInformation(){
+  freeAppliedDelaySnapshot();
   XmlElement state("BiasedDelayState");
   for (int i=0; i<getNumParameters(); i++)
-    state.setAttribute(String::formatted("parameter%d", i), getParameterValue(i));
+    state.setAttribute(String::formatted("parameter%d", i), getTargetParameterValue(i));
   //    state.setAttribute(getParameterName(i), getParameterValue(i));
   return state;
 }
@@ -201,7 +662,11 @@ void BiasedDelay::setStateInformation(ScopedPointer<XmlElement> state){
   if (state->hasTagName("BiasedDelayState"))
   {
     for (int i=0; i<getNumParameters(); i++)
-      setParameterValue(i, (float)state->getDoubleAttribute(String::formatted("parameter%d", i), getParameterValue(i)));
-    //      setParameterValue(i, (float)state->getDoubleAttribute(getParameterName(i), getParameterValue(i)));
+    {
+      float value = (float)state->getDoubleAttribute(String::formatted("parameter%d", i), getParameterValue(i));
+      if (juce_isfinite(value))
+        setParameterValue(i, jlimit(0.0f, 1.0f, value));
+      //      setParameterValue(i, (float)state->getDoubleAttribute(getParameterName(i), getParameterValue(i)));
+    }
   }
 }
@@ -26,13 +26,21 @@
 #ifndef BiasedDelay_BiasedDelay_h
 #define BiasedDelay_BiasedDelay_h
 
-#include "../JuceLibraryCode/JuceHeader.h"
+#include "JuceHeader.h"
+#include "ChannelWorkerPool.h"
+#include "RealtimeCheck.h"
 
 enum ParameterId {
   PARAMETER_TIME = 0,
   PARAMETER_FEEDBACK,
   PARAMETER_BIAS,
-  PARAMETER_DRYWET
+  PARAMETER_DRYWET,
+  NUM_PARAMETERS
+};
+
+// A complete set of parameter values, e.g. a preset program
+struct ParameterSet {
+  float values[NUM_PARAMETERS];
 };
 
 const float MIN_DELAY = 0.01; // in seconds
@@ -42,31 +50,114 @@ const float MIN_BIAS = 0.5;
 const float MED_BIAS = 1;
 const float MAX_BIAS = 3;
 
-const unsigned int MAX_CHANNELS = 4;
-const unsigned int INITIAL_BUFFER_SIZE = MAX_DELAY * 44100;
+// Hard ceiling; see setMaxChannels for the configured maximum
+const unsigned int MAX_CHANNELS = 64;
+
+// Smallest bus width that's worth fanning out across worker threads
+const int MIN_PARALLEL_CHANNELS = 8;
 
-class BiasedDelay {
+class BiasedDelay : private ChannelWorkerPool::Job {
 public:
   BiasedDelay();
   
   // Processing
-  void prepareToPlay(double sampleRate, int samplesPerBlock);
+  void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels);
   void processBlock(AudioSampleBuffer& buffer, int numInputChannels,
                     int numOutputChannels, MidiBuffer& midiMessages);
   void reset();
 
+  // Channel layout. Delay memory is allocated in prepareToPlay, for the
+  // prepared channels only. Blocks with more channels than that are
+  // passed through unprocessed, and counted.
+  void setMaxChannels(int maxChannels);
+  int getMaxChannels(){return maxChannels;};
+  int getNumChannels(){return numChannels;};
+  int getNumSkippedBlocks(){return numSkippedBlocks.get();};
+
+  // Process wide buses on worker threads (takes effect in prepareToPlay;
+  // falls back to serial if the workers can't get realtime scheduling)
+  void setParallelProcessing(bool enabled){parallelProcessing = enabled;};
+  bool getParallelProcessing(){return parallelProcessing;};
+  int getNumWorkers(){return workerPool.getNumWorkers();};
+
   // Parameters
   const float getNumParameters(){return parameterNames.size();};
   const String getParameterName(int index);
   float getParameterValue(int index);
   void setParameterValue(int index, float value);
+  float getDelayTime(); // in seconds
+
+  // Host automation: as setParameterValue, but it also wins over any
+  // switch published before it. A pending switch or a morph in progress
+  // leaves the parameter where the host put it; the next switch moves it
+  // again. Values are clamped to [0..1]; non-finite ones are ignored.
+  void setAutomatedParameterValue(int index, float value);
+
+  // Switches to a complete parameter set at the start of the next block,
+  // or morphs there over morphSeconds, sample by sample. The set is
+  // copied, and published to the audio thread with an atomic pointer
+  // swap; call from one thread at a time (normally the message thread).
+  // prepareToPlay lands a pending switch at once. Values are clamped to
+  // [0..1]; non-finite ones keep their current target.
+  void setParameterSet(const ParameterSet& parameters, double morphSeconds);
+  bool isMorphing(){return morphLength > 0;};
+
+  // Where the parameters are heading: the last switched-to set until it
+  // has landed (including any morph), the current values otherwise. This
+  // is what hosts see, and what the state saves.
+  float getTargetParameterValue(int index);
+
+  // State. The binary form is compact and doesn't allocate beyond
+  // destData; setStateInformation(data, size) returns false for anything
+  // that isn't binary state (e.g. legacy XML state).
+  void getStateInformation(MemoryBlock& destData);
+  bool setStateInformation(const void* data, int sizeInBytes);
 
-  // State
+  // Include the delay buffer in the binary state (compressed), so a
+  // reloaded session or a chunked render continues with its delay tail.
+  // Restoring never blocks the audio thread: the snapshot is applied in
+  // prepareToPlay, or else at the start of the next block.
+  void setStoreDelayBuffer(bool enabled){storeDelayBuffer = enabled;};
+  bool getStoreDelayBuffer(){return storeDelayBuffer;};
+
+  // XML state, for presets and state saved by earlier versions
   XmlElement getStateInformation();
   void setStateInformation(ScopedPointer<XmlElement> state);
 
+  // Extra tagged sections in the binary state, e.g. for the plugin
+  // wrapper's own settings; setStateInformation skips them.
+  static void appendStateSection(MemoryBlock& destData, uint32 id, const void* payload, int size);
+  static bool findStateSection(const void* data, int sizeInBytes, uint32 id, MemoryBlock& payload);
+
 private:
-  void processChannelBlock(int size, float* buf, float* delayBuf, int delayBufIdx);
+  friend class BiasedDelayBenchmark;
+
+  void processJob(int channel);
+  int processChannelBlock(int size, float* buf, float* delayBuf, int delayBufIdx);
+  int processChannelBlockMorphing(int size, float* buf, float* delayBuf, int delayBufIdx);
+  // A published parameter set switch
+  struct ParameterSwitch {
+    ParameterSet parameters;
+    double morphSeconds;
+    int id;
+  };
+  void takeParameterSwitch(bool instant);
+  void startParameterSet(const ParameterSet& parameters, double morphSeconds, int id);
+  bool isAutomatedSince(int index, int switchId){return automatedSwitch[index].get() >= switchId;};
+  void pinAutomatedParameters();
+  float getMorphValue(int index, int position);
+
+  // Delay buffer snapshots
+  struct DelaySnapshot {
+    DelaySnapshot(int numChannels, int numSamples);
+    ScopedPointer<AudioSampleBuffer> buffer;
+    unsigned int delayBufferIdx;
+  };
+  void writeDelaySnapshot(MemoryBlock& destData);
+  bool readDelaySnapshot(const char* data, int size);
+  bool applyDelaySnapshot();
+  void releaseDelaySnapshot();
+  void freeAppliedDelaySnapshot();
   unsigned int getSampleDelay(float p1);
 
   float getBiasExponent(float p1);
@@ -88,9 +179,47 @@ private:
   float parameterValues[16] = { };
   
   float sampleRate;
-  AudioSampleBuffer delayBuffer;
+  ScopedPointer<AudioSampleBuffer> delayBuffer;
   unsigned int delayBufferIdx;
 
+  int maxChannels;
+  int numChannels;
+  Atomic<int> numSkippedBlocks;
+
+  bool parallelProcessing;
+  ChannelWorkerPool workerPool;
+  AudioSampleBuffer* currentBlock;
+  unsigned int nextDelayBufferIdx;
+
+  // Parameter set switches: setParameterSet fills a slot that's neither
+  // the last one it published nor the one the audio thread is taking,
+  // so three slots are enough and neither side ever waits. The morph
+  // state is only touched by the audio thread.
+  ParameterSwitch parameterSwitches[3];
+  ParameterSwitch* lastSwitch;
+  Atomic<ParameterSwitch*> pendingSwitch;
+  Atomic<ParameterSwitch*> takingSwitch;
+  ParameterSet targetParameters;
+  Atomic<int> numSwitches;
+  Atomic<int> landedSwitch; // id of the last switch that fully landed
+  int morphSwitch; // id of the switch being morphed to
+  float morphFrom[NUM_PARAMETERS];
+  float morphTo[NUM_PARAMETERS];
+  int morphPosition;
+  int morphLength; // in samples; 0: not morphing
+
+  // Host automation, per parameter: the value, and numSwitches when it
+  // was set. Switches with a higher id override it, older ones don't.
+  float automatedValues[NUM_PARAMETERS];
+  Atomic<int> automatedSwitch[NUM_PARAMETERS];
+
+  // A restored snapshot is owned by the message thread; the audio
+  // thread swaps its buffer with delayBuffer while it holds
+  // SNAPSHOT_APPLYING, and the message thread frees the old one later.
+  bool storeDelayBuffer;
+  ScopedPointer<DelaySnapshot> delaySnapshot;
+  Atomic<int> delaySnapshotState;
+
 };
 
 #endif
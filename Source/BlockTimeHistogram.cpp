@@ -0,0 +1,114 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+*/
+
+/**
+ * BlockTimeHistogram.cpp
+ * BiasedDelay
+ */
+
+#include "BlockTimeHistogram.h"
+
+const int SUB_BIN_BITS = 3; // log2(BLOCK_TIME_SUB_BINS)
+
+BlockTimeHistogram::BlockTimeHistogram() :
+  budgetSeconds(0), budgetTicks(0) {
+}
+
+void BlockTimeHistogram::setBudget(double seconds){
+  budgetSeconds = seconds;
+  budgetTicks = (int64)(budgetSeconds * Time::getHighResolutionTicksPerSecond());
+}
+
+// Single writer: counts only ever grow here, so plain get/set is enough
+// for the max, and readers at worst see a block that's half-recorded.
+void BlockTimeHistogram::addBlock(int64 startTicks, int64 endTicks){
+  if (resetPending.get() != 0)
+  {
+    for (int i=0; i<BLOCK_TIME_NUM_BINS; i++)
+      bins[i].set(0);
+    numBlocks.set(0);
+    numOverruns.set(0);
+    maxTicks.set(0);
+    resetPending.set(0);
+  }
+
+  const int64 ticks = jmax((int64)0, endTicks - startTicks);
+  ++bins[getBin(ticks)];
+  ++numBlocks;
+  if (budgetTicks > 0 && ticks > budgetTicks)
+    ++numOverruns;
+  if (ticks > maxTicks.get())
+    maxTicks.set(ticks);
+}
+
+double BlockTimeHistogram::getPercentile(double percentile){
+  const int total = numBlocks.get();
+  if (total == 0)
+    return 0;
+
+  const int64 rank = (int64)std::ceil(total * jlimit(0.0, 100.0, percentile) / 100);
+  int64 count = 0;
+  for (int i=0; i<BLOCK_TIME_NUM_BINS; i++)
+  {
+    count += bins[i].get();
+    if (count >= rank && count > 0)
+      return Time::highResolutionTicksToSeconds(jmin(getBinUpperBound(i), maxTicks.get()));
+  }
+  return getMax();
+}
+
+double BlockTimeHistogram::getMax(){
+  return Time::highResolutionTicksToSeconds(maxTicks.get());
+}
+
+double BlockTimeHistogram::toCycles(double seconds){
+  return seconds * SystemStats::getCpuSpeedInMegaherz() * 1e6;
+}
+
+String BlockTimeHistogram::toString(){
+  const double p50 = getPercentile(50), p99 = getPercentile(99), max = getMax();
+  return String(getNumBlocks()) + " blocks"
+    + ", p50 " + String(p50 * 1e6, 1) + "us (" + String((int64)toCycles(p50)) + " cycles)"
+    + ", p99 " + String(p99 * 1e6, 1) + "us (" + String((int64)toCycles(p99)) + " cycles)"
+    + ", max " + String(max * 1e6, 1) + "us (" + String((int64)toCycles(max)) + " cycles)"
+    + ", " + String(getNumOverruns()) + " over budget";
+}
+
+/**
+ * Bins.
+ */
+
+// Values below BLOCK_TIME_SUB_BINS get a bin each; above that, each
+// octave is split into BLOCK_TIME_SUB_BINS linear steps.
+int BlockTimeHistogram::getBin(int64 ticks){
+  if (ticks < BLOCK_TIME_SUB_BINS)
+    return (int)ticks;
+
+  int octave = 0; // highest set bit
+  for (int64 v = ticks; v > 1; v >>= 1)
+    octave++;
+  const int sub = (int)(ticks >> (octave - SUB_BIN_BITS)) & (BLOCK_TIME_SUB_BINS - 1);
+  return jmin(BLOCK_TIME_NUM_BINS - 1, (octave - SUB_BIN_BITS + 1) * BLOCK_TIME_SUB_BINS + sub);
+}
+
+int64 BlockTimeHistogram::getBinUpperBound(int bin){
+  if (bin < BLOCK_TIME_SUB_BINS)
+    return bin;
+  const int shift = bin / BLOCK_TIME_SUB_BINS - 1;
+  const int64 lower = (int64)(BLOCK_TIME_SUB_BINS + bin % BLOCK_TIME_SUB_BINS) << shift;
+  return lower + ((int64)1 << shift) - 1;
+}
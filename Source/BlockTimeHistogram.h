@@ -0,0 +1,77 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+ */
+
+/**
+ * BlockTimeHistogram.h
+ * BiasedDelay
+ *
+ * Per-block processing times, for worst-case rather than average
+ * figures. The audio thread records; any thread can read.
+ */
+
+#ifndef BiasedDelay_BlockTimeHistogram_h
+#define BiasedDelay_BlockTimeHistogram_h
+
+#include "JuceHeader.h"
+
+// Log-scaled bins: 8 per octave (~12% resolution), up to 2^42 ticks
+const int BLOCK_TIME_SUB_BINS = 8;
+const int BLOCK_TIME_NUM_BINS = 40 * BLOCK_TIME_SUB_BINS;
+
+class BlockTimeHistogram {
+public:
+  BlockTimeHistogram();
+
+  // Deadline for a single block in seconds, e.g. its duration. Not
+  // realtime-safe; call from prepareToPlay.
+  void setBudget(double seconds);
+  double getBudget(){return budgetSeconds;};
+
+  // Realtime-safe; audio thread only.
+  void addBlock(int64 startTicks, int64 endTicks);
+
+  // Clears the counts. Takes effect on the next addBlock.
+  void reset(){resetPending.set(1);};
+
+  // Readers. Percentiles are bin upper bounds, i.e. slightly pessimistic.
+  int getNumBlocks(){return numBlocks.get();};
+  int getNumOverruns(){return numOverruns.get();};
+  double getPercentile(double percentile); // in seconds
+  double getMax(); // in seconds
+
+  // Estimated from the nominal CPU clock
+  static double toCycles(double seconds);
+
+  // One-line summary: p50/p99/max, overruns
+  String toString();
+
+private:
+  static int getBin(int64 ticks);
+  static int64 getBinUpperBound(int bin);
+
+private:
+  Atomic<int> bins[BLOCK_TIME_NUM_BINS];
+  Atomic<int> numBlocks;
+  Atomic<int> numOverruns;
+  Atomic<int64> maxTicks;
+  Atomic<int> resetPending;
+
+  double budgetSeconds;
+  int64 budgetTicks;
+};
+
+#endif
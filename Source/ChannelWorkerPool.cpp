@@ -0,0 +1,180 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+*/
+
+/**
+ * ChannelWorkerPool.cpp
+ * BiasedDelay
+ */
+
+#include "ChannelWorkerPool.h"
+#include "RealtimeCheck.h"
+
+// Claim counter value while no batch is active; anything at or
+// above the batch size means "nothing left to do".
+const int NO_JOBS = 0x3fffffff;
+
+// Workers' realtime priority (1..99). The audio thread waits for them,
+// so they need to be up with it, above ordinary threads.
+const int WORKER_REALTIME_PRIORITY = 70;
+
+ChannelWorkerPool::ChannelWorkerPool() : currentJob(nullptr), batchSize(0) {
+  nextJob.set(NO_JOBS);
+}
+
+ChannelWorkerPool::~ChannelWorkerPool(){
+  stopWorkers();
+}
+
+void ChannelWorkerPool::setNumWorkers(int numWorkers){
+  numWorkers = jmax(0, numWorkers);
+  if (numWorkers == workers.size())
+    return;
+
+  stopWorkers();
+
+  bool allRealtime = true;
+  for (int i=0; i<numWorkers; i++)
+  {
+    Worker* worker = new Worker(*this);
+    workers.add(worker);
+    worker->startThread();
+    worker->started.wait();
+    allRealtime = allRealtime && worker->isRealtime;
+  }
+
+  // A preempted worker would stall the audio thread until it's
+  // scheduled again, so without realtime workers we go serial.
+  if (!allRealtime)
+  {
+    DBG("ChannelWorkerPool: can't get realtime scheduling, processing channels serially");
+    stopWorkers();
+  }
+}
+
+void ChannelWorkerPool::stopWorkers(){
+  for (int i=0; i<workers.size(); i++)
+    workers[i]->signalThreadShouldExit();
+  for (int i=0; i<workers.size(); i++)
+    wakeUp.post();
+  for (int i=0; i<workers.size(); i++)
+    workers[i]->stopThread(1000);
+  workers.clear();
+}
+
+void ChannelWorkerPool::run(Job& job, int numJobs){
+  if (workers.size()==0 || numJobs<2)
+  {
+    for (int i=0; i<numJobs; i++)
+      job.processJob(i);
+    return;
+  }
+
+  // Publish the batch. The claim counter is still at NO_JOBS here,
+  // so no worker can pick up a job before it's fully set up.
+  currentJob = &job;
+  batchSize = numJobs;
+  completedJobs.set(0);
+  nextJob.set(0);
+
+  const int numToWake = jmin(workers.size(), numJobs - 1);
+  for (int i=0; i<numToWake; i++)
+    wakeUp.post();
+
+  // The audio thread works along, so a batch completes even if
+  // no worker has woken up yet.
+  processJobs();
+
+  while (completedJobs.get() < numJobs)
+  { // Spin: remaining jobs are already running on a (realtime) worker.
+  }
+  nextJob.set(NO_JOBS);
+}
+
+void ChannelWorkerPool::processJobs(){
+  for (;;)
+  {
+    int index = (++nextJob) - 1;
+    if (index >= batchSize)
+      return;
+    currentJob->processJob(index);
+    ++completedJobs;
+  }
+}
+
+/**
+ * Workers.
+ */
+
+ChannelWorkerPool::Worker::Worker(ChannelWorkerPool& pool) :
+  Thread("BiasedDelay worker"), isRealtime(false), pool(pool) {
+}
+
+void ChannelWorkerPool::Worker::run(){
+  isRealtime = Thread::setCurrentThreadRealtimePriority(WORKER_REALTIME_PRIORITY);
+  started.signal();
+  if (!isRealtime)
+    return;
+
+  // A wake-up left over from a batch that others finished just finds
+  // nothing to claim.
+  for (;;)
+  {
+    pool.wakeUp.wait();
+    if (threadShouldExit())
+      return;
+    RealtimeCheck::ScopedRealtimeThread realtimeThread;
+    pool.processJobs();
+  }
+}
+
+/**
+ * Semaphore.
+ */
+
+#if JUCE_MAC
+ChannelWorkerPool::Semaphore::Semaphore(){
+  semaphore_create(mach_task_self(), &semaphore, SYNC_POLICY_FIFO, 0);
+}
+
+ChannelWorkerPool::Semaphore::~Semaphore(){
+  semaphore_destroy(mach_task_self(), semaphore);
+}
+
+void ChannelWorkerPool::Semaphore::post(){
+  semaphore_signal(semaphore);
+}
+
+void ChannelWorkerPool::Semaphore::wait(){
+  while (semaphore_wait(semaphore) == KERN_ABORTED) {}
+}
+#else
+ChannelWorkerPool::Semaphore::Semaphore(){
+  sem_init(&semaphore, 0, 0);
+}
+
+ChannelWorkerPool::Semaphore::~Semaphore(){
+  sem_destroy(&semaphore);
+}
+
+void ChannelWorkerPool::Semaphore::post(){
+  sem_post(&semaphore);
+}
+
+void ChannelWorkerPool::Semaphore::wait(){
+  while (sem_wait(&semaphore) != 0 && errno == EINTR) {}
+}
+#endif
@@ -0,0 +1,108 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+ */
+
+/**
+ * ChannelWorkerPool.h
+ * BiasedDelay
+ *
+ * A small pool of pre-spawned threads that share independent jobs
+ * (one per channel) with the audio thread.
+ */
+
+#ifndef BiasedDelay_ChannelWorkerPool_h
+#define BiasedDelay_ChannelWorkerPool_h
+
+#include "JuceHeader.h"
+
+#if JUCE_MAC
+ #include <mach/mach.h>
+#else
+ #include <semaphore.h>
+#endif
+
+class ChannelWorkerPool {
+public:
+  // A batch of independent jobs, identified by index.
+  class Job {
+  public:
+    virtual ~Job() {}
+    virtual void processJob(int index) = 0;
+  };
+
+  ChannelWorkerPool();
+  ~ChannelWorkerPool();
+
+  // Starts/stops worker threads. Not realtime-safe: call from
+  // prepareToPlay or the message thread, never while run() is active.
+  // The audio thread waits for the workers, so they must run under
+  // realtime scheduling; if the system refuses that, no workers are
+  // kept and run() processes every job itself.
+  void setNumWorkers(int numWorkers);
+  int getNumWorkers(){return workers.size();};
+
+  // Runs job.processJob(0..numJobs-1) on the calling thread and any idle
+  // workers, and returns once all jobs are done.
+  // Realtime-safe: does not allocate or lock; waking the workers is a
+  // semaphore post.
+  void run(Job& job, int numJobs);
+
+private:
+  // Counting semaphore that can be posted without taking a lock
+  class Semaphore {
+  public:
+    Semaphore();
+    ~Semaphore();
+    void post();
+    void wait();
+  private:
+   #if JUCE_MAC
+    semaphore_t semaphore;
+   #else
+    sem_t semaphore;
+   #endif
+    JUCE_DECLARE_NON_COPYABLE (Semaphore)
+  };
+
+  class Worker : public Thread {
+  public:
+    Worker(ChannelWorkerPool& pool);
+    void run();
+
+    // Set once the worker has tried to go realtime
+    WaitableEvent started;
+    bool isRealtime;
+  private:
+    ChannelWorkerPool& pool;
+  };
+
+  void stopWorkers();
+  void processJobs();
+
+private:
+  OwnedArray<Worker> workers;
+  Semaphore wakeUp;
+
+  Job* currentJob;
+  int batchSize;
+
+  Atomic<int> nextJob;
+  Atomic<int> completedJobs;
+
+  JUCE_DECLARE_NON_COPYABLE (ChannelWorkerPool)
+};
+
+#endif
@@ -11,10 +11,19 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+// State section for the current program: { int32 index }
+const uint32 STATE_SECTION_PROGRAM = 0x474f5250; // "PROG"
+
 
 //==============================================================================
 BiasedDelayAudioProcessor::BiasedDelayAudioProcessor()
+  : currentProgram (0), programMorphTime (0)
 {
+  // Only kicks in for wide (immersive/ambisonic) buses.
+  biasedDelay.setMaxChannels(JucePlugin_MaxNumInputChannels);
+  biasedDelay.setParallelProcessing(true);
+
+  presets.loadUserPrograms(PresetBank::getDefaultUserDirectory());
 }
 
 BiasedDelayAudioProcessor::~BiasedDelayAudioProcessor()
@@ -34,12 +43,13 @@ int BiasedDelayAudioProcessor::getNumParameters()
 
 float BiasedDelayAudioProcessor::getParameter (int index)
 {
-  return biasedDelay.getParameterValue(index);
+  // Includes a program change that hasn't reached the audio thread yet
+  return biasedDelay.getTargetParameterValue(index);
 }
 
 void BiasedDelayAudioProcessor::setParameter (int index, float newValue)
 {
-  biasedDelay.setParameterValue(index, newValue);
+  biasedDelay.setAutomatedParameterValue(index, newValue);
 }
 
 const String BiasedDelayAudioProcessor::getParameterName (int index)
@@ -102,25 +112,34 @@ double BiasedDelayAudioProcessor::getTailLengthSeconds() const
 
 int BiasedDelayAudioProcessor::getNumPrograms()
 {
-  return 0;
+  return presets.getNumPrograms();
 }
 
 int BiasedDelayAudioProcessor::getCurrentProgram()
 {
-  return 0;
+  return currentProgram;
 }
 
 void BiasedDelayAudioProcessor::setCurrentProgram (int index)
 {
+  const Program* program = presets.getProgram(index);
+  if (program != nullptr)
+  {
+    currentProgram = index;
+    biasedDelay.setParameterSet(program->parameters, programMorphTime);
+    updateHostDisplay(); // Hosts re-read the parameters, and see the new program
+  }
 }
 
 const String BiasedDelayAudioProcessor::getProgramName (int index)
 {
-  return String::empty;
+  const Program* program = presets.getProgram(index);
+  return program != nullptr ? program->name : String::empty;
 }
 
 void BiasedDelayAudioProcessor::changeProgramName (int index, const String& newName)
 {
+  presets.setProgramName(index, newName);
 }
 
 //==============================================================================
@@ -128,7 +147,9 @@ void BiasedDelayAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
 {
   // Use this method as the place to do any pre-playback
   // initialisation that you need..
-  biasedDelay.prepareToPlay(sampleRate, samplesPerBlock);
+  biasedDelay.prepareToPlay(sampleRate, samplesPerBlock, getNumInputChannels());
+  blockTimes.setBudget(samplesPerBlock / sampleRate);
+  blockTimes.reset();
 }
 
 void BiasedDelayAudioProcessor::releaseResources()
@@ -139,6 +160,9 @@ void BiasedDelayAudioProcessor::releaseResources()
 
 void BiasedDelayAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
 {
+  RealtimeCheck::ScopedRealtimeThread realtimeThread;
+  const int64 startTicks = Time::getHighResolutionTicks();
+
   // This is the place where you'd normally do the guts of your plugin's
   // audio processing...
   biasedDelay.processBlock(buffer, getNumInputChannels(), getNumOutputChannels(), midiMessages);
@@ -150,6 +174,8 @@ void BiasedDelayAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuf
   {
     buffer.clear (i, 0, buffer.getNumSamples());
   }
+
+  blockTimes.addBlock(startTicks, Time::getHighResolutionTicks());
 }
 
 void BiasedDelayAudioProcessor::reset()
@@ -177,13 +203,30 @@ void BiasedDelayAudioProcessor::getStateInformation (MemoryBlock& destData)
   // You should use this method to store your parameters in the memory block.
   // You could do that either as raw data, or use the XML or ValueTree classes
   // as intermediaries to make it easy to save and load complex data.
-  copyXmlToBinary(biasedDelay.getStateInformation(), destData);
+  biasedDelay.getStateInformation(destData);
+
+  const int32 program = (int32)ByteOrder::swapIfBigEndian((uint32)currentProgram);
+  BiasedDelay::appendStateSection(destData, STATE_SECTION_PROGRAM, &program, sizeof(program));
 }
 
 void BiasedDelayAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
   // You should use this method to restore your parameters from this memory block,
   // whose contents will have been created by the getStateInformation() call.
+  if (biasedDelay.setStateInformation(data, sizeInBytes))
+  {
+    // The parameters are restored already; this just selects the program.
+    MemoryBlock program;
+    if (BiasedDelay::findStateSection(data, sizeInBytes, STATE_SECTION_PROGRAM, program) && program.getSize() == sizeof(int32))
+    {
+      const int index = (int)(int32)ByteOrder::swapIfBigEndian(*static_cast<const uint32*>(program.getData()));
+      if (presets.getProgram(index) != nullptr)
+        currentProgram = index;
+    }
+    return;
+  }
+
+  // Sessions saved by earlier versions hold XML state
   ScopedPointer<XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
   if (xmlState != nullptr)
   {
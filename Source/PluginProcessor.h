@@ -14,6 +14,8 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "BiasedDelay.h"
+#include "BlockTimeHistogram.h"
+#include "PresetBank.h"
 
 
 //==============================================================================
@@ -65,12 +67,28 @@ public:
     const String getProgramName (int index);
     void changeProgramName (int index, const String& newName);
 
+    // Program changes morph over this time (0: switch at the next block)
+    void setProgramMorphTime (double seconds) { programMorphTime = seconds; }
+    double getProgramMorphTime() const { return programMorphTime; }
+    PresetBank& getPresetBank() { return presets; }
+
+    // Save the delay tail with the session (off by default)
+    void setStoreDelayBuffer (bool enabled) { biasedDelay.setStoreDelayBuffer (enabled); }
+
     //==============================================================================
     void getStateInformation (MemoryBlock& destData);
     void setStateInformation (const void* data, int sizeInBytes);
 
+    //==============================================================================
+    // Per-block processing times since the last prepareToPlay
+    BlockTimeHistogram& getBlockTimes() { return blockTimes; }
+
 private:
     BiasedDelay biasedDelay;
+    BlockTimeHistogram blockTimes;
+    PresetBank presets;
+    int currentProgram;
+    double programMorphTime;
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BiasedDelayAudioProcessor)
 };
@@ -0,0 +1,118 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+*/
+
+/**
+ * PresetBank.cpp
+ * BiasedDelay
+ */
+
+#include "PresetBank.h"
+
+PresetBank::PresetBank(){
+  // Time, feedback, bias, dry/wet. The first one matches BiasedDelay's defaults.
+  addFactoryProgram("Default", 0.2f, 0.1f, 0.5f, 0.5f);
+  addFactoryProgram("Slapback", 0.02f, 0.05f, 0.5f, 0.35f);
+  addFactoryProgram("Dub Echo", 0.09f, 0.7f, 0.5f, 0.5f);
+  addFactoryProgram("Soft Bloom", 0.15f, 0.6f, 0.2f, 0.5f);
+  addFactoryProgram("Crushed Tape", 0.06f, 0.5f, 0.85f, 0.6f);
+  addFactoryProgram("Saturator", 0.0f, 0.3f, 0.95f, 0.7f);
+}
+
+void PresetBank::addFactoryProgram(const String& name, float time, float feedback, float bias, float dryWet){
+  Program* program = new Program();
+  program->name = name;
+  program->isFactory = true;
+  program->parameters.values[PARAMETER_TIME] = time;
+  program->parameters.values[PARAMETER_FEEDBACK] = feedback;
+  program->parameters.values[PARAMETER_BIAS] = bias;
+  program->parameters.values[PARAMETER_DRYWET] = dryWet;
+  programs.add(program);
+}
+
+void PresetBank::setProgramName(int index, const String& name){
+  Program* program = programs[index];
+  if (program != nullptr && !program->isFactory)
+    program->name = name;
+}
+
+int PresetBank::addUserProgram(const String& name, const ParameterSet& parameters){
+  Program* program = new Program();
+  program->name = name;
+  program->isFactory = false;
+  program->parameters = parameters;
+  programs.add(program);
+  return programs.size() - 1;
+}
+
+/**
+ * Preset files.
+ */
+
+int PresetBank::loadUserPrograms(const File& dir){
+  Array<File> files;
+  dir.findChildFiles(files, File::findFiles, false, "*.xml");
+
+  StringArray paths;
+  for (int i=0; i<files.size(); i++)
+    paths.add(files[i].getFullPathName());
+  paths.sort(true);
+
+  int numAdded = 0;
+  for (int i=0; i<paths.size(); i++)
+  {
+    File file(paths[i]);
+    ScopedPointer<XmlElement> state(XmlDocument::parse(file));
+    ParameterSet parameters = programs[0]->parameters; // Defaults for missing values
+    if (state != nullptr && parsePreset(*state, parameters))
+    {
+      addUserProgram(file.getFileNameWithoutExtension(), parameters);
+      numAdded++;
+    }
+  }
+  return numAdded;
+}
+
+bool PresetBank::saveUserProgram(const File& dir, const String& name, const ParameterSet& parameters){
+  XmlElement state("BiasedDelayState");
+  for (int i=0; i<NUM_PARAMETERS; i++)
+    state.setAttribute(String::formatted("parameter%d", i), parameters.values[i]);
+
+  File file(dir.getChildFile(File::createLegalFileName(name) + ".xml"));
+  if (!dir.createDirectory() || !state.writeToFile(file, String::empty))
+    return false;
+  addUserProgram(name, parameters);
+  return true;
+}
+
+File PresetBank::getDefaultUserDirectory(){
+  return File::getSpecialLocation(File::userApplicationDataDirectory)
+    .getChildFile("BiasedDelay").getChildFile("Presets");
+}
+
+bool PresetBank::parsePreset(const XmlElement& state, ParameterSet& parameters){
+  if (!state.hasTagName("BiasedDelayState"))
+    return false;
+  for (int i=0; i<NUM_PARAMETERS; i++)
+  {
+    const float value = (float)state.getDoubleAttribute(String::formatted("parameter%d", i), parameters.values[i]);
+    // As for restored state: a hand-edited preset mustn't get a delay
+    // time beyond the delay buffer onto the audio thread.
+    if (juce_isfinite(value))
+      parameters.values[i] = jlimit(0.0f, 1.0f, value);
+  }
+  return true;
+}
@@ -0,0 +1,69 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+ */
+
+/**
+ * PresetBank.h
+ * BiasedDelay
+ *
+ * Factory programs, followed by user programs loaded from
+ * BiasedDelayState preset files.
+ */
+
+#ifndef BiasedDelay_PresetBank_h
+#define BiasedDelay_PresetBank_h
+
+#include "JuceHeader.h"
+#include "BiasedDelay.h"
+
+struct Program {
+  String name;
+  ParameterSet parameters;
+  bool isFactory;
+};
+
+class PresetBank {
+public:
+  PresetBank();
+
+  // Programs are never removed or modified (except for their names).
+  int getNumPrograms(){return programs.size();};
+  const Program* getProgram(int index){return programs[index];};
+  void setProgramName(int index, const String& name); // user programs only
+
+  // Returns the new program's index
+  int addUserProgram(const String& name, const ParameterSet& parameters);
+
+  // Adds every *.xml preset in dir; returns the number added
+  int loadUserPrograms(const File& dir);
+
+  // Writes a preset file to dir, and adds it as a user program
+  bool saveUserProgram(const File& dir, const String& name, const ParameterSet& parameters);
+
+  // Where the plugin keeps its user presets
+  static File getDefaultUserDirectory();
+
+  // BiasedDelayState XML, as written by BiasedDelay::getStateInformation
+  static bool parsePreset(const XmlElement& state, ParameterSet& parameters);
+
+private:
+  void addFactoryProgram(const String& name, float time, float feedback, float bias, float dryWet);
+
+private:
+  OwnedArray<Program> programs;
+};
+
+#endif
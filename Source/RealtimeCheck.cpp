@@ -0,0 +1,205 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+*/
+
+/**
+ * RealtimeCheck.cpp
+ * BiasedDelay
+ */
+
+#include "RealtimeCheck.h"
+
+#if BIASEDDELAY_REALTIME_CHECKS
+
+#include <cstdio>
+#include <cerrno>
+
+// Plain thread-locals: ThreadLocalValue allocates, which we can't do
+// from inside malloc.
+#if JUCE_MSVC
+ #define REALTIME_THREAD_LOCAL __declspec(thread)
+#else
+ #define REALTIME_THREAD_LOCAL __thread
+#endif
+
+static REALTIME_THREAD_LOCAL int realtimeDepth = 0;
+static REALTIME_THREAD_LOCAL int reporting = 0; // Reporting allocates, too
+static Atomic<int> numViolations;
+
+void RealtimeCheck::enter(){
+  realtimeDepth++;
+}
+
+void RealtimeCheck::exit(){
+  realtimeDepth--;
+}
+
+bool RealtimeCheck::isRealtimeThread(){
+  return realtimeDepth > 0;
+}
+
+void RealtimeCheck::reportViolation(const char* function){
+  if (realtimeDepth == 0 || reporting != 0)
+    return;
+  reporting = 1;
+  if (++numViolations <= MAX_REALTIME_REPORTS)
+  {
+    String backtrace(SystemStats::getStackBacktrace());
+    fprintf(stderr, "Realtime violation: %s called on the audio thread\n%s\n",
+            function, backtrace.toRawUTF8());
+  }
+  reporting = 0;
+}
+
+int RealtimeCheck::getNumViolations(){
+  return numViolations.get();
+}
+
+/**
+ * Interposers.
+ */
+
+#if JUCE_LINUX
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+// glibc exports its allocator under these names, so malloc can forward
+// without dlsym (which allocates itself).
+extern "C" {
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t count, size_t size);
+  void* __libc_realloc(void* ptr, size_t size);
+  void* __libc_memalign(size_t alignment, size_t size);
+  void __libc_free(void* ptr);
+}
+
+// Looked up on first use. No function-local statics: their guards lock.
+#define REALTIME_FORWARD(name, type) \
+  static type real_##name = nullptr; \
+  static type get_##name(){ \
+    if (real_##name == nullptr) \
+      real_##name = (type)dlsym(RTLD_NEXT, #name); \
+    return real_##name; \
+  }
+
+typedef int (*MutexLockFunction)(pthread_mutex_t*);
+typedef int (*CondWaitFunction)(pthread_cond_t*, pthread_mutex_t*);
+typedef int (*CondTimedWaitFunction)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*);
+typedef int (*SemWaitFunction)(sem_t*);
+typedef int (*YieldFunction)();
+typedef int (*NanosleepFunction)(const struct timespec*, struct timespec*);
+typedef int (*UsleepFunction)(useconds_t);
+
+REALTIME_FORWARD(pthread_mutex_lock, MutexLockFunction)
+REALTIME_FORWARD(pthread_cond_wait, CondWaitFunction)
+REALTIME_FORWARD(pthread_cond_timedwait, CondTimedWaitFunction)
+REALTIME_FORWARD(sem_wait, SemWaitFunction)
+REALTIME_FORWARD(sched_yield, YieldFunction)
+REALTIME_FORWARD(nanosleep, NanosleepFunction)
+REALTIME_FORWARD(usleep, UsleepFunction)
+
+extern "C" {
+
+void* malloc(size_t size){
+  RealtimeCheck::reportViolation("malloc");
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size){
+  RealtimeCheck::reportViolation("calloc");
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size){
+  RealtimeCheck::reportViolation("realloc");
+  return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size){
+  RealtimeCheck::reportViolation("memalign");
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size){
+  RealtimeCheck::reportViolation("posix_memalign");
+  *ptr = __libc_memalign(alignment, size);
+  return *ptr != nullptr ? 0 : ENOMEM;
+}
+
+void free(void* ptr){
+  if (ptr != nullptr)
+    RealtimeCheck::reportViolation("free");
+  __libc_free(ptr);
+}
+
+// CriticalSection, and WaitableEvent's signal/wait
+int pthread_mutex_lock(pthread_mutex_t* mutex){
+  RealtimeCheck::reportViolation("pthread_mutex_lock");
+  return get_pthread_mutex_lock()(mutex);
+}
+
+int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex){
+  RealtimeCheck::reportViolation("pthread_cond_wait");
+  return get_pthread_cond_wait()(cond, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* time){
+  RealtimeCheck::reportViolation("pthread_cond_timedwait");
+  return get_pthread_cond_timedwait()(cond, mutex, time);
+}
+
+int sem_wait(sem_t* semaphore){
+  RealtimeCheck::reportViolation("sem_wait");
+  return get_sem_wait()(semaphore);
+}
+
+// Thread::yield, and a contended SpinLock
+int sched_yield(){
+  RealtimeCheck::reportViolation("sched_yield");
+  return get_sched_yield()();
+}
+
+// Thread::sleep
+int nanosleep(const struct timespec* time, struct timespec* remaining){
+  RealtimeCheck::reportViolation("nanosleep");
+  return get_nanosleep()(time, remaining);
+}
+
+int usleep(useconds_t microseconds){
+  RealtimeCheck::reportViolation("usleep");
+  return get_usleep()(microseconds);
+}
+
+}
+
+#endif // JUCE_LINUX
+
+#else
+
+bool RealtimeCheck::isRealtimeThread(){
+  return false;
+}
+
+void RealtimeCheck::reportViolation(const char*){
+}
+
+int RealtimeCheck::getNumViolations(){
+  return 0;
+}
+
+#endif
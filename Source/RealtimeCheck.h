@@ -0,0 +1,67 @@
+/*
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ 02110-1301, USA.
+ */
+
+/**
+ * RealtimeCheck.h
+ * BiasedDelay
+ *
+ * Catches allocations and blocking calls on the audio thread. Build
+ * with BIASEDDELAY_REALTIME_CHECKS=1 to enable: the audio thread is
+ * marked while inside processBlock, and on Linux, malloc/free and the
+ * pthread primitives behind CriticalSection, WaitableEvent and
+ * Thread::sleep/yield are interposed and report any call made from a
+ * marked thread, with a stack trace. Disabled, it compiles to nothing.
+ */
+
+#ifndef BiasedDelay_RealtimeCheck_h
+#define BiasedDelay_RealtimeCheck_h
+
+#include "JuceHeader.h"
+
+#ifndef BIASEDDELAY_REALTIME_CHECKS
+ #define BIASEDDELAY_REALTIME_CHECKS 0
+#endif
+
+// Only the first few violations print a stack trace; all are counted.
+const int MAX_REALTIME_REPORTS = 10;
+
+class RealtimeCheck {
+public:
+  // Marks the calling thread as realtime while in scope. Nests.
+  class ScopedRealtimeThread {
+  public:
+   #if BIASEDDELAY_REALTIME_CHECKS
+    ScopedRealtimeThread(){enter();};
+    ~ScopedRealtimeThread(){exit();};
+   #else
+    ScopedRealtimeThread(){};
+   #endif
+  };
+
+  static bool isEnabled(){return BIASEDDELAY_REALTIME_CHECKS != 0;};
+  static bool isRealtimeThread();
+
+  // Called by the interposed functions; ignored on unmarked threads.
+  static void reportViolation(const char* function);
+  static int getNumViolations();
+
+private:
+  static void enter();
+  static void exit();
+};
+
+#endif